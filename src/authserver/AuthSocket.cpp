@@ -11,6 +11,7 @@
 #include "AuthSocket.h"
 #include "AuthCodes.h"
 #include "PatchHandler.h"
+#include "AuthThreadPool.h"
 
 #include <openssl/md5.h>
 //#include "Util.h" -- for commented utf8ToUpperOnlyLatin
@@ -165,6 +166,9 @@ AuthSocket::AuthSocket()
 
     _build = 0;
     patch_ = ACE_INVALID_HANDLE;
+
+    _accountId = 0;
+    _realmCharactersExpire = 0;
 }
 
 // Close patch file descriptor before leaving
@@ -339,7 +343,7 @@ bool AuthSocket::_HandleLogonChallenge()
     // Escape the user login to avoid further SQL injection
     // Memory will be freed on AuthSocket object destruction
     _safelogin = _login;
-    LoginDatabase.escape_string(_safelogin);
+    AuthThreadPool::GetReadDatabase().escape_string(_safelogin);
 
     pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
     pkt << (uint8) 0x00;
@@ -351,8 +355,8 @@ bool AuthSocket::_HandleLogonChallenge()
     // Verify that this IP is not in the ip_banned table
     // No SQL injection possible (paste the IP address as passed by the socket)
     std::string address = get_remote_address();
-    LoginDatabase.escape_string(address);
-    QueryResult_AutoPtr result = LoginDatabase.PQuery("SELECT unbandate FROM ip_banned WHERE "
+    AuthThreadPool::GetReadDatabase().escape_string(address);
+    QueryResult_AutoPtr result = AuthThreadPool::GetReadDatabase().PQuery("SELECT unbandate FROM ip_banned WHERE "
     //    permanent                    still banned
         "(unbandate = bandate OR unbandate > UNIX_TIMESTAMP()) AND ip = '%s'", address.c_str());
     if (result)
@@ -366,7 +370,7 @@ bool AuthSocket::_HandleLogonChallenge()
         // No SQL injection (escaped user name)
 
         result = 
-            LoginDatabase.PQuery("SELECT a.sha_pass_hash,a.id,a.locked,a.last_ip,aa.gmlevel,a.v,a.s "
+            AuthThreadPool::GetReadDatabase().PQuery("SELECT a.sha_pass_hash,a.id,a.locked,a.last_ip,aa.gmlevel,a.v,a.s "
                                  "FROM account a "
                                  "LEFT JOIN account_access aa "
                                  "ON (a.id = aa.id) "
@@ -398,7 +402,7 @@ bool AuthSocket::_HandleLogonChallenge()
             if (!locked)
             {
                 // If the account is banned, reject the logon attempt
-                QueryResult_AutoPtr banresult = LoginDatabase.PQuery("SELECT bandate,unbandate FROM account_banned WHERE "
+                QueryResult_AutoPtr banresult = AuthThreadPool::GetReadDatabase().PQuery("SELECT bandate,unbandate FROM account_banned WHERE "
                     "id = %u AND active = 1 AND (unbandate > UNIX_TIMESTAMP() OR unbandate = bandate)", (*result)[1].GetUInt32());
                 if (banresult)
                 {
@@ -552,7 +556,8 @@ bool AuthSocket::_HandleLogonProof()
         if (!PatchCache::instance()->GetHash(tmp, (uint8*)&xferh.md5))
         {
             // calculate patch md5, happens if patch was added while auth was running
-            PatchCache::instance()->LoadPatchMD5(tmp);
+            // takes the name inside the patches directory
+            PatchCache::instance()->LoadPatchMD5(tmp + sizeof("./patches/") - 1);
             PatchCache::instance()->GetHash(tmp, (uint8*)&xferh.md5);
         }
 
@@ -683,7 +688,7 @@ bool AuthSocket::_HandleLogonProof()
             // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
             LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'",_safelogin.c_str());
 
-            if (QueryResult_AutoPtr loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
+            if (QueryResult_AutoPtr loginfail = AuthThreadPool::GetReadDatabase().PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
             {
                 Field* fields = loginfail->Fetch();
                 uint32 failed_logins = fields[1].GetUInt32();
@@ -704,7 +709,7 @@ bool AuthSocket::_HandleLogonProof()
                     else
                     {
                         std::string current_ip = get_remote_address();
-                        LoginDatabase.escape_string(current_ip);
+                        AuthThreadPool::GetReadDatabase().escape_string(current_ip);
                         LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','blizzlike realm','Failed login autoban')",
                             current_ip.c_str(), WrongPassBanTime);
                         sLog.outBasic("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
@@ -750,12 +755,12 @@ bool AuthSocket::_HandleReconnectChallenge()
     _login = (const char*)ch->I;
 
     _safelogin = _login;
-    LoginDatabase.escape_string(_safelogin);
+    AuthThreadPool::GetReadDatabase().escape_string(_safelogin);
 
     EndianConvert(ch->build);
     _build = ch->build;
 	
-    QueryResult_AutoPtr result = LoginDatabase.PQuery ("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str ());
+    QueryResult_AutoPtr result = AuthThreadPool::GetReadDatabase().PQuery("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str ());
 
     // Stop if the account is not found
     if (!result)
@@ -831,39 +836,82 @@ bool AuthSocket::_HandleRealmList()
 
     recv_skip(5);
 
-    // Get the user id (else close the connection)
+    // Get the user id once per connection (else close the connection)
     // No SQL injection (escaped user name)
-
-    QueryResult_AutoPtr result = LoginDatabase.PQuery("SELECT id,sha_pass_hash FROM account WHERE username = '%s'",_safelogin.c_str());
-    if (!result)
+    if (!_accountId)
     {
-        sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.",_login.c_str());
-        close_connection();
-        return false;
+        QueryResult_AutoPtr result = AuthThreadPool::GetReadDatabase().PQuery("SELECT id FROM account WHERE username = '%s'",_safelogin.c_str());
+        if (!result)
+        {
+            sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.",_login.c_str());
+            close_connection();
+            return false;
+        }
+
+        _accountId = (*result)[0].GetUInt32();
     }
 
-    uint32 id = (*result)[0].GetUInt32();
-    std::string rI = (*result)[1].GetCppString();
+    // The client polls the realm list while it is shown, the character counts of all realms
+    // are loaded in one query and kept until the realm list itself may have changed.
+    // Counts only change while the client is in a world, it comes back through a new connection.
+    time_t now = time(NULL);
+    if (now >= _realmCharactersExpire)
+    {
+        _realmCharacters.clear();
+
+        QueryResult_AutoPtr result = AuthThreadPool::GetReadDatabase().PQuery("SELECT realmid, numchars FROM realmcharacters WHERE acctid = '%u'", _accountId);
+        if (result)
+        {
+            do
+            {
+                Field *fields = result->Fetch();
+                _realmCharacters[fields[0].GetUInt32()] = fields[1].GetUInt8();
+            } while (result->NextRow());
+        }
+
+        _realmCharactersExpire = now + sRealmList->GetUpdateInterval();
+    }
 
     // Update realm list if need
     sRealmList->UpdateIfNeed();
 
-    // Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
-    ByteBuffer pkt;
-    LoadRealmlist(pkt, id);
-
     ByteBuffer hdr;
     hdr << (uint8) CMD_REALM_LIST;
-    hdr << (uint16)pkt.size();
-    hdr.append(pkt);
+
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, sRealmList->GetLock(), false);
+
+        // Circle through realms in the RealmList and construct the packet once per build and security level
+        RealmListPacket const* realmList = sRealmList->FindPacket(_build, uint8(_accountSecurityLevel));
+        if (!realmList)
+        {
+            RealmListPacket& added = sRealmList->AddPacket(_build, uint8(_accountSecurityLevel));
+            LoadRealmlist(added);
+            realmList = &added;
+        }
+
+        hdr << (uint16)realmList->data.size();
+        size_t bodyPos = hdr.wpos();
+        hdr.append(realmList->data);
+
+        // fill in the # of user characters in each realm
+        for (size_t i = 0; i < realmList->charCountPos.size(); ++i)
+        {
+            RealmCharacterMap::const_iterator itr = _realmCharacters.find(realmList->charCountPos[i].first);
+            if (itr != _realmCharacters.end())
+                hdr.put<uint8>(bodyPos + realmList->charCountPos[i].second, itr->second);
+        }
+    }
 
     send((char const*)hdr.contents(), hdr.size());
 
     return true;
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer &pkt, uint32 acctid)
+void AuthSocket::LoadRealmlist(RealmListPacket& realmList)
 {
+    ByteBuffer& pkt = realmList.data;
+
     switch(_build)
     {
         case 5875:                                          // 1.12.1
@@ -874,18 +922,6 @@ void AuthSocket::LoadRealmlist(ByteBuffer &pkt, uint32 acctid)
 
             for (RealmList::RealmMap::const_iterator  i = sRealmList->begin(); i != sRealmList->end(); ++i)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult_AutoPtr result = LoginDatabase.PQuery( "SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i->second.m_ID, acctid);
-                if ( result )
-                {
-                    Field *fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                }
-                else
-                    AmountOfCharacters = 0;
-
                 bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), _build) != i->second.realmbuilds.end();
 
                 RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : NULL;
@@ -912,7 +948,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer &pkt, uint32 acctid)
                 pkt << name;                                // name
                 pkt << i->second.address;                   // address
                 pkt << float(i->second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
+                realmList.charCountPos.push_back(std::make_pair(i->second.m_ID, pkt.wpos()));
+                pkt << uint8(0);                            // characters, set per account
                 pkt << uint8(i->second.timezone);           // realm category
                 pkt << uint8(0x00);                         // unk, may be realm number/id?
             }
@@ -935,18 +972,6 @@ void AuthSocket::LoadRealmlist(ByteBuffer &pkt, uint32 acctid)
 
             for (RealmList::RealmMap::const_iterator  i = sRealmList->begin(); i != sRealmList->end(); ++i)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult_AutoPtr result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i->second.m_ID, acctid);
-                if ( result )
-                {
-                    Field *fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                }
-                else
-                    AmountOfCharacters = 0;
-
                 bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), _build) != i->second.realmbuilds.end();
 
                 RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : NULL;
@@ -970,7 +995,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer &pkt, uint32 acctid)
                 pkt << i->first;                            // name
                 pkt << i->second.address;                   // address
                 pkt << float(i->second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
+                realmList.charCountPos.push_back(std::make_pair(i->second.m_ID, pkt.wpos()));
+                pkt << uint8(0);                            // characters, set per account
                 pkt << uint8(i->second.timezone);           // realm category (Cfg_Categories.dbc)
                 pkt << uint8(0x2C);                         // unk, may be realm number/id?
 
@@ -1052,7 +1078,7 @@ bool AuthSocket::_HandleXferAccept()
 
 void AuthSocket::InitPatch()
 {
-    PatchHandler* handler = new PatchHandler(ACE_OS::dup(get_handle()), patch_);
+    PatchHandler* handler = new PatchHandler(ACE_OS::dup(get_handle()), patch_, reactor());
 
     patch_ = ACE_INVALID_HANDLE;
 
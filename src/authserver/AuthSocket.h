@@ -13,6 +13,8 @@
 
 #include "BufferedSocket.h"
 
+struct RealmListPacket;
+
 // Handle login commands
 class AuthSocket: public BufferedSocket
 {
@@ -25,7 +27,7 @@ class AuthSocket: public BufferedSocket
         void OnAccept();
         void OnRead();
         void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer &pkt, uint32 acctid);
+        void LoadRealmlist(RealmListPacket& realmList);
 
         bool _HandleLogonChallenge();
         bool _HandleLogonProof();
@@ -60,6 +62,12 @@ class AuthSocket: public BufferedSocket
 
         ACE_HANDLE patch_;
 
+        // realm id -> characters of this account, filled at the first realm list request
+        typedef std::map<uint32, uint8> RealmCharacterMap;
+        uint32 _accountId;
+        RealmCharacterMap _realmCharacters;
+        time_t _realmCharactersExpire;
+
         void InitPatch();
 };
 #endif
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#include "AuthThreadPool.h"
+#include "Log.h"
+
+#include <ace/Reactor.h>
+#include <ace/TSS_T.h>
+
+extern DatabaseType LoginDatabase;
+
+namespace
+{
+    struct AuthThreadDatabaseSlot
+    {
+        AuthThreadDatabaseSlot() : db(NULL) {}
+        DatabaseType* db;
+    };
+
+    ACE_TSS<AuthThreadDatabaseSlot> s_threadDatabase;
+}
+
+AuthThreadPool::AuthThreadPool() : m_reactor(NULL), m_pingLoops(0)
+{
+}
+
+AuthThreadPool::~AuthThreadPool()
+{
+    Wait();
+}
+
+bool AuthThreadPool::Start(ACE_Reactor* reactor, uint32 threads, std::string const& dbstring, uint32 pingLoops)
+{
+    if (!threads)
+        return true;
+
+    m_reactor = reactor;
+    m_dbstring = dbstring;
+    m_pingLoops = pingLoops;
+
+    if (activate(THR_NEW_LWP | THR_JOINABLE, threads) == -1)
+    {
+        sLog.outError("AuthServer can not start %u network threads, logins are handled by the main thread", threads);
+        return false;
+    }
+
+    sLog.outString("AuthServer uses %u extra network threads", threads);
+    return true;
+}
+
+void AuthThreadPool::Wait()
+{
+    ACE_Task_Base::wait();
+}
+
+DatabaseType& AuthThreadPool::GetReadDatabase()
+{
+    DatabaseType* db = s_threadDatabase->db;
+    return db ? *db : LoginDatabase;
+}
+
+int AuthThreadPool::svc()
+{
+    DEBUG_LOG("Auth network thread starting");
+
+    // a thread without its own connection shares LoginDatabase, slower but still correct
+    DatabaseType* db = new DatabaseType;
+    if (db->Initialize(m_dbstring.c_str()))
+    {
+        db->ThreadStart();
+        s_threadDatabase->db = db;
+    }
+    else
+    {
+        sLog.outError("Auth network thread can't connect to database at %s, using the shared connection", m_dbstring.c_str());
+        delete db;
+        db = NULL;
+        LoginDatabase.ThreadStart();
+    }
+
+    uint32 loopCounter = 0;
+    while (!m_reactor->reactor_event_loop_done())
+    {
+        // dont move this outside the loop, the reactor will modify it
+        ACE_Time_Value interval(0, 100000);
+
+        if (m_reactor->run_reactor_event_loop(interval) == -1)
+            break;
+
+        if (db && (++loopCounter) == m_pingLoops)
+        {
+            loopCounter = 0;
+            db->Query("SELECT 1 FROM realmlist LIMIT 1");
+        }
+    }
+
+    s_threadDatabase->db = NULL;
+    if (db)
+    {
+        db->ThreadEnd();
+        delete db;                                          // halts its delay thread
+    }
+    else
+        LoginDatabase.ThreadEnd();
+
+    DEBUG_LOG("Auth network thread exits");
+    return 0;
+}
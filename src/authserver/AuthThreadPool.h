@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#ifndef _AUTHTHREADPOOL_H
+#define _AUTHTHREADPOOL_H
+
+#include "Common.h"
+#include "Database/DatabaseEnv.h"
+
+#include <ace/Task.h>
+
+#include <string>
+
+class ACE_Reactor;
+
+// Extra threads dispatching the events of the auth reactor.
+//
+// The main thread keeps running the reactor loop, every pool thread joins
+// it, so logon challenges and proofs (SRP6 math and account lookups) of
+// different clients are handled in parallel. The reactor suspends a socket
+// while one thread handles it, a socket is never handled by two threads at
+// once. Each pool thread reads the login database through its own
+// connection, writes still go through LoginDatabase.
+class AuthThreadPool : protected ACE_Task_Base
+{
+    public:
+        AuthThreadPool();
+        ~AuthThreadPool();
+
+        bool Start(ACE_Reactor* reactor, uint32 threads, std::string const& dbstring, uint32 pingLoops);
+        // call after end_reactor_event_loop(), waits for the threads to exit
+        void Wait();
+
+        // connection of the calling pool thread, LoginDatabase for any other thread
+        static DatabaseType& GetReadDatabase();
+
+    protected:
+        virtual int svc();
+
+    private:
+        ACE_Reactor* m_reactor;
+        std::string m_dbstring;
+        uint32 m_pingLoops;
+};
+
+#endif
@@ -10,6 +10,7 @@
 #include "Config/Config.h"
 #include "Log.h"
 #include "AuthSocket.h"
+#include "AuthThreadPool.h"
 #include "SystemConfig.h"
 #include "Util.h"
 
@@ -270,6 +271,12 @@ extern int main(int argc, char **argv)
     uint32 numLoops = (sConfig.GetIntDefault( "MaxPingTime", 30 ) * (MINUTE * 1000000 / 100000));
     uint32 loopCounter = 0;
 
+    // the main thread is the first network thread, the pool adds the others
+    AuthThreadPool threadPool;
+    uint32 networkThreads = sConfig.GetIntDefault("NetworkThreads", 1);
+    if (networkThreads > 1)
+        threadPool.Start(ACE_Reactor::instance(), networkThreads - 1, sConfig.GetStringDefault("LoginDatabaseInfo", ""), numLoops);
+
     // Wait for termination signal
     while (!stopEvent)
     {
@@ -291,7 +298,9 @@ extern int main(int argc, char **argv)
 #endif
     }
 
-    // Wait for the delay thread to exit
+    // Wait for the network threads and the delay thread to exit
+    ACE_Reactor::instance()->end_reactor_event_loop();
+    threadPool.Wait();
     LoginDatabase.HaltDelayThread();
 
     // Remove signal handling before leaving
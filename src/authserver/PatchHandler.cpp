@@ -7,11 +7,18 @@
 #include "AuthCodes.h"
 #include "Log.h"
 #include "Common.h"
+#include "Config/Config.h"
 
 #include <ace/OS_NS_sys_socket.h>
+#include <ace/OS_NS_sys_stat.h>
+#include <ace/OS_NS_sys_time.h>
 #include <ace/OS_NS_dirent.h>
 #include <ace/OS_NS_errno.h>
 #include <ace/OS_NS_unistd.h>
+#include <ace/Reactor.h>
+
+#include <set>
+#include <vector>
 
 #include <ace/os_include/netinet/os_tcp.h>
 
@@ -19,43 +26,51 @@
 #define MSG_NOSIGNAL 0
 #endif
 
-#if defined( __GNUC__ )
-#pragma pack(1)
-#else
-#pragma pack(push,1)
-#endif
+#define PATCH_DIR "./patches/"
+#define PATCH_MD5_CACHE PATCH_DIR "md5.cache"
 
-struct Chunk
-{
-    ACE_UINT8 cmd;
-    ACE_UINT16 data_size;
-    ACE_UINT8 data[4096]; // 4096 - page size on most arch
-};
-
-#if defined( __GNUC__ )
-#pragma pack()
-#else
-#pragma pack(pop)
-#endif
+// CMD_XFER_DATA chunk: cmd, uint16 size, up to 4096 bytes of data
+#define PATCH_CHUNK_DATA_SIZE 4096                          // page size on most arch
+#define PATCH_CHUNK_HEADER_SIZE 3
 
-PatchHandler::PatchHandler(ACE_HANDLE socket, ACE_HANDLE patch)
+// rate limited transfers get their budget in windows of this length
+#define PATCH_PACING_WINDOW_MS 100
+// data sent for one write event before other sockets get their turn
+#define PATCH_MAX_SEND_PER_EVENT (16 * PATCH_CHUNK_DATA_SIZE)
+
+PatchHandler::PatchHandler(ACE_HANDLE socket, ACE_HANDLE patch, ACE_Reactor* reactor) :
+    size_(0), chunkStart_(0), chunkSent_(0), rateLimit_(0), windowLeft_(0), registered_(false)
 {
-    reactor(NULL);
+    this->reactor(reactor);
     set_handle(socket);
     patch_fd_ = patch;
 }
 
 PatchHandler::~PatchHandler()
 {
+    map_.close();
+
     if (patch_fd_ != ACE_INVALID_HANDLE)
         ACE_OS::close(patch_fd_);
 }
 
 int PatchHandler::open(void*)
 {
-    if (get_handle() == ACE_INVALID_HANDLE || patch_fd_ == ACE_INVALID_HANDLE)
+    if (get_handle() == ACE_INVALID_HANDLE || patch_fd_ == ACE_INVALID_HANDLE || !reactor())
         return -1;
 
+    // a resumed transfer starts where the file was seeked to
+    ACE_OFF_T start = ACE_OS::lseek(patch_fd_, 0, SEEK_CUR);
+    ACE_OFF_T file_size = ACE_OS::filesize(patch_fd_);
+    if (start == -1 || file_size <= 0 || start > file_size)
+        return -1;
+
+    if (map_.map(patch_fd_, size_t(file_size), PROT_READ, ACE_MAP_PRIVATE) == -1)
+        return -1;
+
+    size_ = size_t(file_size);
+    chunkStart_ = size_t(start);
+
     int nodelay = 0;
     if (-1 == peer().set_option(ACE_IPPROTO_TCP,
                 TCP_NODELAY,
@@ -76,44 +91,128 @@ int PatchHandler::open(void*)
     }
 #endif // TCP_CORK
 
-    (void) peer().disable(ACE_NONBLOCK);
+    if (peer().enable(ACE_NONBLOCK) == -1)
+        return -1;
 
-    return activate(THR_NEW_LWP | THR_DETACHED | THR_INHERIT_SCHED);
-}
+    // KB per second -> bytes per window
+    rateLimit_ = size_t(sConfig.GetIntDefault("Patch.RateLimit", 0)) * 1024 * PATCH_PACING_WINDOW_MS / 1000;
 
-int PatchHandler::svc(void)
-{
-    // Do 1 second sleep, similar to the one in game/WorldSocket.cpp
+    // Do 1 second delay, similar to the one in game/WorldSocket.cpp
     // Seems client have problems with too fast sends.
-    ACE_OS::sleep(1);
+    if (reactor()->schedule_timer(this, 0, ACE_Time_Value(1)) == -1)
+        return -1;
 
-    int flags = MSG_NOSIGNAL;
+    return 0;
+}
 
-    Chunk data;
-    data.cmd = CMD_XFER_DATA;
+int PatchHandler::handle_timeout(const ACE_Time_Value&, const void*)
+{
+    // first call ends the initial delay, the others a pacing wait
+    if (!registered_)
+    {
+        registered_ = true;
+        return reactor()->register_handler(this, ACE_Event_Handler::WRITE_MASK);
+    }
 
-    ssize_t r;
+    return reactor()->schedule_wakeup(this, ACE_Event_Handler::WRITE_MASK);
+}
+
+int PatchHandler::handle_output(ACE_HANDLE)
+{
+    size_t budget = PATCH_MAX_SEND_PER_EVENT;
 
-    while((r = ACE_OS::read(patch_fd_, data.data, sizeof(data.data))) > 0)
+    if (rateLimit_)
     {
-        data.data_size = (ACE_UINT16)r;
+        ACE_Time_Value now = ACE_OS::gettimeofday();
+        if (now >= windowEnd_)
+        {
+            windowEnd_ = now + ACE_Time_Value(0, PATCH_PACING_WINDOW_MS * 1000);
+            windowLeft_ = rateLimit_;
+        }
 
-        if (peer().send((const char*)&data,
-                    ((size_t) r) + sizeof(data) - sizeof(data.data),
-                    flags) == -1)
+        if (!windowLeft_)
         {
-            return -1;
+            // nothing left in this window, sleep on a timer instead of write events
+            if (reactor()->cancel_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1 ||
+                reactor()->schedule_timer(this, 0, windowEnd_ - now) == -1)
+                return -1;
+
+            return 0;
         }
+
+        if (windowLeft_ < budget)
+            budget = windowLeft_;
     }
 
-    if (r == -1)
-    {
+    size_t sentBefore = chunkStart_ + chunkSent_;
+    if (!SendChunks(budget))
         return -1;
+
+    if (rateLimit_)
+    {
+        // header bytes are counted as data, close enough for pacing
+        size_t sent = chunkStart_ + chunkSent_ - sentBefore;
+        windowLeft_ = sent < windowLeft_ ? windowLeft_ - sent : 0;
     }
 
+    // whole file sent, handle_close() closes the socket and deletes us
+    if (chunkStart_ >= size_)
+        return -1;
+
     return 0;
 }
 
+bool PatchHandler::SendChunks(size_t budget)
+{
+    const char* base = (const char*)map_.addr();
+
+    while (chunkStart_ < size_ && budget)
+    {
+        size_t len = size_ - chunkStart_;
+        if (len > PATCH_CHUNK_DATA_SIZE)
+            len = PATCH_CHUNK_DATA_SIZE;
+
+        if (!chunkSent_)
+        {
+            ACE_UINT16 data_size = (ACE_UINT16)len;
+            header_[0] = CMD_XFER_DATA;
+            memcpy(&header_[1], &data_size, sizeof(data_size));
+        }
+
+        // header first, then the data straight from the mapping
+        const char* buf;
+        size_t buf_len;
+        if (chunkSent_ < PATCH_CHUNK_HEADER_SIZE)
+        {
+            buf = (const char*)&header_[chunkSent_];
+            buf_len = PATCH_CHUNK_HEADER_SIZE - chunkSent_;
+        }
+        else
+        {
+            size_t dataSent = chunkSent_ - PATCH_CHUNK_HEADER_SIZE;
+            buf = base + chunkStart_ + dataSent;
+            buf_len = len - dataSent;
+            if (buf_len > budget)
+                buf_len = budget;
+        }
+
+        ssize_t n = peer().send(buf, buf_len, MSG_NOSIGNAL);
+        if (n == -1)
+            return errno == EWOULDBLOCK || errno == EAGAIN;
+
+        chunkSent_ += size_t(n);
+        budget = size_t(n) < budget ? budget - size_t(n) : 0;
+
+        if (chunkSent_ == PATCH_CHUNK_HEADER_SIZE + len)
+        {
+            chunkStart_ += len;
+            chunkSent_ = 0;
+        }
+    }
+
+    return true;
+}
+
 PatchCache::~PatchCache()
 {
     for (Patches::iterator i = patches_.begin (); i != patches_.end (); i++)
@@ -131,39 +230,60 @@ PatchCache* PatchCache::instance()
 }
 
 void PatchCache::LoadPatchMD5(const char* szFileName)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, lock_);
+
+    if (HashPatch(szFileName))
+        SaveDiskCache();
+}
+
+bool PatchCache::HashPatch(const char* szFileName)
 {
     // Try to open the patch file
-    std::string path = "./patches/";
+    std::string path = PATCH_DIR;
     path += szFileName;
+
+    ACE_stat st;
+    if (ACE_OS::stat(path.c_str(), &st) == -1)
+        return false;
+
+    // hash from the disk cache is still valid
+    Patches::iterator itr = patches_.find(path);
+    if (itr != patches_.end() && itr->second->size == ACE_UINT64(st.st_size) && itr->second->mtime == st.st_mtime)
+        return false;
+
     FILE * pPatch = fopen(path.c_str (), "rb");
     sLog.outDebug("Loading patch info from %s", path.c_str());
 
     if (!pPatch)
-        return;
+        return false;
 
     // Calculate the MD5 hash
     MD5_CTX ctx;
     MD5_Init(&ctx);
 
-    const size_t check_chunk_size = 4*1024;
+    const size_t check_chunk_size = 64*1024;
 
-    ACE_UINT8 buf[check_chunk_size];
+    std::vector<ACE_UINT8> buf(check_chunk_size);
 
-    while(!feof (pPatch))
-    {
-        size_t read = fread(buf, 1, check_chunk_size, pPatch);
-        MD5_Update(&ctx, buf, read);
-    }
+    size_t read;
+    while ((read = fread(&buf[0], 1, check_chunk_size, pPatch)) > 0)
+        MD5_Update(&ctx, &buf[0], read);
 
     fclose(pPatch);
 
     // Store the result in the internal patch hash map
-    patches_[path] = new PATCH_INFO;
-    MD5_Final((ACE_UINT8 *) & patches_[path]->md5, &ctx);
+    PATCH_INFO* info = itr != patches_.end() ? itr->second : (patches_[path] = new PATCH_INFO);
+    MD5_Final((ACE_UINT8 *) & info->md5, &ctx);
+    info->size = ACE_UINT64(st.st_size);
+    info->mtime = st.st_mtime;
+    return true;
 }
 
 bool PatchCache::GetHash(const char * pat, ACE_UINT8 mymd5[MD5_DIGEST_LENGTH])
 {
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, lock_, false);
+
     for (Patches::iterator i = patches_.begin (); i != patches_.end (); i++)
         if (!stricmp(pat, i->first.c_str ()))
         {
@@ -176,11 +296,16 @@ bool PatchCache::GetHash(const char * pat, ACE_UINT8 mymd5[MD5_DIGEST_LENGTH])
 
 void PatchCache::LoadPatchesInfo()
 {
-    ACE_DIR* dirp = ACE_OS::opendir(ACE_TEXT("./patches/"));
+    ACE_DIR* dirp = ACE_OS::opendir(ACE_TEXT(PATCH_DIR));
 
     if (!dirp)
         return;
 
+    LoadDiskCache();
+
+    bool changed = false;
+    std::set<std::string> present;
+
     ACE_DIRENT* dp;
 
     while((dp = ACE_OS::readdir(dirp)) != NULL)
@@ -190,9 +315,89 @@ void PatchCache::LoadPatchesInfo()
             continue;
 
         if (!memcmp(&dp->d_name[l - 4], ".mpq", 4))
-            LoadPatchMD5(dp->d_name);
+        {
+            if (HashPatch(dp->d_name))
+                changed = true;
+
+            present.insert(std::string(PATCH_DIR) + dp->d_name);
+        }
     }
 
     ACE_OS::closedir(dirp);
+
+    // forget patches removed since the cache was written
+    for (Patches::iterator i = patches_.begin(); i != patches_.end();)
+    {
+        if (present.find(i->first) == present.end())
+        {
+            delete i->second;
+            patches_.erase(i++);
+            changed = true;
+        }
+        else
+            ++i;
+    }
+
+    if (changed)
+        SaveDiskCache();
+}
+
+// one line per patch: md5 size mtime path
+void PatchCache::LoadDiskCache()
+{
+    FILE* file = fopen(PATCH_MD5_CACHE, "r");
+    if (!file)
+        return;
+
+    char line[512];
+    while (fgets(line, sizeof(line), file))
+    {
+        char md5hex[MD5_DIGEST_LENGTH * 2 + 1];
+        ACE_UINT64 size, mtime;
+        int pathPos = 0;
+        if (sscanf(line, "%32s " UI64FMTD " " UI64FMTD " %n", md5hex, &size, &mtime, &pathPos) != 3 || !pathPos)
+            continue;
+
+        if (strlen(md5hex) != MD5_DIGEST_LENGTH * 2)
+            continue;
+
+        std::string path = line + pathPos;
+        while (!path.empty() && (path[path.length() - 1] == '\n' || path[path.length() - 1] == '\r'))
+            path.erase(path.length() - 1);
+
+        if (path.empty() || patches_.find(path) != patches_.end())
+            continue;
+
+        PATCH_INFO* info = new PATCH_INFO;
+        for (int i = 0; i < MD5_DIGEST_LENGTH; ++i)
+        {
+            char byte[3] = { md5hex[i * 2], md5hex[i * 2 + 1], 0 };
+            info->md5[i] = ACE_UINT8(strtoul(byte, NULL, 16));
+        }
+        info->size = size;
+        info->mtime = time_t(mtime);
+        patches_[path] = info;
+    }
+
+    fclose(file);
 }
 
+void PatchCache::SaveDiskCache()
+{
+    FILE* file = fopen(PATCH_MD5_CACHE, "w");
+    if (!file)
+    {
+        sLog.outError("Can't write patch hash cache %s", PATCH_MD5_CACHE);
+        return;
+    }
+
+    for (Patches::const_iterator i = patches_.begin(); i != patches_.end(); ++i)
+    {
+        for (int j = 0; j < MD5_DIGEST_LENGTH; ++j)
+            fprintf(file, "%02x", i->second->md5[j]);
+
+        fprintf(file, " " UI64FMTD " " UI64FMTD " %s\n", i->second->size, ACE_UINT64(i->second->mtime), i->first.c_str());
+    }
+
+    fclose(file);
+}
@@ -12,12 +12,17 @@
 #include <ace/SOCK_Stream.h>
 #include <ace/Message_Block.h>
 #include <ace/Auto_Ptr.h>
+#include <ace/Mem_Map.h>
+#include <ace/Thread_Mutex.h>
 #include <map>
+#include <string>
 
 #include <openssl/bn.h>
 #include <openssl/md5.h>
 
-// Caches MD5 hash of client patches present on the server
+// Caches MD5 hash of client patches present on the server.
+// Hashes are also kept on disk keyed by file size and modification time,
+// so unchanged patches are not read again at startup.
 class PatchCache
 {
     public:
@@ -29,6 +34,8 @@ class PatchCache
         struct PATCH_INFO
         {
             ACE_UINT8 md5[MD5_DIGEST_LENGTH];
+            ACE_UINT64 size;                                // file size and mtime the hash was made of
+            time_t mtime;
         };
 
         typedef std::map<std::string, PATCH_INFO*> Patches;
@@ -48,26 +55,53 @@ class PatchCache
 
     private:
         void LoadPatchesInfo();
+        // hashes a patch unless its cached hash is still valid, true if it did
+        bool HashPatch(const char* szFileName);
+        // reads the on-disk hash cache into patches_
+        void LoadDiskCache();
+        void SaveDiskCache();
+
         Patches patches_;
+        ACE_Thread_Mutex lock_;                             // network threads may hash a new patch meanwhile
 
 };
 
+// Sends a patch file to the client from the auth reactor.
+//
+// The file is mapped and sent straight from the mapping, one CMD_XFER_DATA
+// chunk at a time, whenever the socket is writable. With Patch.RateLimit
+// set, a connection that used its budget for the current window waits for
+// a reactor timer instead of blocking a thread.
 class PatchHandler: public ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH>
 {
     protected:
         typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> Base;
 
     public:
-        PatchHandler(ACE_HANDLE socket, ACE_HANDLE patch);
+        PatchHandler(ACE_HANDLE socket, ACE_HANDLE patch, ACE_Reactor* reactor);
         virtual ~PatchHandler();
 
         int open(void* = 0);
 
-    protected:
-        virtual int svc(void);
+        virtual int handle_output(ACE_HANDLE = ACE_INVALID_HANDLE);
+        virtual int handle_timeout(const ACE_Time_Value& current_time, const void* act = 0);
 
     private:
+        // sends as much as the socket and the budget allow, false on socket error
+        bool SendChunks(size_t budget);
+
         ACE_HANDLE patch_fd_;
+        ACE_Mem_Map map_;
+        size_t size_;
+
+        size_t chunkStart_;                                 // file offset of the chunk being sent
+        size_t chunkSent_;                                  // bytes of it already sent, header included
+        ACE_UINT8 header_[3];
+
+        size_t rateLimit_;                                  // bytes per pacing window, 0 for unlimited
+        ACE_Time_Value windowEnd_;
+        size_t windowLeft_;
+        bool registered_;
 
 };
 
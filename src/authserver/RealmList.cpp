@@ -52,13 +52,13 @@ void RealmList::Initialize(uint32 updateInterval)
     m_UpdateInterval = updateInterval;
 
     // Get the content of the realmlist table in the database
-    UpdateRealms(true);
+    UpdateRealms(m_realms, true);
 }
 
-void RealmList::UpdateRealm( uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const char* builds)
+void RealmList::UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const char* builds)
 {
     // Create new if not exist or update existed
-    Realm& realm = m_realms[name];
+    Realm& realm = realms[name];
 
     realm.m_ID       = ID;
     realm.icon       = icon;
@@ -101,16 +101,32 @@ void RealmList::UpdateIfNeed()
     if (!m_UpdateInterval || m_NextUpdateTime > time(NULL))
         return;
 
-    m_NextUpdateTime = time(NULL) + m_UpdateInterval;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
 
-    // Clears Realm list
-    m_realms.clear();
+        // another thread is already refreshing it
+        if (m_NextUpdateTime > time(NULL))
+            return;
 
-    // Get the content of the realmlist table in the database
-    UpdateRealms(false);
+        m_NextUpdateTime = time(NULL) + m_UpdateInterval;
+    }
+
+    // Get the content of the realmlist table in the database, the old list is served meanwhile
+    RealmMap realms;
+    UpdateRealms(realms, false);
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+    m_realms.swap(realms);
+    m_packets.clear();
+}
+
+RealmListPacket const* RealmList::FindPacket(uint16 build, uint8 security) const
+{
+    RealmListPacketMap::const_iterator itr = m_packets.find(std::make_pair(build, security));
+    return itr != m_packets.end() ? &itr->second : NULL;
 }
 
-void RealmList::UpdateRealms(bool init)
+void RealmList::UpdateRealms(RealmMap& realms, bool init)
 {
     sLog.outDetail("Updating Realm List...");
 
@@ -134,7 +150,7 @@ void RealmList::UpdateRealms(bool init)
                 realmflags &= (REALM_FLAG_OFFLINE|REALM_FLAG_NEW_PLAYERS|REALM_FLAG_RECOMMENDED|REALM_FLAG_SPECIFYBUILD);
             }
 
-            UpdateRealm(
+            UpdateRealm(realms,
                 fields[0].GetUInt32(), fields[1].GetCppString(),fields[2].GetCppString(),fields[3].GetUInt32(),
                 fields[4].GetUInt8(), RealmFlags(realmflags), fields[6].GetUInt8(),
                 (allowedSecurityLevel <= SEC_ADMINISTRATOR ? AccountTypes(allowedSecurityLevel) : SEC_ADMINISTRATOR),
@@ -8,7 +8,9 @@
 
 #include <ace/Singleton.h>
 #include <ace/Null_Mutex.h>
+#include <ace/Thread_Mutex.h>
 #include "Common.h"
+#include "ByteBuffer.h"
 
 struct RealmBuildInfo
 {
@@ -37,6 +39,14 @@ struct Realm
     RealmBuildInfo realmBuildInfo;                          // build info for show version in list
 };
 
+// Serialized realm list of one client build and security level. Only the
+// character counts differ between accounts, they are patched in per request.
+struct RealmListPacket
+{
+    ByteBuffer data;
+    std::vector<std::pair<uint32, size_t> > charCountPos;  // realm id, position of its character count byte
+};
+
 // Storage object for the list of realms on the server
 class RealmList
 {
@@ -45,6 +55,7 @@ class RealmList
         static RealmList* instance() { return ACE_Singleton<RealmList, ACE_Null_Mutex>::instance(); }
 
         typedef std::map<std::string, Realm> RealmMap;
+        typedef std::map<std::pair<uint16, uint8>, RealmListPacket> RealmListPacketMap;
 
         RealmList();
         ~RealmList() {}
@@ -52,17 +63,28 @@ class RealmList
         void Initialize(uint32 updateInterval);
 
         void UpdateIfNeed();
+        uint32 GetUpdateInterval() const { return m_UpdateInterval; }
+
+        // hold while iterating, network threads may refresh the list meanwhile
+        ACE_Thread_Mutex& GetLock() { return m_lock; }
 
         RealmMap::const_iterator begin() const { return m_realms.begin(); }
         RealmMap::const_iterator end() const { return m_realms.end(); }
         uint32 size() const { return m_realms.size(); }
+
+        // serialized list for a build and security level, NULL if not built since the last refresh
+        // both require GetLock() to be held
+        RealmListPacket const* FindPacket(uint16 build, uint8 security) const;
+        RealmListPacket& AddPacket(uint16 build, uint8 security) { return m_packets[std::make_pair(build, security)]; }
     private:
-        void UpdateRealms(bool init);
-        void UpdateRealm( uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const char* builds);
+        void UpdateRealms(RealmMap& realms, bool init);
+        void UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const char* builds);
     private:
         RealmMap m_realms;                                  ///< Internal map of realms
+        RealmListPacketMap m_packets;                       ///< Serialized m_realms, dropped at refresh
         uint32   m_UpdateInterval;
         time_t   m_NextUpdateTime;
+        ACE_Thread_Mutex m_lock;                            ///< Guards m_realms against concurrent refresh
 };
 
 #define sRealmList RealmList::instance()
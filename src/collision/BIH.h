@@ -20,6 +20,11 @@
 
 #define MAX_STACK_SIZE 64
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define BIH_PACKET_SSE
+#endif
+
 #ifdef _MSC_VER
     #define isnan(x) _isnan(x)
 #else
@@ -57,6 +62,30 @@ struct AABound
     Vector3 lo, hi;
 };
 
+#define RAY_PACKET_SIZE 4
+
+/* Rays traced together through the BIH, one lane per ray, stored per
+   component so the triangle tests can work on all lanes at once.
+   Which lanes are used is passed along as a bit mask. */
+struct RayPacket
+{
+    float org[3][RAY_PACKET_SIZE];
+    float dir[3][RAY_PACKET_SIZE];
+    float maxDist[RAY_PACKET_SIZE];                         // shortened to the closest hit
+
+    void setRay(uint32 lane, const Vector3 &origin, const Vector3 &direction, float dist)
+    {
+        for (int i=0; i<3; ++i)
+        {
+            org[i][lane] = origin[i];
+            dir[i][lane] = direction[i];
+        }
+        maxDist[lane] = dist;
+    }
+    Vector3 origin(uint32 lane) const { return Vector3(org[0][lane], org[1][lane], org[2][lane]); }
+    Vector3 direction(uint32 lane) const { return Vector3(dir[0][lane], dir[1][lane], dir[2][lane]); }
+};
+
 /* Bounding Interval Hierarchy Class.
    Building and Ray-Intersection functions based on BIH from
    Sunflow, a Java Raytracer, released under MIT/X11 License
@@ -67,7 +96,21 @@ struct AABound
 class BIH
 {
     public:
-        BIH() {};
+        BIH(): treeData(0), treeSize(0), objectData(0), objectCount(0) {};
+        BIH(const BIH &other): treeData(0), treeSize(0), objectData(0), objectCount(0) { *this = other; }
+        BIH& operator=(const BIH &other)
+        {
+            if (this == &other)
+                return *this;
+            tree = other.tree;
+            objects = other.objects;
+            bounds = other.bounds;
+            if (tree.empty())
+                setMappedData(other.bounds, other.treeData, other.treeSize, other.objectData, other.objectCount);
+            else
+                useOwnData();
+            return *this;
+        }
         template< class T, class BoundsFunc >
         void build(const std::vector<T> &primitives, BoundsFunc &getBounds, uint32 leafSize = 3, bool printStats=false)
         {
@@ -97,10 +140,26 @@ class BIH
                 objects[i] = dat.indices[i];
             //nObjects = dat.numPrims;
             tree = tempTree;
+            useOwnData();
             delete[] dat.primBound;
             delete[] dat.indices;
         }
-        uint32 primCount() { return objects.size(); }
+        uint32 primCount() { return objectCount; }
+
+        // nodes and object indices stored elsewhere, e.g. in a mapped file that outlives the BIH
+        void setMappedData(const AABox &bound, const uint32 *nodes, uint32 nodeCount, const uint32 *indices, uint32 indexCount)
+        {
+            bounds = bound;
+            treeData = nodes;
+            treeSize = nodeCount;
+            objectData = indices;
+            objectCount = indexCount;
+        }
+        const AABox& getBounds() const { return bounds; }
+        const uint32* getTreeData() const { return treeData; }
+        uint32 getTreeSize() const { return treeSize; }
+        const uint32* getObjectData() const { return objectData; }
+        uint32 getObjectCount() const { return objectCount; }
 
         template<typename RayCallback>
         void intersectRay(const Ray &r, RayCallback& intersectCallback, float &maxDist, bool stopAtFirst=false) const
@@ -160,7 +219,7 @@ class BIH
             while (true) {
                 while (true)
                 {
-                    uint32 tn = tree[node];
+                    uint32 tn = treeData[node];
                     uint32 axis = (tn & (3 << 30)) >> 30;
                     bool BVH2 = tn & (1 << 29);
                     int offset = tn & ~(7 << 29);
@@ -169,8 +228,8 @@ class BIH
                         if (axis < 3)
                         {
                             // "normal" interior node
-                            float tf = (intBitsToFloat(tree[node + offsetFront[axis]]) - org[axis]) * invDir[axis];
-                            float tb = (intBitsToFloat(tree[node + offsetBack[axis]]) - org[axis]) * invDir[axis];
+                            float tf = (intBitsToFloat(treeData[node + offsetFront[axis]]) - org[axis]) * invDir[axis];
+                            float tb = (intBitsToFloat(treeData[node + offsetBack[axis]]) - org[axis]) * invDir[axis];
                             // ray passes between clip zones
                             if (tf < intervalMin && tb > intervalMax)
                                 break;
@@ -200,9 +259,9 @@ class BIH
                         else
                         {
                             // leaf - test some objects
-                            int n = tree[node + 1];
+                            int n = treeData[node + 1];
                             while (n > 0) {
-                                bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst);
+                                bool hit = intersectCallback(r, objectData[offset], maxDist, stopAtFirst);
                                 if (stopAtFirst && hit) return;
                                 --n;
                                 ++offset;
@@ -214,8 +273,8 @@ class BIH
                     {
                         if (axis>2)
                             return; // should not happen
-                        float tf = (intBitsToFloat(tree[node + offsetFront[axis]]) - org[axis]) * invDir[axis];
-                        float tb = (intBitsToFloat(tree[node + offsetBack[axis]]) - org[axis]) * invDir[axis];
+                        float tf = (intBitsToFloat(treeData[node + offsetFront[axis]]) - org[axis]) * invDir[axis];
+                        float tb = (intBitsToFloat(treeData[node + offsetBack[axis]]) - org[axis]) * invDir[axis];
                         node = offset;
                         intervalMin = (tf >= intervalMin) ? tf : intervalMin;
                         intervalMax = (tb <= intervalMax) ? tb : intervalMax;
@@ -241,6 +300,218 @@ class BIH
             }
         }
 
+        /* Same traversal for the lanes of mask in a packet: a node is entered
+           while any lane still passes it, with an own interval per lane.
+           The callback returns the lanes hitting an object and shortens
+           their maxDist. Returns all lanes that hit something. */
+        template<typename PacketCallback>
+        uint32 intersectRayPacket(RayPacket &packet, PacketCallback& intersectCallback, uint32 mask, bool stopAtFirst=false) const
+        {
+            float invDir[3][RAY_PACKET_SIZE];
+            uint32 negDir[3] = { 0, 0, 0 };                 // lanes going to lower coordinates
+            PacketStackNode cur;
+            cur.node = 0;
+            cur.mask = 0;
+            for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+            {
+                uint32 bit = 1 << lane;
+                for (int i=0; i<3; ++i)
+                    invDir[i][lane] = 0.f;
+                cur.tnear[lane] = 0.f;
+                cur.tfar[lane] = 0.f;
+                if (!(mask & bit))
+                    continue;
+                float intervalMin = 0.f;
+                float intervalMax = packet.maxDist[lane];
+                for (int i=0; i<3; ++i)
+                {
+                    float dir = packet.dir[i][lane];
+                    invDir[i][lane] = 1.f / dir;
+                    if (floatToRawIntBits(dir) >> 31)
+                        negDir[i] |= bit;
+                    if (G3D::fuzzyNe(dir, 0.0f))
+                    {
+                        float t1 = (bounds.low()[i]  - packet.org[i][lane]) * invDir[i][lane];
+                        float t2 = (bounds.high()[i] - packet.org[i][lane]) * invDir[i][lane];
+                        if (t1 > t2)
+                            std::swap(t1, t2);
+                        if (t1 > intervalMin)
+                            intervalMin = t1;
+                        if (t2 < intervalMax)
+                            intervalMax = t2;
+                    }
+                }
+                if (intervalMin <= intervalMax)
+                {
+                    cur.tnear[lane] = intervalMin;
+                    cur.tfar[lane] = intervalMax;
+                    cur.mask |= bit;
+                }
+            }
+
+#ifdef BIH_PACKET_SSE
+            __m128 negMask[3];
+            for (int i=0; i<3; ++i)
+                negMask[i] = _mm_cmplt_ps(_mm_loadu_ps(invDir[i]), _mm_setzero_ps());
+#endif
+
+            uint32 hits = 0;
+            uint32 done = 0;
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+
+            while (true) {
+                while (cur.mask)
+                {
+                    uint32 tn = treeData[cur.node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = tn & (1 << 29);
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, split the lanes by the child they pass
+                            // a NaN distance keeps the interval, so such a lane visits both
+                            float clipLeft = intBitsToFloat(treeData[cur.node + 1]);
+                            float clipRight = intBitsToFloat(treeData[cur.node + 2]);
+                            PacketStackNode left;
+                            PacketStackNode right;
+                            left.node = offset;
+                            left.mask = 0;
+                            right.node = offset + 3;
+                            right.mask = 0;
+#ifdef BIH_PACKET_SSE
+                            __m128 org = _mm_loadu_ps(packet.org[axis]);
+                            __m128 inv = _mm_loadu_ps(invDir[axis]);
+                            __m128 neg = negMask[axis];
+                            __m128 tl = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(clipLeft), org), inv);
+                            __m128 tr = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(clipRight), org), inv);
+                            __m128 tnear = _mm_loadu_ps(cur.tnear);
+                            __m128 tfar = _mm_loadu_ps(cur.tfar);
+                            __m128 leftNear = _mm_or_ps(_mm_and_ps(neg, _mm_max_ps(tl, tnear)), _mm_andnot_ps(neg, tnear));
+                            __m128 leftFar = _mm_or_ps(_mm_and_ps(neg, tfar), _mm_andnot_ps(neg, _mm_min_ps(tl, tfar)));
+                            __m128 rightNear = _mm_or_ps(_mm_and_ps(neg, tnear), _mm_andnot_ps(neg, _mm_max_ps(tr, tnear)));
+                            __m128 rightFar = _mm_or_ps(_mm_and_ps(neg, _mm_min_ps(tr, tfar)), _mm_andnot_ps(neg, tfar));
+                            _mm_storeu_ps(left.tnear, leftNear);
+                            _mm_storeu_ps(left.tfar, leftFar);
+                            _mm_storeu_ps(right.tnear, rightNear);
+                            _mm_storeu_ps(right.tfar, rightFar);
+                            left.mask = _mm_movemask_ps(_mm_cmple_ps(leftNear, leftFar)) & cur.mask;
+                            right.mask = _mm_movemask_ps(_mm_cmple_ps(rightNear, rightFar)) & cur.mask;
+#else
+                            for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                            {
+                                uint32 bit = 1 << lane;
+                                if (!(cur.mask & bit))
+                                    continue;
+                                float tl = (clipLeft - packet.org[axis][lane]) * invDir[axis][lane];
+                                float tr = (clipRight - packet.org[axis][lane]) * invDir[axis][lane];
+                                float tnear = cur.tnear[lane];
+                                float tfar = cur.tfar[lane];
+                                if (negDir[axis] & bit)
+                                {
+                                    left.tnear[lane] = (tl > tnear) ? tl : tnear;
+                                    left.tfar[lane] = tfar;
+                                    right.tnear[lane] = tnear;
+                                    right.tfar[lane] = (tr < tfar) ? tr : tfar;
+                                }
+                                else
+                                {
+                                    left.tnear[lane] = tnear;
+                                    left.tfar[lane] = (tl < tfar) ? tl : tfar;
+                                    right.tnear[lane] = (tr > tnear) ? tr : tnear;
+                                    right.tfar[lane] = tfar;
+                                }
+                                if (left.tnear[lane] <= left.tfar[lane])
+                                    left.mask |= bit;
+                                if (right.tnear[lane] <= right.tfar[lane])
+                                    right.mask |= bit;
+                            }
+#endif
+                            // both nodes: go near first for the leading lane, push back the other
+                            bool rightFirst = (negDir[axis] & cur.mask & (~cur.mask + 1)) != 0;
+                            PacketStackNode &front = rightFirst ? right : left;
+                            PacketStackNode &back = rightFirst ? left : right;
+                            if (front.mask && back.mask)
+                                stack[stackPos++] = back;
+                            cur = front.mask ? front : back;
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects
+                            int n = treeData[cur.node + 1];
+                            while (n > 0 && cur.mask) {
+                                uint32 hit = intersectCallback(packet, objectData[offset], cur.mask, stopAtFirst);
+                                hits |= hit;
+                                if (stopAtFirst)
+                                {
+                                    done |= hit;
+                                    cur.mask &= ~hit;
+                                }
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis>2)
+                            return hits; // should not happen
+                        float clipLow = intBitsToFloat(treeData[cur.node + 1]);
+                        float clipHigh = intBitsToFloat(treeData[cur.node + 2]);
+                        cur.node = offset;
+#ifdef BIH_PACKET_SSE
+                        __m128 org = _mm_loadu_ps(packet.org[axis]);
+                        __m128 inv = _mm_loadu_ps(invDir[axis]);
+                        __m128 neg = negMask[axis];
+                        __m128 tlow = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(clipLow), org), inv);
+                        __m128 thigh = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(clipHigh), org), inv);
+                        __m128 tf = _mm_or_ps(_mm_and_ps(neg, thigh), _mm_andnot_ps(neg, tlow));
+                        __m128 tb = _mm_or_ps(_mm_and_ps(neg, tlow), _mm_andnot_ps(neg, thigh));
+                        __m128 tnear = _mm_max_ps(tf, _mm_loadu_ps(cur.tnear));
+                        __m128 tfar = _mm_min_ps(tb, _mm_loadu_ps(cur.tfar));
+                        _mm_storeu_ps(cur.tnear, tnear);
+                        _mm_storeu_ps(cur.tfar, tfar);
+                        cur.mask &= _mm_movemask_ps(_mm_cmple_ps(tnear, tfar));
+#else
+                        for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                        {
+                            uint32 bit = 1 << lane;
+                            if (!(cur.mask & bit))
+                                continue;
+                            float tlow = (clipLow - packet.org[axis][lane]) * invDir[axis][lane];
+                            float thigh = (clipHigh - packet.org[axis][lane]) * invDir[axis][lane];
+                            float tf = (negDir[axis] & bit) ? thigh : tlow;
+                            float tb = (negDir[axis] & bit) ? tlow : thigh;
+                            if (tf > cur.tnear[lane])
+                                cur.tnear[lane] = tf;
+                            if (tb < cur.tfar[lane])
+                                cur.tfar[lane] = tb;
+                            if (cur.tnear[lane] > cur.tfar[lane])
+                                cur.mask &= ~bit;
+                        }
+#endif
+                        continue;
+                    }
+                } // traversal loop
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                        return hits;
+                    // move back up the stack, dropping lanes done or hit before the node
+                    cur = stack[--stackPos];
+                    cur.mask &= ~done;
+                    for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                        if ((cur.mask & (1 << lane)) && packet.maxDist[lane] < cur.tnear[lane])
+                            cur.mask &= ~(1 << lane);
+                } while (!cur.mask);
+            }
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const Vector3 &p, IsectCallback& intersectCallback) const
         {
@@ -254,7 +525,7 @@ class BIH
             while (true) {
                 while (true)
                 {
-                    uint32 tn = tree[node];
+                    uint32 tn = treeData[node];
                     uint32 axis = (tn & (3 << 30)) >> 30;
                     bool BVH2 = tn & (1 << 29);
                     int offset = tn & ~(7 << 29);
@@ -263,8 +534,8 @@ class BIH
                         if (axis < 3)
                         {
                             // "normal" interior node
-                            float tl = intBitsToFloat(tree[node + 1]);
-                            float tr = intBitsToFloat(tree[node + 2]);
+                            float tl = intBitsToFloat(treeData[node + 1]);
+                            float tr = intBitsToFloat(treeData[node + 2]);
                             // point is between clip zones
                             if (tl < p[axis] && tr > p[axis])
                                 break;
@@ -288,9 +559,9 @@ class BIH
                         else
                         {
                             // leaf - test some objects
-                            int n = tree[node + 1];
+                            int n = treeData[node + 1];
                             while (n > 0) {
-                                intersectCallback(p, objects[offset]); // !!!
+                                intersectCallback(p, objectData[offset]); // !!!
                                 --n;
                                 ++offset;
                             }
@@ -301,8 +572,8 @@ class BIH
                     {
                         if (axis>2)
                             return; // should not happen
-                        float tl = intBitsToFloat(tree[node + 1]);
-                        float tr = intBitsToFloat(tree[node + 2]);
+                        float tl = intBitsToFloat(treeData[node + 1]);
+                        float tr = intBitsToFloat(treeData[node + 2]);
                         node = offset;
                         if (tl > p[axis] || tr < p[axis])
                             break;
@@ -326,6 +597,19 @@ class BIH
         std::vector<uint32> tree;
         std::vector<uint32> objects;
         AABox bounds;
+        // what the queries read, the vectors above or mapped data
+        const uint32 *treeData;
+        uint32 treeSize;
+        const uint32 *objectData;
+        uint32 objectCount;
+
+        void useOwnData()
+        {
+            treeData = tree.empty() ? 0 : &tree[0];
+            treeSize = tree.size();
+            objectData = objects.empty() ? 0 : &objects[0];
+            objectCount = objects.size();
+        }
 
         struct buildData
         {
@@ -340,6 +624,13 @@ class BIH
             float tnear;
             float tfar;
         };
+        struct PacketStackNode
+        {
+            uint32 node;
+            uint32 mask;
+            float tnear[RAY_PACKET_SIZE];
+            float tfar[RAY_PACKET_SIZE];
+        };
 
         class BuildStats
         {
@@ -45,6 +45,11 @@ namespace VMAP
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /*
+            batched versions, the positions are given as x,y,z triples
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, float x, float y, float z, const float* targets, uint8* results, uint32 count) = 0;
+            virtual void getHeights(unsigned int pMapId, const float* positions, float* heights, uint32 count, float maxSearchDist) = 0;
+            /*
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
             return a position, that is pReduceDist closer to the origin
             */
@@ -35,6 +35,18 @@ namespace VMAP
             bool hit;
     };
 
+    class MapPacketCallback
+    {
+        public:
+            MapPacketCallback(ModelInstance *val): prims(val) {}
+            uint32 operator()(RayPacket& packet, uint32 entry, uint32 mask, bool pStopAtFirstHit)
+            {
+                return prims[entry].intersectRayPacket(packet, mask, pStopAtFirstHit);
+            }
+        protected:
+            ModelInstance *prims;
+    };
+
     class AreaInfoCallback
     {
         public:
@@ -148,6 +160,54 @@ namespace VMAP
         return true;
     }
 
+    // grows with the angle of dir around the z axis, cheaper than atan2
+    static float DiamondAngle(const Vector3& dir)
+    {
+        float x = dir.x;
+        float y = dir.y;
+        if (x == 0.f && y == 0.f)
+            return 0.f;
+        if (y >= 0.f)
+            return x >= 0.f ? y/(x+y) : 1.f - x/(-x+y);
+        else
+            return x < 0.f ? 2.f - y/(-x-y) : 3.f + x/(x-y);
+    }
+
+    void StaticMapTree::isInLineOfSight(const Vector3& pos, const Vector3* targets, uint8* results, uint32 count) const
+    {
+        // neighbouring directions share more of the tree, so the packets are filled by angle
+        std::vector<std::pair<float, uint32> > order(count);
+        for (uint32 i = 0; i < count; ++i)
+            order[i] = std::make_pair(DiamondAngle(targets[i] - pos), i);
+        if (count > RAY_PACKET_SIZE)
+            std::sort(order.begin(), order.end());
+
+        MapPacketCallback intersectionCallBack(iTreeValues);
+        for (uint32 first = 0; first < count; first += RAY_PACKET_SIZE)
+        {
+            RayPacket packet = RayPacket();
+            uint32 mask = 0;
+            for (uint32 lane = 0; lane < RAY_PACKET_SIZE && first + lane < count; ++lane)
+            {
+                uint32 index = order[first + lane].second;
+                float maxDist = (targets[index] - pos).magnitude();
+                // valid map coords should *never ever* produce float overflow, but this would produce NaNs too
+                ASSERT(maxDist < std::numeric_limits<float>::max());
+                results[index] = true;
+                if (maxDist < 1e-10f)
+                    continue;
+                packet.setRay(lane, pos, (targets[index] - pos)/maxDist, maxDist);
+                mask |= 1 << lane;
+            }
+            if (!mask)
+                continue;
+            uint32 hits = iTree.intersectRayPacket(packet, intersectionCallBack, mask, true);
+            for (uint32 lane = 0; lane < RAY_PACKET_SIZE; ++lane)
+                if (hits & (1 << lane))
+                    results[order[first + lane].second] = false;
+        }
+    }
+
     /*
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
     Return the hit pos or the original dest pos
@@ -208,6 +268,29 @@ namespace VMAP
         return(height);
     }
 
+    void StaticMapTree::getHeights(const Vector3* positions, float* heights, uint32 count, float maxSearchDist) const
+    {
+        MapPacketCallback intersectionCallBack(iTreeValues);
+        for (uint32 first = 0; first < count; first += RAY_PACKET_SIZE)
+        {
+            RayPacket packet = RayPacket();
+            uint32 mask = 0;
+            for (uint32 lane = 0; lane < RAY_PACKET_SIZE && first + lane < count; ++lane)
+            {
+                packet.setRay(lane, positions[first + lane], Vector3(0,0,-1), maxSearchDist);
+                mask |= 1 << lane;
+            }
+            uint32 hits = iTree.intersectRayPacket(packet, intersectionCallBack, mask, false);
+            for (uint32 lane = 0; lane < RAY_PACKET_SIZE && first + lane < count; ++lane)
+            {
+                if (hits & (1 << lane))
+                    heights[first + lane] = positions[first + lane].z - packet.maxDist[lane];
+                else
+                    heights[first + lane] = G3D::inf();
+            }
+        }
+    }
+
     bool StaticMapTree::CanLoadMap(const std::string &vmapPath, uint32 mapID, uint32 tileX, uint32 tileY)
     {
         std::string basePath = vmapPath;
@@ -49,6 +49,33 @@ namespace VMAP
         return hit;
     }
 
+    uint32 ModelInstance::intersectRayPacket(RayPacket& packet, uint32 mask, bool pStopAtFirstHit) const
+    {
+        if (!iModel)
+            return 0;
+        // child bounds are defined in object space:
+        RayPacket modPacket = RayPacket();
+        uint32 modMask = 0;
+        for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+        {
+            if (!(mask & (1 << lane)))
+                continue;
+            G3D::Ray ray(packet.origin(lane), packet.direction(lane));
+            if (ray.intersectionTime(iBound) == G3D::inf())
+                continue;
+            Vector3 p = iInvRot * (ray.origin() - iPos) * iInvScale;
+            modPacket.setRay(lane, p, iInvRot * ray.direction(), packet.maxDist[lane] * iInvScale);
+            modMask |= 1 << lane;
+        }
+        if (!modMask)
+            return 0;
+        uint32 hits = iModel->IntersectRayPacket(modPacket, modMask, pStopAtFirstHit);
+        for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+            if (hits & (1 << lane))
+                packet.maxDist[lane] = modPacket.maxDist[lane] * iScale;
+        return hits;
+    }
+
     void ModelInstance::intersectPoint(const G3D::Vector3& p, AreaInfo &info) const
     {
         if (!iModel)
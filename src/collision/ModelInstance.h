@@ -12,6 +12,7 @@
 #include <G3D/Ray.h>
 
 #include "Platform/Define.h"
+#include "BIH.h"
 
 namespace VMAP
 {
@@ -55,6 +56,7 @@ namespace VMAP
             ModelInstance(const ModelSpawn &spawn, WorldModel *model);
             void setUnloaded() { iModel = 0; }
             bool intersectRay(const G3D::Ray& pRay, float& pMaxDist, bool pStopAtFirstHit) const;
+            uint32 intersectRayPacket(RayPacket& packet, uint32 mask, bool pStopAtFirstHit) const;
             void intersectPoint(const G3D::Vector3& p, AreaInfo &info) const;
             bool GetLocationInfo(const G3D::Vector3& p, LocationInfo &info) const;
             bool GetLiquidLevel(const G3D::Vector3& p, LocationInfo &info, float &liqHeight) const;
@@ -470,7 +470,7 @@ namespace VMAP
         if (groupsArray.size())
         {
             model.setGroupModels(groupsArray);
-            success = model.writeFile(iDestDir + "/" + pModelFilename + ".vmo");
+            success = model.writeFlatFile(iDestDir + "/" + pModelFilename + ".vmo");
         }
 
         //std::cout << "readRawFile2: '" << pModelFilename << "' tris: " << nElements << " nodes: " << nNodes << std::endl;
@@ -13,6 +13,7 @@ namespace VMAP
 {
     const char VMAP_MAGIC[] = "VMAP_3.0";                   // used in final vmap files
     const char RAW_VMAP_MAGIC[] = "VMAPs03";                // used in extracted vmap files with raw data
+    const char VMAP_FLAT_MAGIC[] = "VMAPf3.0";              // used in flat model files
 
     // defined in TileAssembler.cpp currently...
     bool readChunk(FILE *rf, char *dest, const char *compare, uint32 len);
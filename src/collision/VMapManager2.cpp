@@ -13,10 +13,38 @@
 #include "WorldModel.h"
 #include "VMapDefinitions.h"
 
+#include <ace/Mem_Map.h>
+#include <ace/Guard_T.h>
+
 using G3D::Vector3;
 
 namespace VMAP
 {
+    // finds the tree of a map and keeps its tiles from being changed while in scope
+    class VMapManager2::MapTreeReadGuard
+    {
+        public:
+            MapTreeReadGuard(const VMapManager2 *vm, uint32 mapId): iMapTree(vm->acquireMapTree(mapId))
+            {
+                if (iMapTree)
+                    iMapTree->tilesLock.acquire_read();
+            }
+
+            ~MapTreeReadGuard()
+            {
+                if (iMapTree)
+                {
+                    iMapTree->tilesLock.release();
+                    VMapManager2::releaseMapTree(iMapTree);
+                }
+            }
+
+            const StaticMapTree *getTree() const { return iMapTree && !iMapTree->detached ? iMapTree->tree : 0; }
+
+        private:
+            ManagedMapTree *iMapTree;
+    };
+
 
     VMapManager2::VMapManager2()
     {
@@ -24,13 +52,15 @@ namespace VMAP
 
     VMapManager2::~VMapManager2(void)
     {
-        for (InstanceTreeMap::iterator i = iInstanceMapTrees.begin(); i != iInstanceMapTrees.end(); ++i)
+        for (ManagedMapTreeMap::iterator i = iInstanceMapTrees.begin(); i != iInstanceMapTrees.end(); ++i)
         {
+            delete i->second->tree;
             delete i->second;
         }
         for (ModelFileMap::iterator i = iLoadedModelFiles.begin(); i != iLoadedModelFiles.end(); ++i)
         {
             delete i->second.getModel();
+            delete i->second.getMapping();
         }
     }
 
@@ -106,63 +136,174 @@ namespace VMAP
     // load one tile (internal use only)
     bool VMapManager2::_loadMap(unsigned int pMapId, const std::string &basePath, uint32 tileX, uint32 tileY)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree == iInstanceMapTrees.end())
+        while (true)
         {
+            if (ManagedMapTree *instanceTree = acquireMapTree(pMapId))
+            {
+                bool detached, result = false;
+                {
+                    ACE_Write_Guard<ACE_RW_Thread_Mutex> tilesGuard(instanceTree->tilesLock);
+                    detached = instanceTree->detached;
+                    if (!detached)
+                        result = instanceTree->tree->LoadMapTile(tileX, tileY, this);
+                }
+
+                // emptied by an unload, make sure it is gone from the table and use a new one
+                if (detached)
+                    detachMapTree(pMapId, instanceTree);
+                releaseMapTree(instanceTree);
+                if (!detached)
+                    return result;
+                continue;
+            }
+
+            // first tile of the map, its tree is read without blocking the other maps
             std::string mapFileName = getMapFileName(pMapId);
             StaticMapTree *newTree = new StaticMapTree(pMapId, basePath);
             if (!newTree->InitMap(mapFileName, this))
+            {
+                newTree->UnloadMap(this);
+                delete newTree;
                 return false;
-            instanceTree = iInstanceMapTrees.insert(InstanceTreeMap::value_type(pMapId, newTree)).first;
+            }
+
+            {
+                ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, iInstanceMapTreesLock, false);
+                if (!iInstanceMapTrees.count(pMapId))
+                {
+                    iInstanceMapTrees[pMapId] = new ManagedMapTree(newTree);
+                    newTree = NULL;
+                }
+            }
+
+            // another thread was faster
+            if (newTree)
+            {
+                newTree->UnloadMap(this);
+                delete newTree;
+            }
         }
-        return instanceTree->second->LoadMapTile(tileX, tileY, this);
     }
 
-    void VMapManager2::unloadMap(unsigned int pMapId)
+    ManagedMapTree* VMapManager2::acquireMapTree(unsigned int pMapId) const
+    {
+        ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, iInstanceMapTreesLock, NULL);
+        ManagedMapTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return NULL;
+
+        ++instanceTree->second->refCount;
+        return instanceTree->second;
+    }
+
+    void VMapManager2::releaseMapTree(ManagedMapTree *mapTree)
+    {
+        // only detached trees lose their last reference, their tiles are unloaded already
+        if (--mapTree->refCount == 0)
+        {
+            delete mapTree->tree;
+            delete mapTree;
+        }
+    }
+
+    void VMapManager2::detachMapTree(unsigned int pMapId, ManagedMapTree *mapTree)
+    {
+        {
+            ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, iInstanceMapTreesLock);
+
+            // a new tree may have taken its place
+            ManagedMapTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+            if (instanceTree == iInstanceMapTrees.end() || instanceTree->second != mapTree)
+                return;
+            iInstanceMapTrees.erase(instanceTree);
+        }
+
+        // the reference of the table
+        releaseMapTree(mapTree);
+    }
+
+    void VMapManager2::unloadMapTree(unsigned int pMapId, ManagedMapTree *mapTree, bool onlyEmpty)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        bool detached;
         {
-            instanceTree->second->UnloadMap(this);
-            if (instanceTree->second->numLoadedTiles() == 0)
+            ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, tilesGuard, mapTree->tilesLock);
+
+            // a tile may have been loaded since
+            if (!mapTree->detached && (!onlyEmpty || mapTree->tree->numLoadedTiles() == 0))
             {
-                delete instanceTree->second;
-                iInstanceMapTrees.erase(pMapId);
+                mapTree->tree->UnloadMap(this);
+                mapTree->detached = true;
             }
+            detached = mapTree->detached;
+        }
+
+        if (detached)
+            detachMapTree(pMapId, mapTree);
+    }
+
+    void VMapManager2::unloadMap(unsigned int pMapId)
+    {
+        if (ManagedMapTree *instanceTree = acquireMapTree(pMapId))
+        {
+            unloadMapTree(pMapId, instanceTree, false);
+            releaseMapTree(instanceTree);
         }
     }
 
     void VMapManager2::unloadMap(unsigned int  pMapId, int x, int y)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        ManagedMapTree *instanceTree = acquireMapTree(pMapId);
+        if (!instanceTree)
+            return;
+
+        bool empty = false;
         {
-            instanceTree->second->UnloadMapTile(x, y, this);
-            if (instanceTree->second->numLoadedTiles() == 0)
+            ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, tilesGuard, instanceTree->tilesLock);
+            if (!instanceTree->detached)
             {
-                delete instanceTree->second;
-                iInstanceMapTrees.erase(pMapId);
+                instanceTree->tree->UnloadMapTile(x, y, this);
+                empty = instanceTree->tree->numLoadedTiles() == 0;
             }
         }
+
+        if (empty)
+            unloadMapTree(pMapId, instanceTree, true);
+        releaseMapTree(instanceTree);
     }
 
     bool VMapManager2::isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2)
     {
         if (!isLineOfSightCalcEnabled()) return true;
         bool result = true;
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        MapTreeReadGuard instanceTree(this, pMapId);
+        if (instanceTree.getTree())
         {
             Vector3 pos1 = convertPositionToInternalRep(x1,y1,z1);
             Vector3 pos2 = convertPositionToInternalRep(x2,y2,z2);
             if (pos1 != pos2)
             {
-                result = instanceTree->second->isInLineOfSight(pos1, pos2);
+                result = instanceTree.getTree()->isInLineOfSight(pos1, pos2);
             }
         }
         return result;
     }
 
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, float x, float y, float z, const float* targets, uint8* results, uint32 count)
+    {
+        MapTreeReadGuard instanceTree(this, pMapId);
+        if (!isLineOfSightCalcEnabled() || !count || !instanceTree.getTree())
+        {
+            for (uint32 i = 0; i < count; ++i)
+                results[i] = true;
+            return;
+        }
+
+        std::vector<Vector3> positions(count);
+        for (uint32 i = 0; i < count; ++i)
+            positions[i] = convertPositionToInternalRep(targets[i*3], targets[i*3+1], targets[i*3+2]);
+        instanceTree.getTree()->isInLineOfSight(convertPositionToInternalRep(x, y, z), &positions[0], results, count);
+    }
+
     /*
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
@@ -175,13 +316,13 @@ namespace VMAP
         rz=z2;
         if (isLineOfSightCalcEnabled())
         {
-            InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-            if (instanceTree != iInstanceMapTrees.end())
+            MapTreeReadGuard instanceTree(this, pMapId);
+            if (instanceTree.getTree())
             {
                 Vector3 pos1 = convertPositionToInternalRep(x1,y1,z1);
                 Vector3 pos2 = convertPositionToInternalRep(x2,y2,z2);
                 Vector3 resultPos;
-                result = instanceTree->second->getObjectHitPos(pos1, pos2, resultPos, pModifyDist);
+                result = instanceTree.getTree()->getObjectHitPos(pos1, pos2, resultPos, pModifyDist);
                 resultPos = convertPositionToBlizzLikeRep(resultPos.x,resultPos.y,resultPos.z);
                 rx = resultPos.x;
                 ry = resultPos.y;
@@ -197,11 +338,11 @@ namespace VMAP
         float height = VMAP_INVALID_HEIGHT_VALUE;           //no height
         if (isHeightCalcEnabled())
         {
-            InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-            if (instanceTree != iInstanceMapTrees.end())
+            MapTreeReadGuard instanceTree(this, pMapId);
+            if (instanceTree.getTree())
             {
                 Vector3 pos = convertPositionToInternalRep(x,y,z);
-                height = instanceTree->second->getHeight(pos, maxSearchDist);
+                height = instanceTree.getTree()->getHeight(pos, maxSearchDist);
                 if (!(height < G3D::inf()))
                 {
                     height = VMAP_INVALID_HEIGHT_VALUE;         //no height
@@ -211,14 +352,35 @@ namespace VMAP
         return height;
     }
 
+    void VMapManager2::getHeights(unsigned int pMapId, const float* positions, float* heights, uint32 count, float maxSearchDist)
+    {
+        MapTreeReadGuard instanceTree(this, pMapId);
+        if (isHeightCalcEnabled() && instanceTree.getTree() && count)
+        {
+            std::vector<Vector3> pos(count);
+            for (uint32 i = 0; i < count; ++i)
+                pos[i] = convertPositionToInternalRep(positions[i*3], positions[i*3+1], positions[i*3+2]);
+            instanceTree.getTree()->getHeights(&pos[0], heights, count, maxSearchDist);
+        }
+        else
+        {
+            for (uint32 i = 0; i < count; ++i)
+                heights[i] = G3D::inf();
+        }
+
+        for (uint32 i = 0; i < count; ++i)
+            if (!(heights[i] < G3D::inf()))
+                heights[i] = VMAP_INVALID_HEIGHT_VALUE;         //no height
+    }
+
     bool VMapManager2::getAreaInfo(unsigned int pMapId, float x, float y, float &z, uint32 &flags, int32 &adtId, int32 &rootId, int32 &groupId) const
     {
         bool result=false;
-        InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        MapTreeReadGuard instanceTree(this, pMapId);
+        if (instanceTree.getTree())
         {
             Vector3 pos = convertPositionToInternalRep(x, y, z);
-            result = instanceTree->second->getAreaInfo(pos, flags, adtId, rootId, groupId);
+            result = instanceTree.getTree()->getAreaInfo(pos, flags, adtId, rootId, groupId);
             // z is not touched by convertPositionToBlizzLikeRep(), so just copy
             z = pos.z;
         }
@@ -227,12 +389,12 @@ namespace VMAP
 
     bool VMapManager2::GetLiquidLevel(uint32 pMapId, float x, float y, float z, uint8 ReqLiquidType, float &level, float &floor, uint32 &type) const
     {
-        InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        MapTreeReadGuard instanceTree(this, pMapId);
+        if (instanceTree.getTree())
         {
             LocationInfo info;
             Vector3 pos = convertPositionToInternalRep(x, y, z);
-            if (instanceTree->second->GetLocationInfo(pos, info))
+            if (instanceTree.getTree()->GetLocationInfo(pos, info))
             {
                 floor = info.ground_Z;
                 type = info.hitModel->GetLiquidType();
@@ -247,19 +409,57 @@ namespace VMAP
 
     WorldModel* VMapManager2::acquireModelInstance(const std::string &basepath, const std::string &filename)
     {
-        ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
         {
-            WorldModel *worldmodel = new WorldModel();
-            if (!worldmodel->readFile(basepath + filename + ".vmo"))
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, iLoadedModelFilesLock, NULL);
+            ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
+            if (model != iLoadedModelFiles.end())
             {
-                ERROR_LOG("VMapManager2: could not load '%s%s.vmo'!", basepath.c_str(), filename.c_str());
-                delete worldmodel;
-                return NULL;
+                model->second.incRefCount();
+                return model->second.getModel();
             }
+        }
+
+        // read without the lock, tiles of other maps may want other models meanwhile
+        std::string fullname = basepath + filename + ".vmo";
+        WorldModel *worldmodel = new WorldModel();
+
+        // flat models are used in place, older ones are read into memory
+        bool loaded;
+        ACE_Mem_Map *mapping = new ACE_Mem_Map();
+        bool mapped = mapping->map(fullname.c_str(), size_t(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) == 0;
+        if (mapped)
+            mapping->close_handle();                        // the view stays valid, don't hold an fd per model
+        if (mapped && WorldModel::isFlatData((const char*)mapping->addr(), mapping->size()))
+            loaded = worldmodel->readFlatData((const char*)mapping->addr(), mapping->size());
+        else
+        {
+            delete mapping;
+            mapping = NULL;
+            loaded = worldmodel->readFile(fullname);
+        }
+
+        if (!loaded)
+        {
+            ERROR_LOG("VMapManager2: could not load '%s'!", fullname.c_str());
+            delete worldmodel;
+            delete mapping;
+            return NULL;
+        }
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, iLoadedModelFilesLock, NULL);
+        ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
+        if (model == iLoadedModelFiles.end())
+        {
             DEBUG_LOG("VMapManager2: loading file '%s%s'.", basepath.c_str(), filename.c_str());
             model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
             model->second.setModel(worldmodel);
+            model->second.setMapping(mapping);
+        }
+        else
+        {
+            // another thread was faster
+            delete worldmodel;
+            delete mapping;
         }
         model->second.incRefCount();
         return model->second.getModel();
@@ -267,6 +467,8 @@ namespace VMAP
 
     void VMapManager2::releaseModelInstance(const std::string &filename)
     {
+        ACE_GUARD(ACE_Thread_Mutex, guard, iLoadedModelFilesLock);
+
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
@@ -277,6 +479,7 @@ namespace VMAP
         {
             DEBUG_LOG("VMapManager2: unloading file '%s'", filename.c_str());
             delete model->second.getModel();
+            delete model->second.getMapping();
             iLoadedModelFiles.erase(model);
         }
     }
@@ -11,10 +11,16 @@
 #include "Platform/Define.h"
 #include <G3D/Vector3.h>
 
+#include <ace/RW_Thread_Mutex.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+
 #define MAP_FILENAME_EXTENSION2 ".vmtree"
 
 #define FILENAMEBUFFER_SIZE 500
 
+class ACE_Mem_Map;
+
 /*
 This is the main Class to manage loading and unloading of maps, line of sight, height calculation and so on.
 For each map or map tile to load it reads a directory file that contains the ModelContainer files used by this map or map tile.
@@ -31,17 +37,35 @@ namespace VMAP
     class ManagedModel
     {
         public:
-            ManagedModel(): iModel(0), iRefCount(0) {}
+            ManagedModel(): iModel(0), iMapping(0), iRefCount(0) {}
             void setModel(WorldModel *model) { iModel = model; }
             WorldModel *getModel() { return iModel; }
+            // the file a flat model points into
+            void setMapping(ACE_Mem_Map *mapping) { iMapping = mapping; }
+            ACE_Mem_Map *getMapping() { return iMapping; }
             void incRefCount() { ++iRefCount; }
             int decRefCount() { return --iRefCount; }
         protected:
             WorldModel *iModel;
+            ACE_Mem_Map *iMapping;
             int iRefCount;
     };
 
+    // the tree of one map; its tiles are loaded and unloaded under the write
+    // lock and queries hold the read lock, so maps do not wait for each other.
+    // The table holds one reference, users found it there hold one each; once
+    // detached from the table it is empty and goes away with the last reference
+    struct ManagedMapTree
+    {
+        explicit ManagedMapTree(StaticMapTree *mapTree): tree(mapTree), refCount(1), detached(false) {}
+        StaticMapTree *tree;
+        ACE_RW_Thread_Mutex tilesLock;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> refCount;
+        bool detached;                                      // under tilesLock
+    };
+
     typedef UNORDERED_MAP<uint32 , StaticMapTree *> InstanceTreeMap;
+    typedef UNORDERED_MAP<uint32, ManagedMapTree *> ManagedMapTreeMap;
     typedef UNORDERED_MAP<std::string, ManagedModel> ModelFileMap;
 
     class VMapManager2 : public IVMapManager
@@ -49,10 +73,21 @@ namespace VMAP
         protected:
             // Tree to check collision
             ModelFileMap iLoadedModelFiles;
-            InstanceTreeMap iInstanceMapTrees;
+            ACE_Thread_Mutex iLoadedModelFilesLock;
+            // written only when a map gets its first or loses its last tile,
+            // read locked only to find a tree, never across its tiles
+            ManagedMapTreeMap iInstanceMapTrees;
+            mutable ACE_RW_Thread_Mutex iInstanceMapTreesLock;
             UNORDERED_MAP<unsigned int , bool> iIgnoreMapIds;
 
+            class MapTreeReadGuard;
+            friend class MapTreeReadGuard;
+
             bool _loadMap(uint32 pMapId, const std::string &basePath, uint32 tileX, uint32 tileY);
+            ManagedMapTree* acquireMapTree(uint32 pMapId) const;
+            static void releaseMapTree(ManagedMapTree *mapTree);
+            void detachMapTree(uint32 pMapId, ManagedMapTree *mapTree);
+            void unloadMapTree(uint32 pMapId, ManagedMapTree *mapTree, bool onlyEmpty);
             /* void _unloadMap(uint32 pMapId, uint32 x, uint32 y); */
 
         public:
@@ -73,6 +108,8 @@ namespace VMAP
             // fill the hit pos and return true, if an object was hit
             bool getObjectHitPos(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float pModifyDist);
             float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist);
+            void isInLineOfSight(unsigned int pMapId, float x, float y, float z, const float* targets, uint8* results, uint32 count);
+            void getHeights(unsigned int pMapId, const float* positions, float* heights, uint32 count, float maxSearchDist);
 
             bool processCommand(char * /*pCommand*/) { return false; }      // for debug and extensions
 
@@ -17,7 +17,7 @@ template<> struct BoundsTrait<VMAP::GroupModel>
 
 namespace VMAP
 {
-    bool IntersectTriangle(const MeshTriangle &tri, std::vector<Vector3>::const_iterator points, const G3D::Ray &ray, float &distance)
+    bool IntersectTriangle(const MeshTriangle &tri, const Vector3 *points, const G3D::Ray &ray, float &distance)
     {
         static const float EPS = 1e-5f;
 
@@ -67,6 +67,76 @@ namespace VMAP
         return false;
     }
 
+    // IntersectTriangle for the lanes of mask, returns the lanes with a new closest hit
+    uint32 IntersectTrianglePacket(const MeshTriangle &tri, const Vector3 *points, RayPacket &packet, uint32 mask)
+    {
+#ifdef BIH_PACKET_SSE
+        const Vector3 &p0 = points[tri.idx0];
+        const Vector3 e1 = points[tri.idx1] - p0;
+        const Vector3 e2 = points[tri.idx2] - p0;
+
+        const __m128 dx = _mm_loadu_ps(packet.dir[0]);
+        const __m128 dy = _mm_loadu_ps(packet.dir[1]);
+        const __m128 dz = _mm_loadu_ps(packet.dir[2]);
+        const __m128 e1x = _mm_set1_ps(e1.x), e1y = _mm_set1_ps(e1.y), e1z = _mm_set1_ps(e1.z);
+        const __m128 e2x = _mm_set1_ps(e2.x), e2y = _mm_set1_ps(e2.y), e2z = _mm_set1_ps(e2.z);
+
+        // p = dir x e2, a = e1 . p
+        const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        const __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        const __m128 f = _mm_div_ps(_mm_set1_ps(1.0f), a);
+
+        // s = origin - p0, u = f * s . p
+        const __m128 sx = _mm_sub_ps(_mm_loadu_ps(packet.org[0]), _mm_set1_ps(p0.x));
+        const __m128 sy = _mm_sub_ps(_mm_loadu_ps(packet.org[1]), _mm_set1_ps(p0.y));
+        const __m128 sz = _mm_sub_ps(_mm_loadu_ps(packet.org[2]), _mm_set1_ps(p0.z));
+        const __m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)));
+
+        // q = s x e1, v = f * dir . q, t = f * e2 . q
+        const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        const __m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+        const __m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+
+        // |a| >= EPS, 0 <= u <= 1, v >= 0, u + v <= 1, 0 < t < maxDist
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 absA = _mm_max_ps(a, _mm_sub_ps(zero, a));
+        __m128 valid = _mm_cmpge_ps(absA, _mm_set1_ps(1e-5f));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(u, one));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(v, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        valid = _mm_and_ps(valid, _mm_cmpgt_ps(t, zero));
+        valid = _mm_and_ps(valid, _mm_cmplt_ps(t, _mm_loadu_ps(packet.maxDist)));
+
+        uint32 hits = uint32(_mm_movemask_ps(valid)) & mask;
+        if (hits)
+        {
+            float dist[RAY_PACKET_SIZE];
+            _mm_storeu_ps(dist, t);
+            for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+                if (hits & (1 << lane))
+                    packet.maxDist[lane] = dist[lane];
+        }
+        return hits;
+#else
+        uint32 hits = 0;
+        for (uint32 lane=0; lane<RAY_PACKET_SIZE; ++lane)
+        {
+            if (!(mask & (1 << lane)))
+                continue;
+            G3D::Ray ray = G3D::Ray::fromOriginAndDirection(packet.origin(lane), packet.direction(lane));
+            if (IntersectTriangle(tri, points, ray, packet.maxDist[lane]))
+                hits |= 1 << lane;
+        }
+        return hits;
+#endif
+    }
+
     class TriBoundFunc
     {
         public:
@@ -85,6 +155,53 @@ namespace VMAP
             const std::vector<Vector3>::const_iterator vertices;
     };
 
+    // appends size bytes at the next 4 byte boundary, returns their offset
+    static uint32 appendFlat(std::vector<char> &data, const void *src, uint32 size)
+    {
+        data.resize((data.size() + 3) & ~size_t(3));
+        uint32 offset = data.size();
+        if (size)
+        {
+            data.resize(offset + size);
+            memcpy(&data[offset], src, size);
+        }
+        return offset;
+    }
+
+    // count elements at offset, 0 if they are not inside the data
+    template<class T>
+    static const T* getFlat(const char *data, uint32 size, uint32 offset, uint32 count)
+    {
+        if ((offset & 3) || offset > size || count > (size - offset) / sizeof(T))
+            return 0;
+        return reinterpret_cast<const T*>(data + offset);
+    }
+
+    static void writeFlatTree(std::vector<char> &data, const BIH &tree, FlatTree &flat)
+    {
+        const G3D::AABox &bound = tree.getBounds();
+        for (int i = 0; i < 3; ++i)
+        {
+            flat.low[i] = bound.low()[i];
+            flat.high[i] = bound.high()[i];
+        }
+        flat.treeSize = tree.getTreeSize();
+        flat.treeOffset = appendFlat(data, tree.getTreeData(), flat.treeSize * sizeof(uint32));
+        flat.objectCount = tree.getObjectCount();
+        flat.objectsOffset = appendFlat(data, tree.getObjectData(), flat.objectCount * sizeof(uint32));
+    }
+
+    static bool readFlatTree(const char *data, uint32 size, const FlatTree &flat, BIH &tree)
+    {
+        const uint32 *nodes = getFlat<uint32>(data, size, flat.treeOffset, flat.treeSize);
+        const uint32 *objects = getFlat<uint32>(data, size, flat.objectsOffset, flat.objectCount);
+        if (!nodes || !objects)
+            return false;
+        G3D::AABox bound(Vector3(flat.low[0], flat.low[1], flat.low[2]), Vector3(flat.high[0], flat.high[1], flat.high[2]));
+        tree.setMappedData(bound, nodes, flat.treeSize, objects, flat.objectCount);
+        return true;
+    }
+
     WmoLiquid::WmoLiquid(uint32 width, uint32 height, const Vector3 &corner, uint32 type):
         iTilesX(width), iTilesY(height), iCorner(corner), iType(type)
     {
@@ -224,18 +341,71 @@ namespace VMAP
         return result;
     }
 
+    uint32 WmoLiquid::writeFlatData(std::vector<char> &data) const
+    {
+        FlatLiquid flat;
+        flat.tilesX = iTilesX;
+        flat.tilesY = iTilesY;
+        flat.corner[0] = iCorner.x;
+        flat.corner[1] = iCorner.y;
+        flat.corner[2] = iCorner.z;
+        flat.type = iType;
+        uint32 offset = appendFlat(data, &flat, sizeof(FlatLiquid));
+        appendFlat(data, iHeight, (iTilesX + 1)*(iTilesY + 1) * sizeof(float));
+        appendFlat(data, iFlags, iTilesX * iTilesY);
+        return offset;
+    }
+
+    bool WmoLiquid::readFlatData(const char *data, uint32 size, uint32 offset, WmoLiquid *&liquid)
+    {
+        const FlatLiquid *flat = getFlat<FlatLiquid>(data, size, offset, 1);
+        if (!flat || flat->tilesX > 0xFFFF || flat->tilesY > 0xFFFF)
+            return false;
+        uint32 heightsOffset = offset + sizeof(FlatLiquid);
+        uint32 heightCount = (flat->tilesX + 1)*(flat->tilesY + 1);
+        const float *heights = getFlat<float>(data, size, heightsOffset, heightCount);
+        const uint8 *flags = heights ? getFlat<uint8>(data, size, heightsOffset + heightCount * sizeof(float), flat->tilesX * flat->tilesY) : 0;
+        if (!flags)
+            return false;
+
+        // small enough to be copied, unlike the mesh
+        liquid = new WmoLiquid(flat->tilesX, flat->tilesY, Vector3(flat->corner[0], flat->corner[1], flat->corner[2]), flat->type);
+        memcpy(liquid->iHeight, heights, heightCount * sizeof(float));
+        memcpy(liquid->iFlags, flags, flat->tilesX * flat->tilesY);
+        return true;
+    }
+
     GroupModel::GroupModel(const GroupModel &other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
         vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(0)
     {
+        // a mapped model has no own arrays, the copy uses the same file
+        if (vertices.empty() && triangles.empty())
+        {
+            iVertexData = other.iVertexData;
+            iNVertices = other.iNVertices;
+            iTriangleData = other.iTriangleData;
+            iNTriangles = other.iNTriangles;
+        }
+        else
+            useOwnData();
         if (other.iLiquid)
             iLiquid = new WmoLiquid(*other.iLiquid);
     }
 
+    void GroupModel::useOwnData()
+    {
+        iVertexData = vertices.empty() ? 0 : &vertices[0];
+        iNVertices = vertices.size();
+        iTriangleData = triangles.empty() ? 0 : &triangles[0];
+        iNTriangles = triangles.size();
+    }
+
     void GroupModel::setMeshData(std::vector<Vector3> &vert, std::vector<MeshTriangle> &tri)
     {
         vertices.swap(vert);
         triangles.swap(tri);
+        useOwnData();
         TriBoundFunc bFunc(vertices);
         meshTree.build(triangles, bFunc);
     }
@@ -251,21 +421,21 @@ namespace VMAP
 
         // write vertices
         if (result && fwrite("VERT", 1, 4, wf) != 4) result = false;
-        count = vertices.size();
+        count = iNVertices;
         chunkSize = sizeof(uint32)+ sizeof(Vector3)*count;
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
         if (!count) // models without (collision) geometry end here, unsure if they are useful
             return result;
-        if (result && fwrite(&vertices[0], sizeof(Vector3), count, wf) != count) result = false;
+        if (result && fwrite(iVertexData, sizeof(Vector3), count, wf) != count) result = false;
 
         // write triangle mesh
         if (result && fwrite("TRIM", 1, 4, wf) != 4) result = false;
-        count = triangles.size();
+        count = iNTriangles;
         chunkSize = sizeof(uint32)+ sizeof(MeshTriangle)*count;
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
-        if (result && fwrite(&triangles[0], sizeof(MeshTriangle), count, wf) != count) result = false;
+        if (result && fwrite(iTriangleData, sizeof(MeshTriangle), count, wf) != count) result = false;
 
         // write mesh BIH
         if (result && fwrite("MBIH", 1, 4, wf) != 4) result = false;
@@ -293,6 +463,7 @@ namespace VMAP
         uint32 chunkSize, count;
         triangles.clear();
         vertices.clear();
+        useOwnData();
         delete iLiquid;
         iLiquid = 0;
 
@@ -315,6 +486,7 @@ namespace VMAP
         if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
         if (result) triangles.resize(count);
         if (result && fread(&triangles[0], sizeof(MeshTriangle), count, rf) != count) result = false;
+        useOwnData();
 
         // read mesh BIH
         if (result && !readChunk(rf, chunk, "MBIH", 4)) result = false;
@@ -328,35 +500,101 @@ namespace VMAP
         return result;
     }
 
+    void GroupModel::writeFlatData(std::vector<char> &data, FlatGroup &group) const
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            group.low[i] = iBound.low()[i];
+            group.high[i] = iBound.high()[i];
+        }
+        group.mogpFlags = iMogpFlags;
+        group.groupWMOID = iGroupWMOID;
+        group.vertexCount = iNVertices;
+        group.verticesOffset = appendFlat(data, iVertexData, iNVertices * sizeof(Vector3));
+        group.triangleCount = iNTriangles;
+        group.trianglesOffset = appendFlat(data, iTriangleData, iNTriangles * sizeof(MeshTriangle));
+        writeFlatTree(data, meshTree, group.meshTree);
+        group.liquidOffset = iLiquid ? iLiquid->writeFlatData(data) : 0;
+    }
+
+    bool GroupModel::readFlatData(const char *data, uint32 size, const FlatGroup &group)
+    {
+        triangles.clear();
+        vertices.clear();
+        delete iLiquid;
+        iLiquid = 0;
+
+        iBound = G3D::AABox(Vector3(group.low[0], group.low[1], group.low[2]), Vector3(group.high[0], group.high[1], group.high[2]));
+        iMogpFlags = group.mogpFlags;
+        iGroupWMOID = group.groupWMOID;
+
+        iVertexData = getFlat<Vector3>(data, size, group.verticesOffset, group.vertexCount);
+        iTriangleData = getFlat<MeshTriangle>(data, size, group.trianglesOffset, group.triangleCount);
+        if (!iVertexData || !iTriangleData)
+        {
+            useOwnData();
+            return false;
+        }
+        iNVertices = group.vertexCount;
+        iNTriangles = group.triangleCount;
+
+        if (!readFlatTree(data, size, group.meshTree, meshTree))
+            return false;
+
+        if (group.liquidOffset)
+            return WmoLiquid::readFlatData(data, size, group.liquidOffset, iLiquid);
+        return true;
+    }
+
     struct GModelRayCallback
     {
-        GModelRayCallback(const std::vector<MeshTriangle> &tris, const std::vector<Vector3> &vert):
-            vertices(vert.begin()), triangles(tris.begin()), hit(false) {}
+        GModelRayCallback(const MeshTriangle *tris, const Vector3 *vert):
+            vertices(vert), triangles(tris), hit(false) {}
         bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool pStopAtFirstHit)
         {
             bool result = IntersectTriangle(triangles[entry], vertices, ray, distance);
             if (result)  hit=true;
             return hit;
         }
-        std::vector<Vector3>::const_iterator vertices;
-        std::vector<MeshTriangle>::const_iterator triangles;
+        const Vector3 *vertices;
+        const MeshTriangle *triangles;
         bool hit;
     };
 
     bool GroupModel::IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const
     {
-        if (!triangles.size())
+        if (!iNTriangles)
             return false;
-        GModelRayCallback callback(triangles, vertices);
+        GModelRayCallback callback(iTriangleData, iVertexData);
         meshTree.intersectRay(ray, callback, distance, stopAtFirstHit);
         return callback.hit;
     }
 
+    struct GModelPacketCallback
+    {
+        GModelPacketCallback(const MeshTriangle *tris, const Vector3 *vert):
+            vertices(vert), triangles(tris) {}
+        uint32 operator()(RayPacket &packet, uint32 entry, uint32 mask, bool /*pStopAtFirstHit*/)
+        {
+            return IntersectTrianglePacket(triangles[entry], vertices, packet, mask);
+        }
+        const Vector3 *vertices;
+        const MeshTriangle *triangles;
+    };
+
+    uint32 GroupModel::IntersectRayPacket(RayPacket &packet, uint32 mask, bool stopAtFirstHit) const
+    {
+        if (!iNTriangles)
+            return 0;
+        GModelPacketCallback callback(iTriangleData, iVertexData);
+        return meshTree.intersectRayPacket(packet, callback, mask, stopAtFirstHit);
+    }
+
     bool GroupModel::IsInsideObject(const Vector3 &pos, const Vector3 &down, float &z_dist) const
     {
-        if (!triangles.size() || !iBound.contains(pos))
+        if (!iNTriangles || !iBound.contains(pos))
             return false;
-        GModelRayCallback callback(triangles, vertices);
+        GModelRayCallback callback(iTriangleData, iVertexData);
         Vector3 rPos = pos - 0.1f * down;
         float dist = G3D::inf();
         G3D::Ray ray(rPos, down);
@@ -412,6 +650,26 @@ namespace VMAP
         return isc.hit;
     }
 
+    struct WModelPacketCallback
+    {
+        WModelPacketCallback(const std::vector<GroupModel> &mod): models(mod.begin()) {}
+        uint32 operator()(RayPacket &packet, uint32 entry, uint32 mask, bool pStopAtFirstHit)
+        {
+            return models[entry].IntersectRayPacket(packet, mask, pStopAtFirstHit);
+        }
+        std::vector<GroupModel>::const_iterator models;
+    };
+
+    uint32 WorldModel::IntersectRayPacket(RayPacket &packet, uint32 mask, bool stopAtFirstHit) const
+    {
+        // same M2 workaround as IntersectRay
+        if (groupModels.size() == 1)
+            return groupModels[0].IntersectRayPacket(packet, mask, stopAtFirstHit);
+
+        WModelPacketCallback isc(groupModels);
+        return groupTree.intersectRayPacket(packet, isc, mask, stopAtFirstHit);
+    }
+
     class WModelAreaCallback {
         public:
             WModelAreaCallback(const std::vector<GroupModel> &vals, const Vector3 &down):
@@ -515,6 +773,57 @@ namespace VMAP
         return result;
     }
 
+    bool WorldModel::writeFlatFile(const std::string &filename)
+    {
+        FlatModelHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, VMAP_FLAT_MAGIC, 8);
+        header.rootWMOID = RootWMOID;
+
+        std::vector<char> data(sizeof(FlatModelHeader));
+        std::vector<FlatGroup> groups(groupModels.size());
+        for (uint32 i = 0; i < groupModels.size(); ++i)
+            groupModels[i].writeFlatData(data, groups[i]);
+
+        header.groupCount = groups.size();
+        header.groupsOffset = appendFlat(data, groups.empty() ? 0 : &groups[0], groups.size() * sizeof(FlatGroup));
+        writeFlatTree(data, groupTree, header.groupTree);
+        memcpy(&data[0], &header, sizeof(header));
+
+        FILE *wf = fopen(filename.c_str(), "wb");
+        if (!wf)
+            return false;
+
+        bool result = fwrite(&data[0], 1, data.size(), wf) == data.size();
+        fclose(wf);
+        return result;
+    }
+
+    bool WorldModel::isFlatData(const char *data, uint32 size)
+    {
+        return size >= sizeof(FlatModelHeader) && memcmp(data, VMAP_FLAT_MAGIC, 8) == 0;
+    }
+
+    bool WorldModel::readFlatData(const char *data, uint32 size)
+    {
+        if (!isFlatData(data, size))
+            return false;
+
+        const FlatModelHeader *header = getFlat<FlatModelHeader>(data, size, 0, 1);
+        const FlatGroup *groups = getFlat<FlatGroup>(data, size, header->groupsOffset, header->groupCount);
+        if (!groups)
+            return false;
+
+        RootWMOID = header->rootWMOID;
+        groupModels.clear();
+        groupModels.resize(header->groupCount);
+        for (uint32 i = 0; i < header->groupCount; ++i)
+            if (!groupModels[i].readFlatData(data, size, groups[i]))
+                return false;
+
+        return readFlatTree(data, size, header->groupTree, groupTree);
+    }
+
     bool WorldModel::readFile(const std::string &filename)
     {
         FILE *rf = fopen(filename.c_str(), "rb");
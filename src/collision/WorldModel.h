@@ -31,6 +31,52 @@ namespace VMAP
             uint32 idx2;
     };
 
+    /* Flat model file, used in place when mapped: a header, the group
+       table and the arrays, all addressed by offsets from the file start
+       and aligned to 4 bytes. vmap_assembler writes it under the .vmo
+       name, the older format is still read by WorldModel::readFile. */
+    struct FlatTree
+    {
+        float low[3];
+        float high[3];
+        uint32 treeOffset;
+        uint32 treeSize;
+        uint32 objectsOffset;
+        uint32 objectCount;
+    };
+
+    struct FlatGroup
+    {
+        float low[3];
+        float high[3];
+        uint32 mogpFlags;
+        uint32 groupWMOID;
+        uint32 verticesOffset;
+        uint32 vertexCount;
+        uint32 trianglesOffset;
+        uint32 triangleCount;
+        FlatTree meshTree;
+        uint32 liquidOffset;                                // 0 without liquid
+    };
+
+    // followed by (tilesX + 1) * (tilesY + 1) heights and tilesX * tilesY flags
+    struct FlatLiquid
+    {
+        uint32 tilesX;
+        uint32 tilesY;
+        float corner[3];
+        uint32 type;
+    };
+
+    struct FlatModelHeader
+    {
+        char magic[8];
+        uint32 rootWMOID;
+        uint32 groupsOffset;
+        uint32 groupCount;
+        FlatTree groupTree;
+    };
+
     class WmoLiquid
     {
         public:
@@ -45,6 +91,8 @@ namespace VMAP
             uint32 GetFileSize();
             bool writeToFile(FILE *wf);
             static bool readFromFile(FILE *rf, WmoLiquid *&liquid);
+            uint32 writeFlatData(std::vector<char> &data) const;
+            static bool readFlatData(const char *data, uint32 size, uint32 offset, WmoLiquid *&liquid);
         private:
             WmoLiquid(): iHeight(0), iFlags(0) {};
             uint32 iTilesX;  //!< number of tiles in x direction, each
@@ -64,21 +112,25 @@ namespace VMAP
     class GroupModel
     {
         public:
-            GroupModel(): iLiquid(0) {}
+            GroupModel(): iVertexData(0), iNVertices(0), iTriangleData(0), iNTriangles(0), iLiquid(0) {}
             GroupModel(const GroupModel &other);
             GroupModel(uint32 mogpFlags, uint32 groupWMOID, const AABox &bound):
-                        iBound(bound), iMogpFlags(mogpFlags), iGroupWMOID(groupWMOID), iLiquid(0) {}
+                        iBound(bound), iMogpFlags(mogpFlags), iGroupWMOID(groupWMOID),
+                        iVertexData(0), iNVertices(0), iTriangleData(0), iNTriangles(0), iLiquid(0) {}
             ~GroupModel() { delete iLiquid; }
 
             // pass mesh data to object and create BIH. Passed vectors get get swapped with old geometry.
             void setMeshData(std::vector<Vector3> &vert, std::vector<MeshTriangle> &tri);
             void setLiquidData(WmoLiquid *liquid) { iLiquid = liquid; }
             bool IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const;
+            uint32 IntersectRayPacket(RayPacket &packet, uint32 mask, bool stopAtFirstHit) const;
             bool IsInsideObject(const Vector3 &pos, const Vector3 &down, float &z_dist) const;
             bool GetLiquidLevel(const Vector3 &pos, float &liqHeight) const;
             uint32 GetLiquidType() const;
             bool writeToFile(FILE *wf);
             bool readFromFile(FILE *rf);
+            void writeFlatData(std::vector<char> &data, FlatGroup &group) const;
+            bool readFlatData(const char *data, uint32 size, const FlatGroup &group);
             const G3D::AABox& GetBound() const { return iBound; }
             uint32 GetMogpFlags() const { return iMogpFlags; }
             uint32 GetWmoID() const { return iGroupWMOID; }
@@ -88,9 +140,16 @@ namespace VMAP
             uint32 iGroupWMOID;
             std::vector<Vector3> vertices;
             std::vector<MeshTriangle> triangles;
+            // what the queries read, the vectors above or a mapped model file
+            const Vector3 *iVertexData;
+            uint32 iNVertices;
+            const MeshTriangle *iTriangleData;
+            uint32 iNTriangles;
             BIH meshTree;
             WmoLiquid *iLiquid;
 
+            void useOwnData();
+
 #ifdef MMAP_GENERATOR
         public:
             void getMeshData(std::vector<Vector3> &vertices, std::vector<MeshTriangle> &triangles, WmoLiquid* &liquid);
@@ -106,10 +165,15 @@ namespace VMAP
             void setGroupModels(std::vector<GroupModel> &models);
             void setRootWmoID(uint32 id) { RootWMOID = id; }
             bool IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const;
+            uint32 IntersectRayPacket(RayPacket &packet, uint32 mask, bool stopAtFirstHit) const;
             bool IntersectPoint(const G3D::Vector3 &p, const G3D::Vector3 &down, float &dist, AreaInfo &info) const;
             bool GetLocationInfo(const G3D::Vector3 &p, const G3D::Vector3 &down, float &dist, LocationInfo &info) const;
             bool writeFile(const std::string &filename);
             bool readFile(const std::string &filename);
+            bool writeFlatFile(const std::string &filename);
+            // data has to stay valid as long as the model is used
+            bool readFlatData(const char *data, uint32 size);
+            static bool isFlatData(const char *data, uint32 size);
         protected:
             uint32 RootWMOID;
             std::vector<GroupModel> groupModels;
@@ -5,29 +5,143 @@
 
 #include "EventProcessor.h"
 
+#include <cstring>
+
+// milliseconds covered by the whole wheel, later events wait in the last slot of the top level
+#define EVENT_WHEEL_SPAN        (uint64(1) << (EVENT_WHEEL_LEVELS * EVENT_WHEEL_SLOT_BITS))
+// an empty wheel is kept this long, events often come again soon after the last one ran
+#define EVENT_WHEEL_KEEP_TIME   60000
+
+namespace
+{
+    // lowest set bit at or above from, EVENT_WHEEL_SLOTS if there is none
+    inline uint32 NextUsedSlot(uint32 used, uint32 from)
+    {
+        used &= ~((uint32(1) << from) - 1);
+        if (!used)
+            return EVENT_WHEEL_SLOTS;
+
+#if defined(__GNUC__)
+        return __builtin_ctz(used);
+#else
+        uint32 slot = from;
+        while (!(used & (uint32(1) << slot)))
+            ++slot;
+        return slot;
+#endif
+    }
+
+    inline uint32 SlotIndex(uint64 time, uint32 level)
+    {
+        return uint32(time >> (level * EVENT_WHEEL_SLOT_BITS)) & EVENT_WHEEL_SLOT_MASK;
+    }
+}
+
+EventWheel::EventWheel()
+{
+    memset(slots, 0, sizeof(slots));
+    memset(used, 0, sizeof(used));
+}
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
     m_aborting = false;
+    m_wheel = NULL;
+    m_wheelTime = 0;
+    m_count = 0;
+    m_emptyTime = 0;
 }
 
 EventProcessor::~EventProcessor()
 {
     KillAllEvents(true);
+    delete m_wheel;
 }
 
-void EventProcessor::Update(uint32 p_time)
+void EventProcessor::Link(BasicEvent* Event)
 {
-    // update time
-    m_time += p_time;
+    // events of the past run with the next millisecond
+    uint64 time = Event->m_execTime > m_wheelTime ? Event->m_execTime : m_wheelTime;
+    uint64 delta = time - m_wheelTime;
 
-    // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    if (delta >= EVENT_WHEEL_SPAN)
+    {
+        time = m_wheelTime + EVENT_WHEEL_SPAN - 1;
+        delta = EVENT_WHEEL_SPAN - 1;
+    }
+
+    uint32 level = 0;
+    while (delta >= (uint64(1) << ((level + 1) * EVENT_WHEEL_SLOT_BITS)))
+        ++level;
+
+    uint32 index = SlotIndex(time, level);
+    EventWheel::Slot& slot = m_wheel->slots[level][index];
+
+    Event->m_wheelSlot = level * EVENT_WHEEL_SLOTS + index;
+    Event->m_wheelNext = NULL;
+    Event->m_wheelPrev = slot.tail;
+    if (slot.tail)
+        slot.tail->m_wheelNext = Event;
+    else
+        slot.head = Event;
+    slot.tail = Event;
+
+    m_wheel->used[level] |= uint32(1) << index;
+}
+
+void EventProcessor::Unlink(BasicEvent* Event)
+{
+    uint32 level = Event->m_wheelSlot / EVENT_WHEEL_SLOTS;
+    uint32 index = Event->m_wheelSlot % EVENT_WHEEL_SLOTS;
+    EventWheel::Slot& slot = m_wheel->slots[level][index];
+
+    if (Event->m_wheelPrev)
+        Event->m_wheelPrev->m_wheelNext = Event->m_wheelNext;
+    else
+        slot.head = Event->m_wheelNext;
+
+    if (Event->m_wheelNext)
+        Event->m_wheelNext->m_wheelPrev = Event->m_wheelPrev;
+    else
+        slot.tail = Event->m_wheelPrev;
+
+    Event->m_wheelNext = NULL;
+    Event->m_wheelPrev = NULL;
+
+    if (!slot.head)
+        m_wheel->used[level] &= ~(uint32(1) << index);
+}
+
+void EventProcessor::Cascade(uint32 level)
+{
+    uint32 index = SlotIndex(m_wheelTime, level);
+    EventWheel::Slot& slot = m_wheel->slots[level][index];
+
+    BasicEvent* Event = slot.head;
+    slot.head = NULL;
+    slot.tail = NULL;
+    m_wheel->used[level] &= ~(uint32(1) << index);
+
+    // placed again relative to the current time, they go at least one level down
+    while (Event)
+    {
+        BasicEvent* next = Event->m_wheelNext;
+        Link(Event);
+        Event = next;
+    }
+}
+
+void EventProcessor::RunSlot(uint32 index, uint32 p_time)
+{
+    EventWheel::Slot& slot = m_wheel->slots[0][index];
+
+    // events re-added for the current time land at the tail and still run now
+    while (BasicEvent* Event = slot.head)
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        Unlink(Event);
+        --m_count;
 
         if (!Event->to_Abort)
         {
@@ -45,42 +159,121 @@ void EventProcessor::Update(uint32 p_time)
     }
 }
 
+void EventProcessor::Update(uint32 p_time)
+{
+    // update time
+    m_time += p_time;
+
+    // main event loop
+    while (m_wheelTime <= m_time)
+    {
+        if (!m_count)
+        {
+            m_wheelTime = m_time + 1;
+            break;
+        }
+
+        uint32 index = SlotIndex(m_wheelTime, 0);
+
+        // bring down the events of the next span of each level that wrapped
+        if (!index)
+        {
+            for (uint32 level = 1; level < EVENT_WHEEL_LEVELS; ++level)
+            {
+                Cascade(level);
+                if (SlotIndex(m_wheelTime, level))
+                    break;
+            }
+        }
+
+        // skip empty milliseconds up to the next used slot or the next cascade
+        uint32 next = NextUsedSlot(m_wheel->used[0], index);
+        if (next != index)
+        {
+            // never past the current time, later insertions would be delayed
+            m_wheelTime += next - index;
+            if (m_wheelTime > m_time)
+                m_wheelTime = m_time + 1;
+            continue;
+        }
+
+        RunSlot(index, p_time);
+        ++m_wheelTime;
+    }
+
+    // not inside RunSlot, an event may kill all events while its slot is walked
+    if (m_wheel)
+    {
+        if (m_count)
+            m_emptyTime = 0;
+        else if ((m_emptyTime += p_time) >= EVENT_WHEEL_KEEP_TIME)
+        {
+            delete m_wheel;
+            m_wheel = NULL;
+            m_emptyTime = 0;
+        }
+    }
+}
+
 void EventProcessor::KillAllEvents(bool force)
 {
     // prevent event insertions
     m_aborting = true;
 
+    if (!m_wheel)
+        return;
+
     // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
     {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+        for (uint32 index = 0; index < EVENT_WHEEL_SLOTS; ++index)
         {
-            delete i_old->second;
+            BasicEvent* Event = m_wheel->slots[level][index].head;
+            while (Event)
+            {
+                BasicEvent* next = Event->m_wheelNext;
+
+                Event->to_Abort = true;
+                Event->Abort(m_time);
+                if (force || Event->IsDeletable())
+                {
+                    if (!force)                             // need per-element cleanup
+                    {
+                        Unlink(Event);
+                        --m_count;
+                    }
 
-            if (!force)                                      // need per-element cleanup
-                m_events.erase (i_old);
+                    delete Event;
+                }
+
+                Event = next;
+            }
         }
     }
 
     // fast clear event list (in force case)
     if (force)
-        m_events.clear();
+    {
+        memset(m_wheel->slots, 0, sizeof(m_wheel->slots));
+        memset(m_wheel->used, 0, sizeof(m_wheel->used));
+        m_count = 0;
+    }
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
 {
     if (set_addtime) Event->m_addTime = m_time;
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+
+    if (!m_wheel)
+        m_wheel = new EventWheel;
+
+    Link(Event);
+    ++m_count;
+    m_emptyTime = 0;
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset)
 {
     return(m_time + t_offset);
 }
-
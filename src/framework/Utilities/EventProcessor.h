@@ -8,14 +8,14 @@
 
 #include "Platform/Define.h"
 
-#include<map>
-
 // Note. All times are in milliseconds here.
 
 class BasicEvent
 {
+    friend class EventProcessor;
+
     public:
-        BasicEvent() { to_Abort = false; }
+        BasicEvent() : m_wheelNext(NULL), m_wheelPrev(NULL), m_wheelSlot(0) { to_Abort = false; }
         virtual ~BasicEvent()                               // override destructor to perform some actions on event removal
         {
         };
@@ -35,10 +35,47 @@ class BasicEvent
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
+
+    private:
+        // links inside the timer wheel slot the event waits in
+        BasicEvent* m_wheelNext;
+        BasicEvent* m_wheelPrev;
+        uint32 m_wheelSlot;
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+#define EVENT_WHEEL_LEVELS      4
+#define EVENT_WHEEL_SLOT_BITS   5
+#define EVENT_WHEEL_SLOTS       (1 << EVENT_WHEEL_SLOT_BITS)
+#define EVENT_WHEEL_SLOT_MASK   (EVENT_WHEEL_SLOTS - 1)
+
+// Slots of a hierarchical timer wheel. Level 0 has one slot per millisecond,
+// each higher level EVENT_WHEEL_SLOTS times coarser slots. Events further
+// away than the top level covers wait in its last slot and are placed again
+// when it is cascaded.
+struct EventWheel
+{
+    EventWheel();
+
+    struct Slot
+    {
+        BasicEvent* head;
+        BasicEvent* tail;
+    };
 
+    Slot slots[EVENT_WHEEL_LEVELS][EVENT_WHEEL_SLOTS];
+    uint32 used[EVENT_WHEEL_LEVELS];                        // bit per non-empty slot
+};
+
+// Per-object event queue.
+//
+// Events are kept in a timer wheel with intrusive links, adding and
+// unlinking an event is O(1) and doesn't allocate. An update visits the
+// non-empty level 0 slots it passes and moves events from a higher level
+// down each time the level below wraps. Due events run in order of their
+// execution time; events added for the current time from inside Execute
+// run in the same update, as before. The wheel is created with the first
+// event and freed once it stayed empty for EVENT_WHEEL_KEEP_TIME, objects
+// without pending events only pay for a pointer.
 class EventProcessor
 {
     public:
@@ -51,8 +88,17 @@ class EventProcessor
         uint64 CalculateTime(uint64 t_offset);
     protected:
         uint64 m_time;
-        EventList m_events;
         bool m_aborting;
+
+    private:
+        void Link(BasicEvent* Event);
+        void Unlink(BasicEvent* Event);
+        void Cascade(uint32 level);
+        void RunSlot(uint32 slot, uint32 p_time);
+
+        EventWheel* m_wheel;
+        uint64 m_wheelTime;                                 // first millisecond not yet run, events before it are done
+        uint32 m_count;
+        uint32 m_emptyTime;                                 // milliseconds the wheel has been empty
 };
 #endif
-
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#include "ObjectPool.h"
+
+#include <ace/Guard_T.h>
+
+ObjectPool* ObjectPool::s_first = NULL;
+
+ObjectPool::ObjectPool(const char* name, size_t blockSize, uint32 maxFree)
+    : m_name(name), m_blockSize(blockSize), m_maxFree(maxFree),
+    m_slot(new ACE_TSS<ObjectPoolSlot>), m_listsLock(new ACE_Thread_Mutex),
+    m_lists(new std::vector<ObjectPoolFreeList*>), m_next(s_first)
+{
+    // a free block holds the link to the next one, smaller requests go to the heap
+    if (m_blockSize < sizeof(void*))
+        m_blockSize = 0;
+
+    // pools are static objects, constructed before any thread is started
+    s_first = this;
+}
+
+ObjectPoolFreeList* ObjectPool::CreateFreeList()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(*m_listsLock);
+
+    // blocks of a finished thread are not lost, the next new thread takes them over
+    for (size_t i = 0; i < m_lists->size(); ++i)
+    {
+        if (!(*m_lists)[i]->owned)
+        {
+            (*m_lists)[i]->owned = true;
+            return (*m_lists)[i];
+        }
+    }
+
+    ObjectPoolFreeList* list = new ObjectPoolFreeList;
+    m_lists->push_back(list);
+    return list;
+}
+
+void ObjectPool::GetStats(Stats& stats) const
+{
+    stats.allocated = 0;
+    stats.reused = 0;
+    stats.released = 0;
+    stats.free = 0;
+
+    ACE_Guard<ACE_Thread_Mutex> guard(*m_listsLock);
+    for (size_t i = 0; i < m_lists->size(); ++i)
+    {
+        ObjectPoolFreeList const* list = (*m_lists)[i];
+        stats.allocated += list->allocated;
+        stats.reused += list->reused;
+        stats.released += list->released;
+        stats.free += list->size;
+    }
+}
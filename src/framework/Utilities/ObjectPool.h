@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#ifndef __OBJECTPOOL_H
+#define __OBJECTPOOL_H
+
+#include "Platform/Define.h"
+
+#include <ace/TSS_T.h>
+#include <ace/Thread_Mutex.h>
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Free blocks of one thread, only that thread touches head and the counters
+struct ObjectPoolFreeList
+{
+    ObjectPoolFreeList() : head(NULL), size(0), owned(true), allocated(0), reused(0), released(0) {}
+
+    void* head;
+    uint32 size;
+    volatile bool owned;                                    // cleared when the thread exits
+
+    uint64 allocated;                                       // taken from the heap
+    uint64 reused;                                          // taken from this free list
+    uint64 released;                                        // given back to the heap, free list was full
+};
+
+struct ObjectPoolSlot
+{
+    ObjectPoolSlot() : list(NULL) {}
+    ~ObjectPoolSlot() { if (list) list->owned = false; }    // next new thread adopts the blocks
+
+    ObjectPoolFreeList* list;
+};
+
+// Pool of equally sized memory blocks with a free list per thread.
+//
+// Blocks are taken from and given back to the free list of the calling
+// thread without any locking; a block freed by another thread than the one
+// which allocated it simply changes owner. A free list keeps at most
+// maxFree blocks, the surplus goes back to the heap. Requests of another
+// size (derived classes) are passed to the heap.
+//
+// Pooled objects may be freed during static destruction, so a pool never
+// releases its free lists.
+class ObjectPool
+{
+    public:
+        ObjectPool(const char* name, size_t blockSize, uint32 maxFree = 4096);
+
+        void* Allocate(size_t size)
+        {
+            if (size != m_blockSize)
+                return ::operator new(size);
+
+            ObjectPoolFreeList* list = GetFreeList();
+            if (void* p = list->head)
+            {
+                list->head = *(void**)p;
+                --list->size;
+                ++list->reused;
+                return p;
+            }
+
+            ++list->allocated;
+            return ::operator new(size);
+        }
+
+        void Deallocate(void* p, size_t size)
+        {
+            if (!p)
+                return;
+
+            if (size != m_blockSize)
+            {
+                ::operator delete(p);
+                return;
+            }
+
+            ObjectPoolFreeList* list = GetFreeList();
+            if (list->size >= m_maxFree)
+            {
+                ++list->released;
+                ::operator delete(p);
+                return;
+            }
+
+            *(void**)p = list->head;
+            list->head = p;
+            ++list->size;
+        }
+
+        struct Stats
+        {
+            uint64 allocated;
+            uint64 reused;
+            uint64 released;
+            uint64 free;                                    // blocks waiting in the free lists
+        };
+
+        // summed over all threads, counters of running threads may be slightly behind
+        void GetStats(Stats& stats) const;
+        const char* GetName() const { return m_name; }
+
+        // every pool of the process, for statistics
+        static ObjectPool* GetFirst() { return s_first; }
+        ObjectPool* GetNext() const { return m_next; }
+
+    private:
+        ObjectPoolFreeList* GetFreeList()
+        {
+            // operator-> creates the slot on the first use of a thread
+            ACE_TSS<ObjectPoolSlot>& slot = *m_slot;
+            if (!slot->list)
+                slot->list = CreateFreeList();
+            return slot->list;
+        }
+
+        ObjectPoolFreeList* CreateFreeList();
+
+        const char* m_name;
+        size_t m_blockSize;
+        uint32 m_maxFree;
+
+        // never deleted, see above
+        ACE_TSS<ObjectPoolSlot>* m_slot;
+        ACE_Thread_Mutex* m_listsLock;
+        std::vector<ObjectPoolFreeList*>* m_lists;
+
+        ObjectPool* m_next;
+        static ObjectPool* s_first;
+};
+
+// std::allocator replacement drawing single elements from an ObjectPool,
+// meant for node based containers (std::list, std::map) that are filled and
+// cleared at a high rate. Bulk allocations go to the heap.
+template<class T>
+class PoolAllocator
+{
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template<class U> struct rebind { typedef PoolAllocator<U> other; };
+
+        PoolAllocator() {}
+        PoolAllocator(PoolAllocator const&) {}
+        template<class U> PoolAllocator(PoolAllocator<U> const&) {}
+
+        pointer address(reference x) const { return &x; }
+        const_pointer address(const_reference x) const { return &x; }
+
+        pointer allocate(size_type n, const void* = 0)
+        {
+            if (n == 1)
+                return static_cast<pointer>(s_pool.Allocate(sizeof(T)));
+            return static_cast<pointer>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(pointer p, size_type n)
+        {
+            if (n == 1)
+                s_pool.Deallocate(p, sizeof(T));
+            else
+                ::operator delete(p);
+        }
+
+        size_type max_size() const { return size_t(-1) / sizeof(T); }
+
+        void construct(pointer p, const T& val) { new(p) T(val); }
+        void destroy(pointer p) { p->~T(); }
+
+        bool operator==(PoolAllocator const&) const { return true; }
+        bool operator!=(PoolAllocator const&) const { return false; }
+
+    private:
+        static ObjectPool s_pool;
+};
+
+template<class T> ObjectPool PoolAllocator<T>::s_pool("container nodes", sizeof(T));
+
+#endif
@@ -24,6 +24,7 @@
 #include "World.h"
 #include "Chat.h"
 #include "ArenaTeam.h"
+#include "TickProfiler.h"
 
 INSTANTIATE_SINGLETON_1(BattleGroundMgr);
 
@@ -31,7 +32,7 @@ INSTANTIATE_SINGLETON_1(BattleGroundMgr);
 /***            BATTLEGROUND QUEUE SYSTEM              ***/
 /*********************************************************/
 
-BattleGroundQueue::BattleGroundQueue()
+BattleGroundQueue::BattleGroundQueue() : m_JoinSeq(0)
 {
     //queues are empty, we don't have to call clear()
 /*    for (int i = 0; i < MAX_BATTLEGROUND_QUEUES; i++)
@@ -52,20 +53,53 @@ BattleGroundQueue::~BattleGroundQueue()
             delete (*itr);
         }
         m_QueuedGroups[i].clear();
+
+        for (int side = 0; side < BG_TEAMS_COUNT; ++side)
+        {
+            for (int rated = 0; rated < 2; ++rated)
+            {
+                m_WaitingGroups[i][side][rated].Groups.clear();
+                m_WaitingGroups[i][side][rated].ByRating.clear();
+            }
+        }
     }
 }
 
+struct GroupQueueJoinOrder
+{
+    bool operator()(GroupQueueInfo const* a, GroupQueueInfo const* b) const { return a->JoinSeq < b->JoinSeq; }
+};
+
 // initialize eligible groups from the given source matching the given specifications
-void BattleGroundQueue::EligibleGroups::Init(BattleGroundQueue::QueuedGroupsList *source, uint32 BgTypeId, uint32 side, uint32 MaxPlayers, uint8 ArenaType, bool IsRated, uint32 MinRating, uint32 MaxRating, uint32 DisregardTime, uint32 excludeTeam)
+void BattleGroundQueue::EligibleGroups::Init(BattleGroundQueue::WaitingGroups *source, uint32 BgTypeId, uint32 side, uint32 MaxPlayers, uint8 ArenaType, bool IsRated, uint32 MinRating, uint32 MaxRating, uint32 DisregardTime, uint32 excludeTeam)
 {
     // clear from prev initialization
     clear();
-    BattleGroundQueue::QueuedGroupsList::iterator itr, next;
-    // iterate through the source
-    for (itr = source->begin(); itr != source->end(); itr = next)
+
+    std::vector<GroupQueueInfo*> candidates;
+    if (IsRated && DisregardTime)
+    {
+        // only groups that can pass the rating check: those which waited long enough (the front of
+        // the join order), those without rating and those inside the rating range
+        for (BattleGroundQueue::QueuedGroupsList::iterator itr = source->Groups.begin(); itr != source->Groups.end() && (*itr)->JoinTime <= DisregardTime; ++itr)
+            candidates.push_back(*itr);
+
+        BattleGroundQueue::RatedGroupsMap::iterator itr, end;
+        for (itr = source->ByRating.begin(), end = source->ByRating.upper_bound(0); itr != end; ++itr)
+            candidates.push_back(itr->second);
+        if (MinRating <= MaxRating)
+            for (itr = source->ByRating.lower_bound(std::max(MinRating, uint32(1))), end = source->ByRating.upper_bound(MaxRating); itr != end; ++itr)
+                candidates.push_back(itr->second);
+
+        std::sort(candidates.begin(), candidates.end(), GroupQueueJoinOrder());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    }
+    else
+        candidates.assign(source->Groups.begin(), source->Groups.end());
+
+    // iterate through the candidates
+    for (std::vector<GroupQueueInfo*>::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
     {
-        next = itr;
-        ++next;
         if ((*itr)->BgTypeId == BgTypeId &&     // bg type must match
             (*itr)->ArenaType == ArenaType &&   // arena type must match
             (*itr)->IsRated == IsRated &&       // israted must match
@@ -137,10 +171,13 @@ GroupQueueInfo * BattleGroundQueue::AddGroup(Player* leader, uint32 BgTypeId, ui
     ginfo->Team                      = leader->GetTeam();
     ginfo->ArenaTeamRating           = arenaRating;
     ginfo->OpponentsTeamRating       = 0;                       //initialize it to 0
+    ginfo->QueueId                   = queue_id;
+    ginfo->JoinSeq                   = ++m_JoinSeq;
 
     ginfo->Players.clear();
 
-    m_QueuedGroups[queue_id].push_back(ginfo);
+    ginfo->QueuedItr = m_QueuedGroups[queue_id].insert(m_QueuedGroups[queue_id].end(), ginfo);
+    AddWaitingGroup(ginfo);
 
     // return ginfo, because it is needed to add players to this group info
     return ginfo;
@@ -254,11 +291,8 @@ void BattleGroundQueue::RemovePlayer(uint64 guid, bool decreaseInvitedCount)
 
     group = itr->second.GroupInfo;
 
-    for (group_itr=m_QueuedGroups[queue_id].begin(); group_itr != m_QueuedGroups[queue_id].end(); ++group_itr)
-    {
-        if (group == (GroupQueueInfo*)(*group_itr))
-            break;
-    }
+    // the group is listed in the queue of its leader's level
+    group_itr = group->QueueId == uint32(queue_id) ? group->QueuedItr : m_QueuedGroups[queue_id].end();
 
     // variables are set (what about leveling up when in queue????)
     // remove player from group
@@ -311,6 +345,7 @@ void BattleGroundQueue::RemovePlayer(uint64 guid, bool decreaseInvitedCount)
         // remove group queue info if needed
         if (group->Players.empty())
         {
+            RemoveWaitingGroup(group);
             m_QueuedGroups[queue_id].erase(group_itr);
             delete group;
         }
@@ -348,6 +383,7 @@ bool BattleGroundQueue::InviteGroupToBG(GroupQueueInfo * ginfo, BattleGround* bg
         // not yet invited
         // set invitation
         ginfo->IsInvitedToBGInstanceGUID = bg->GetInstanceID();
+        RemoveWaitingGroup(ginfo);
         uint32 bgQueueTypeId = sBattleGroundMgr.BGQueueTypeId(bg->GetTypeID(), bg->GetArenaType());
         // loop through the players
         for (std::map<uint64,PlayerQueueInfo*>::iterator itr = ginfo->Players.begin(); itr != ginfo->Players.end(); ++itr)
@@ -381,6 +417,30 @@ bool BattleGroundQueue::InviteGroupToBG(GroupQueueInfo * ginfo, BattleGround* bg
     return false;
 }
 
+void BattleGroundQueue::AddWaitingGroup(GroupQueueInfo * ginfo)
+{
+    ginfo->IsWaiting = true;
+    ginfo->WaitingSide = ginfo->Team == ALLIANCE ? BG_TEAM_ALLIANCE : BG_TEAM_HORDE;
+
+    WaitingGroups& waiting = m_WaitingGroups[ginfo->QueueId][ginfo->WaitingSide][ginfo->IsRated ? 1 : 0];
+    ginfo->WaitingItr = waiting.Groups.insert(waiting.Groups.end(), ginfo);
+    if (ginfo->IsRated)
+        ginfo->RatingItr = waiting.ByRating.insert(RatedGroupsMap::value_type(ginfo->ArenaTeamRating, ginfo));
+}
+
+void BattleGroundQueue::RemoveWaitingGroup(GroupQueueInfo * ginfo)
+{
+    if (!ginfo->IsWaiting)
+        return;
+
+    ginfo->IsWaiting = false;
+
+    WaitingGroups& waiting = m_WaitingGroups[ginfo->QueueId][ginfo->WaitingSide][ginfo->IsRated ? 1 : 0];
+    waiting.Groups.erase(ginfo->WaitingItr);
+    if (ginfo->IsRated)
+        waiting.ByRating.erase(ginfo->RatingItr);
+}
+
 // used to recursively select groups from eligible groups
 bool BattleGroundQueue::SelectionPool::Build(uint32 MinPlayers, uint32 MaxPlayers, EligibleGroups::iterator startitr)
 {
@@ -434,7 +494,7 @@ bool BattleGroundQueue::BuildSelectionPool(uint32 bgTypeId, uint32 queue_id, uin
     }
 
     // initiate the groups eligible to create the bg
-    m_EligibleGroups.Init(&(m_QueuedGroups[queue_id]), bgTypeId, side, MaxPlayers, ArenaType, isRated, MinRating, MaxRating, DisregardTime, excludeTeam);
+    m_EligibleGroups.Init(&m_WaitingGroups[queue_id][side == ALLIANCE ? BG_TEAM_ALLIANCE : BG_TEAM_HORDE][isRated ? 1 : 0], bgTypeId, side, MaxPlayers, ArenaType, isRated, MinRating, MaxRating, DisregardTime, excludeTeam);
     // init the selected groups (clear)
     // and set m_CurrEligGroups pointer
     // we set it this way to only have one EligibleGroups object to save some memory
@@ -547,16 +607,25 @@ void BattleGroundQueue::Update(uint32 bgTypeId, uint32 queue_id, uint8 arenatype
             BattleGround* bg = *itr; //we have to store battleground pointer here, because when battleground is full, it is removed from free queue (not yet implemented!!)
             // and iterator is invalid
 
-            for (QueuedGroupsList::iterator itr = m_QueuedGroups[queue_id].begin(); itr != m_QueuedGroups[queue_id].end(); ++itr)
+            // only groups not invited yet can be invited, battlegrounds have no rated groups
+            for (uint32 side = 0; side < BG_TEAMS_COUNT; ++side)
             {
-                // did the group join for this bg type?
-                if ((*itr)->BgTypeId != bgTypeId)
-                    continue;
-                // if so, check if fits in
-                if (bg->GetFreeSlotsForTeam((*itr)->Team) >= (*itr)->Players.size())
+                QueuedGroupsList& waiting = m_WaitingGroups[queue_id][side][0].Groups;
+                for (QueuedGroupsList::iterator itr = waiting.begin(); itr != waiting.end();)
                 {
-                    // if group fits in, invite it
-                    InviteGroupToBG((*itr),bg,(*itr)->Team);
+                    // inviting removes the group from the waiting list
+                    GroupQueueInfo* ginfo = *itr;
+                    ++itr;
+
+                    // did the group join for this bg type?
+                    if (ginfo->BgTypeId != bgTypeId)
+                        continue;
+                    // if so, check if fits in
+                    if (bg->GetFreeSlotsForTeam(ginfo->Team) >= ginfo->Players.size())
+                    {
+                        // if group fits in, invite it
+                        InviteGroupToBG(ginfo,bg,ginfo->Team);
+                    }
                 }
             }
 
@@ -1010,6 +1079,8 @@ void BattleGroundMgr::DeleteAlllBattleGrounds()
 // used to update running battlegrounds, and delete finished ones
 void BattleGroundMgr::Update(time_t diff)
 {
+    PROFILE_ZONE("BattleGroundMgr::Update");
+
     BattleGroundSet::iterator itr, next;
     for (itr = m_BattleGrounds.begin(); itr != m_BattleGrounds.end(); itr = next)
     {
@@ -46,6 +46,15 @@ struct GroupQueueInfo                                       // stores informatio
     uint32  IsInvitedToBGInstanceGUID;                      // was invited to certain BG
     uint32  ArenaTeamRating;                                // if rated match, inited to the rating of the team
     uint32  OpponentsTeamRating;                            // for rated arena matches
+
+    // queue bookkeeping, maintained by BattleGroundQueue
+    uint32  QueueId;                                        // level range queue the group is listed in
+    uint32  JoinSeq;                                        // join order, groups are selected first come first served
+    bool    IsWaiting;                                      // listed in the waiting index (not invited yet)
+    uint8   WaitingSide;                                    // team index of the waiting index entry, Team is changed temporarily
+    std::list<GroupQueueInfo*>::iterator QueuedItr;         // position in m_QueuedGroups[QueueId]
+    std::list<GroupQueueInfo*>::iterator WaitingItr;        // position in the waiting index
+    std::multimap<uint32, GroupQueueInfo*>::iterator RatingItr; // position in the rating index, rated groups only
 };
 
 class BattleGround;
@@ -69,11 +78,21 @@ class BattleGroundQueue
         typedef std::list<GroupQueueInfo*> QueuedGroupsList;
         QueuedGroupsList m_QueuedGroups[MAX_BATTLEGROUND_QUEUES];
 
+        typedef std::multimap<uint32, GroupQueueInfo*> RatedGroupsMap;
+
+        // groups not invited yet, kept per queue id, side and rated flag so an update only looks at its candidates
+        struct WaitingGroups
+        {
+            QueuedGroupsList Groups;                        // join order
+            RatedGroupsMap ByRating;                        // rated groups by team rating
+        };
+        WaitingGroups m_WaitingGroups[MAX_BATTLEGROUND_QUEUES][2][2];   // queue id, team index, rated
+
         // class to hold pointers to the groups eligible for a specific selection pool building mode
         class EligibleGroups : public std::list<GroupQueueInfo *>
         {
         public:
-            void Init(QueuedGroupsList * source, uint32 BgTypeId, uint32 side, uint32 MaxPlayers, uint8 ArenaType = 0, bool IsRated = false, uint32 MinRating = 0, uint32 MaxRating = 0, uint32 DisregardTime = 0, uint32 excludeTeam = 0);
+            void Init(WaitingGroups * source, uint32 BgTypeId, uint32 side, uint32 MaxPlayers, uint8 ArenaType = 0, bool IsRated = false, uint32 MinRating = 0, uint32 MaxRating = 0, uint32 DisregardTime = 0, uint32 excludeTeam = 0);
         };
 
         EligibleGroups m_EligibleGroups;
@@ -113,6 +132,11 @@ class BattleGroundQueue
     private:
 
         bool InviteGroupToBG(GroupQueueInfo * ginfo, BattleGround* bg, uint32 side);
+
+        void AddWaitingGroup(GroupQueueInfo * ginfo);
+        void RemoveWaitingGroup(GroupQueueInfo * ginfo);
+
+        uint32 m_JoinSeq;
 };
 
 /*
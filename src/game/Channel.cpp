@@ -93,6 +93,7 @@ void Channel::Join(uint64 p, const char *pass)
 
     PlayerInfo pinfo;
     pinfo.player = p;
+    pinfo.plr = plr;
     pinfo.flags = MEMBER_FLAG_NONE;
     players[p] = pinfo;
 
@@ -439,7 +440,7 @@ void Channel::List(Player* player)
         uint32 count  = 0;
         for (PlayerList::const_iterator i = players.begin(); i != players.end(); ++i)
         {
-            Player* plr = ObjectAccessor::FindPlayer(i->first);
+            Player* plr = i->second.plr;
 
             // PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
             // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
@@ -528,24 +529,25 @@ void Channel::Say(uint64 p, const char *what, uint32 lang)
     if (sWorld.getConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_CHANNEL))
         lang = LANG_UNIVERSAL;
 
-    uint32 sec = 0;
-    Player* plr = ObjectAccessor::FindPlayer(p);
-    if (plr)
-        sec = plr->GetSession()->GetSecurity();
-
-    if (!IsOn(p))
+    PlayerList::iterator p_itr = players.find(p);
+    if (p_itr == players.end())
     {
         WorldPacket data;
         MakeNotMember(&data);
         SendToOne(&data, p);
+        return;
     }
-    else if (players[p].IsMuted())
+
+    Player* plr = p_itr->second.plr;
+    uint32 sec = plr ? plr->GetSession()->GetSecurity() : 0;
+
+    if (p_itr->second.IsMuted())
     {
         WorldPacket data;
         MakeMuted(&data);
         SendToOne(&data, p);
     }
-    else if (m_moderate && !players[p].IsModerator() && sec < SEC_GAMEMASTER)
+    else if (m_moderate && !p_itr->second.IsModerator() && sec < SEC_GAMEMASTER)
     {
         WorldPacket data;
         MakeNotModerator(&data);
@@ -553,11 +555,6 @@ void Channel::Say(uint64 p, const char *what, uint32 lang)
     }
     else
     {
-        // ChatSpy
-        for(PlayerList::iterator itr = players.begin(); itr != players.end(); ++itr)
-            if(Player* pl = ObjectAccessor::FindPlayer(itr->first))
-                pl->HandleChatSpyMessage(what, CHAT_MSG_CHANNEL, lang, plr, GetName());
-
         uint32 messageLength = strlen(what) + 1;
 
         WorldPacket data(SMSG_MESSAGECHAT, 1+4+8+4+m_name.size()+1+8+4+messageLength+1);
@@ -571,7 +568,8 @@ void Channel::Say(uint64 p, const char *what, uint32 lang)
         data << what;
         data << uint8(plr ? plr->GetChatTag() : CHAT_TAG_NONE);
 
-        SendToAll(&data, !players[p].IsModerator() ? p : false);
+        // ChatSpy is handled in the same pass as the fan-out
+        SendToAll(&data, !p_itr->second.IsModerator() ? p : 0, plr, what, lang);
     }
 }
 
@@ -654,16 +652,22 @@ void Channel::SetOwner(uint64 guid, bool exclaim)
     }
 }
 
-void Channel::SendToAll(WorldPacket* data, uint64 p)
+// One pass over the members with the cached Player pointers, the packet is built once by the caller
+void Channel::SendToAll(WorldPacket* data, uint64 p, Player* spySender, const char* spyText, uint32 spyLang)
 {
+    uint32 ignoreGuid = GUID_LOPART(p);
+
     for (PlayerList::const_iterator i = players.begin(); i != players.end(); ++i)
     {
-        Player* plr = ObjectAccessor::FindPlayer(i->first);
-        if (plr)
-        {
-            if (!p || !plr->GetSocial()->HasIgnore(GUID_LOPART(p)))
-                plr->GetSession()->SendPacket(data);
-        }
+        Player* plr = i->second.plr;
+        if (!plr)
+            continue;
+
+        if (spyText)
+            plr->HandleChatSpyMessage(spyText, CHAT_MSG_CHANNEL, spyLang, spySender, m_name);
+
+        if (!p || !plr->GetSocial()->HasIgnore(ignoreGuid))
+            plr->GetSession()->SendPacket(data);
     }
 }
 
@@ -671,18 +675,15 @@ void Channel::SendToAllButOne(WorldPacket* data, uint64 who)
 {
     for (PlayerList::const_iterator i = players.begin(); i != players.end(); ++i)
     {
-        if (i->first != who)
-        {
-            Player* plr = ObjectAccessor::FindPlayer(i->first);
-            if (plr)
-                plr->GetSession()->SendPacket(data);
-        }
+        if (i->first != who && i->second.plr)
+            i->second.plr->GetSession()->SendPacket(data);
     }
 }
 
 void Channel::SendToOne(WorldPacket* data, uint64 who)
 {
-    Player* plr = ObjectAccessor::FindPlayer(who);
+    PlayerList::const_iterator i = players.find(who);
+    Player* plr = i != players.end() && i->second.plr ? i->second.plr : ObjectAccessor::FindPlayer(who);
     if (plr)
         plr->GetSession()->SendPacket(data);
 }
@@ -107,7 +107,10 @@ class Channel
 {
     struct PlayerInfo
     {
+        PlayerInfo() : player(0), plr(NULL), flags(MEMBER_FLAG_NONE) {}
+
         uint64 player;
+        Player* plr;                                        // cached at join, members always leave the channel at logout
         uint8 flags;
 
         bool HasFlag(uint8 flag) { return flags & flag; }
@@ -185,7 +188,7 @@ class Channel
         void MakeVoiceOn(WorldPacket* data, uint64 guid);                       //+ 0x22
         void MakeVoiceOff(WorldPacket* data, uint64 guid);                      //+ 0x23
 
-        void SendToAll(WorldPacket* data, uint64 p = 0);
+        void SendToAll(WorldPacket* data, uint64 p = 0, Player* spySender = NULL, const char* spyText = NULL, uint32 spyLang = 0);
         void SendToAllButOne(WorldPacket* data, uint64 who);
         void SendToOne(WorldPacket* data, uint64 who);
 
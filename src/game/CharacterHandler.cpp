@@ -452,6 +452,9 @@ void WorldSession::HandlePlayerLoginOpcode(WorldPacket& recv_data)
         return;
     }
 
+    // queue buffered guild and arena team changes ahead of the login queries
+    CharacterDatabaseWriter.Flush();
+
     CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerLoginCallback, holder);
 }
 
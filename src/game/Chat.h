@@ -311,6 +311,7 @@ class ChatHandler
         bool HandleServerPlayersCommand(const char* args);
         bool HandleServerMotdCommand(const char* args);
         bool HandleServerPLimitCommand(const char* args);
+        bool HandleServerProfileCommand(const char* args);
         bool HandleServerRestartCommand(const char* args);
         bool HandleServerSetLogLevelCommand(const char* args);
         bool HandleServerSetMotdCommand(const char* args);
@@ -36,6 +36,7 @@
 #include "CreatureGroups.h"
 // apply implementation of the singletons
 #include "Policies/SingletonImp.h"
+#include "TickProfiler.h"
 
 void TrainerSpellData::Clear()
 {
@@ -164,6 +165,10 @@ Creature::~Creature()
 
     delete i_AI;
     i_AI = NULL;
+
+    // summons, pets and instance copies don't keep their guid, it can be used again
+    if (m_uint32Values && GetGUIDLow() != m_DBTableGuid)
+        objmgr.RecycleLowGuid(HighGuid(GetGUIDHigh()), GetGUIDLow());
 }
 
 void Creature::AddToWorld()
@@ -464,6 +469,8 @@ bool Creature::UpdateEntry(uint32 Entry, uint32 team, const CreatureData *data)
 
 void Creature::Update(uint32 diff)
 {
+    PROFILE_ZONE_ARG("Creature::Update", GetEntry());
+
     if (m_GlobalCooldown <= diff)
         m_GlobalCooldown = 0;
     else
@@ -568,7 +575,10 @@ void Creature::Update(uint32 diff)
             {
                 // do not allow the AI to be changed during update
                 m_AI_locked = true;
-                i_AI->UpdateAI(diff);
+                {
+                    PROFILE_ZONE_ARG("CreatureAI::UpdateAI", GetEntry());
+                    i_AI->UpdateAI(diff);
+                }
                 m_AI_locked = false;
             }
 
@@ -1142,7 +1152,7 @@ bool Creature::LoadFromDB(uint32 guid, Map *map)
 
     m_DBTableGuid = guid;
     if (map->GetInstanceId() != 0)
-        guid = objmgr.GenerateLowGuid(HIGHGUID_UNIT);
+        guid = map->GenerateLowGuid(HIGHGUID_UNIT);
 
     uint16 team = 0;
     if (!Create(guid,map,data->id,team,data->posX,data->posY,data->posZ,data->orientation,data))
@@ -11,6 +11,7 @@
 #include "WorldSession.h"
 #include "World.h"
 #include "ObjectAccessor.h"
+#include "ObjectMgr.h"
 #include "Database/DatabaseEnv.h"
 #include "SpellAuras.h"
 #include "MapManager.h"
@@ -28,6 +29,12 @@ DynamicObject::DynamicObject() : WorldObject()
     m_valuesCount = DYNAMICOBJECT_END;
 }
 
+DynamicObject::~DynamicObject()
+{
+    if (m_uint32Values)
+        objmgr.RecycleLowGuid(HIGHGUID_DYNAMICOBJECT, GetGUIDLow());
+}
+
 void DynamicObject::AddToWorld()
 {
     // Register the dynamicObject for guid lookup
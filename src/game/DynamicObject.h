@@ -16,6 +16,7 @@ class DynamicObject : public WorldObject, public GridObject<DynamicObject>
     public:
         typedef std::set<Unit*> AffectedSet;
         explicit DynamicObject();
+        ~DynamicObject();
 
         void AddToWorld();
         void RemoveFromWorld();
@@ -51,6 +51,9 @@ GameObject::GameObject() : WorldObject()
 
 GameObject::~GameObject()
 {
+    // spell and script spawned objects and instance copies don't keep their guid
+    if (m_uint32Values && GetGUIDHigh() == HIGHGUID_GAMEOBJECT && GetGUIDLow() != m_DBTableGuid)
+        objmgr.RecycleLowGuid(HIGHGUID_GAMEOBJECT, GetGUIDLow());
 }
 
 void GameObject::CleanupsBeforeDelete()
@@ -609,7 +612,7 @@ bool GameObject::LoadFromDB(uint32 guid, Map *map)
     uint32 artKit = data->artKit;
 
     m_DBTableGuid = guid;
-    if (map->GetInstanceId() != 0) guid = objmgr.GenerateLowGuid(HIGHGUID_GAMEOBJECT);
+    if (map->GetInstanceId() != 0) guid = map->GenerateLowGuid(HIGHGUID_GAMEOBJECT);
 
     if (!Create(guid,entry, map, x, y, z, ang, rotation0, rotation1, rotation2, rotation3, animprogress, go_state, artKit))
         return false;
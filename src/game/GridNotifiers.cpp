@@ -326,6 +326,39 @@ MessageDistDeliverer::Visit(PlayerMapType &m)
     }
 }
 
+void
+MovementDistDeliverer::Visit(PlayerMapType &m)
+{
+    for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        Player* target = iter->getSource();
+
+        float distSq = target->GetExactDistSq(i_source);
+        if (distSq > i_distSq)
+            continue;
+
+        if (i_skipFar && distSq > i_fullRateDistSq)
+        {
+            ++i_decimated;
+            continue;
+        }
+
+        if (!target->GetSharedVisionList().empty())
+        {
+            SharedVisionList::const_iterator i = target->GetSharedVisionList().begin();
+            for (; i != target->GetSharedVisionList().end(); ++i)
+                if ((*i)->m_seer == target)
+                    SendPacket(*i);
+        }
+
+        if (target->m_seer == target && target != i_source)
+        {
+            SendPacket(target);
+            ++i_forwarded;
+        }
+    }
+}
+
 void
 MessageDistDeliverer::Visit(CreatureMapType &m)
 {
@@ -133,6 +133,22 @@ namespace BlizzLike
         }
     };
 
+    // movement broadcast, observers farther than fullRateDist are skipped when skipFar is set
+    struct MovementDistDeliverer : public MessageDistDeliverer
+    {
+        float i_fullRateDistSq;
+        bool i_skipFar;
+        uint32 i_forwarded;
+        uint32 i_decimated;
+        MovementDistDeliverer(WorldObject *src, WorldPacket* msg, float dist, float fullRateDist, bool skipFar)
+            : MessageDistDeliverer(src, msg, dist), i_fullRateDistSq(fullRateDist * fullRateDist), i_skipFar(skipFar)
+            , i_forwarded(0), i_decimated(0)
+        {
+        }
+        using MessageDistDeliverer::Visit;
+        void Visit(PlayerMapType &m);
+    };
+
     struct ObjectUpdater
     {
         uint32 i_timeDiff;
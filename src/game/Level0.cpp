@@ -18,6 +18,7 @@
 #include "SystemConfig.h"
 #include "revision.h"
 #include "Util.h"
+#include "Utilities/ObjectPool.h"
 
 bool ChatHandler::HandleHelpCommand(const char* args)
 {
@@ -93,6 +94,29 @@ bool ChatHandler::HandleServerInfoCommand(const char* /*args*/)
     PSendSysMessage(LANG_UPTIME, str.c_str());
     PSendSysMessage("Update time diff: %u.", updateTime);
 
+    if (!m_session || m_session->GetSecurity() >= SEC_GAMEMASTER)
+    {
+        MovementBroadcastStats& stats = Map::GetMovementStats();
+        PSendSysMessage("Movement packets: " UI64FMTD " forwarded, " UI64FMTD " coalesced, " UI64FMTD " decimated.",
+            uint64(stats.forwarded.value()), uint64(stats.coalesced.value()), uint64(stats.decimated.value()));
+
+        TerrainCacheStats& terrainStats = TerrainCache::GetStats();
+        PSendSysMessage("Terrain cache: " UI64FMTD " height hits, " UI64FMTD " misses; " UI64FMTD " area hits, " UI64FMTD " misses.",
+            uint64(terrainStats.heightHits.value()), uint64(terrainStats.heightMisses.value()),
+            uint64(terrainStats.areaHits.value()), uint64(terrainStats.areaMisses.value()));
+
+        PSendSysMessage("Values update blocks last tick: %u built, %u shared.",
+            ObjectAccessor::Instance().GetLastValuesBlocksBuilt(), ObjectAccessor::Instance().GetLastValuesBlocksShared());
+
+        for (ObjectPool* pool = ObjectPool::GetFirst(); pool; pool = pool->GetNext())
+        {
+            ObjectPool::Stats poolStats;
+            pool->GetStats(poolStats);
+            PSendSysMessage("Pool %s: " UI64FMTD " allocated, " UI64FMTD " reused, " UI64FMTD " released, " UI64FMTD " free.",
+                pool->GetName(), poolStats.allocated, poolStats.reused, poolStats.released, poolStats.free);
+        }
+    }
+
     return true;
 }
 
@@ -4587,7 +4587,7 @@ bool ChatHandler::HandleMmapLocCommand(const char* /*args*/)
 
     // calculate navmesh tile location
     const dtNavMesh* navmesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(player->GetMapId());
-    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(player->GetMapId(), player->GetInstanceId());
+    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(player->GetMapId());
     if (!navmesh || !navmeshquery)
     {
         PSendSysMessage("NavMesh not loaded for current map.");
@@ -4632,7 +4632,7 @@ bool ChatHandler::HandleMmapLoadedTilesCommand(const char* /*args*/)
     uint32 mapid = m_session->GetPlayer()->GetMapId();
 
     const dtNavMesh* navmesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(mapid);
-    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(mapid, m_session->GetPlayer()->GetInstanceId());
+    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(mapid);
     if (!navmesh || !navmeshquery)
     {
         PSendSysMessage("NavMesh not loaded for current map.");
@@ -4660,6 +4660,12 @@ bool ChatHandler::HandleMmapStatsCommand(const char* /*args*/)
 
     MMAP::MMapManager *manager = MMAP::MMapFactory::createOrGetMMapManager();
     PSendSysMessage(" %u maps loaded with %u tiles overall", manager->getLoadedMapsCount(), manager->getLoadedTilesCount());
+    PSendSysMessage(" %u navmesh queries", manager->getNavMeshQueriesCount());
+
+    PathfindingStats& pathStats = PathCache::GetStats();
+    PSendSysMessage(" Paths: " UI64FMTD " searched, " UI64FMTD " cache hits, " UI64FMTD " deferred",
+        uint64(pathStats.searched.value()), uint64(pathStats.cacheHits.value()), uint64(pathStats.deferred.value()));
+    PSendSysMessage(" " UI64FMTD " searched by the pathfinding service (%sactive)", uint64(pathStats.async.value()), MapManager::Instance().GetPathfindingService().activated() ? "" : "in");
 
     const dtNavMesh* navmesh = manager->GetNavMesh(m_session->GetPlayer()->GetMapId());
     if (!navmesh)
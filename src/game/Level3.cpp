@@ -39,6 +39,7 @@
 #include "InstanceData.h"
 #include "AuctionHouseBot.h"
 #include "CreatureEventAIMgr.h"
+#include "TickProfiler.h"
 
 bool ChatHandler::HandleAHBotOptionsCommand(const char *args)
 {
@@ -959,6 +960,7 @@ bool ChatHandler::HandleReloadSpellProcEventCommand(const char*)
 {
     sLog.outString("Re-Loading Spell Proc Event conditions...");
     spellmgr.LoadSpellProcEvents();
+    spellmgr.LoadAuraProcFlags();
     SendGlobalGMSysMessage("DB table spell_proc_event (spell proc trigger requirements) reloaded.");
     return true;
 }
@@ -6451,6 +6453,25 @@ bool ChatHandler::HandleServerPLimitCommand(const char *args)
     return true;
 }
 
+bool ChatHandler::HandleServerProfileCommand(const char *args)
+{
+    uint32 ticks = *args ? atoi(args) : 100;
+    if (!ticks || ticks > 10000)
+        return false;
+
+    if (!sTickProfiler.StartCapture(ticks))
+    {
+        PSendSysMessage("A capture is already running (%u ticks left).", sTickProfiler.GetRemainingTicks());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Profiling the next %u world ticks, output goes to the logs directory.", ticks);
+    if (!sTickProfiler.GetLastCaptureName().empty())
+        PSendSysMessage("Previous capture: %s", sTickProfiler.GetLastCaptureName().c_str());
+    return true;
+}
+
 bool ChatHandler::HandleCastCommand(const char *args)
 {
     if (!*args)
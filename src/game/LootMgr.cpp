@@ -11,6 +11,9 @@
 #include "Util.h"
 #include "SharedDefines.h"
 
+#include <algorithm>
+#include <cfloat>
+
 static Rates const qualityToRate[MAX_ITEM_QUALITY] = {
     RATE_DROP_ITEM_POOR,                                    // ITEM_QUALITY_POOR
     RATE_DROP_ITEM_NORMAL,                                  // ITEM_QUALITY_NORMAL
@@ -47,9 +50,11 @@ class LootTemplate::LootGroup                               // A set of loot def
         void Verify(LootStore const& lootstore, uint32 id, uint32 group_id) const;
         void CollectLootIds(LootIdSet& set) const;
         void CheckLootRefs(LootTemplateMap const& store, LootIdSet* ref_set) const;
+        void Compile();                                     // Builds the cumulative chances (after loading stage)
     private:
         LootStoreItemList ExplicitlyChanced;                // Entries with chances defined in DB
         LootStoreItemList EqualChanced;                     // Zero chances - every entry takes the same chance
+        std::vector<float> Cumulative;                      // Running chance total up to and including each explicitly chanced entry
 
         LootStoreItem const * Roll() const;                 // Rolls an item from the group, returns NULL if all miss their chances
 };
@@ -140,6 +145,7 @@ void LootStore::LoadLootTable()
         } while (result->NextRow());
 
         Verify();                                           // Checks validity of the loot store
+        Compile();
 
         sLog.outString();
         sLog.outString(">> Loaded %u loot definitions (%d templates)", count, m_LootTemplates.size());
@@ -151,6 +157,12 @@ void LootStore::LoadLootTable()
     }
 }
 
+void LootStore::Compile()
+{
+    for (LootTemplateMap::const_iterator i = m_LootTemplates.begin(); i != m_LootTemplates.end(); ++i)
+        i->second->Compile();
+}
+
 bool LootStore::HaveQuestLootFor(uint32 loot_id) const
 {
     LootTemplateMap::const_iterator itr = m_LootTemplates.find(loot_id);
@@ -756,19 +768,13 @@ void LootTemplate::LootGroup::AddEntry(LootStoreItem& item)
 // Rolls an item from the group, returns NULL if all miss their chances
 LootStoreItem const * LootTemplate::LootGroup::Roll() const
 {
-    if (!ExplicitlyChanced.empty())                         // First explicitly chanced entries are checked
+    if (!Cumulative.empty())                                // First explicitly chanced entries are checked
     {
+        // first entry whose running total exceeds the roll, the same one a walk subtracting every chance stops at
         float Roll = rand_chance();
-
-        for (uint32 i=0; i<ExplicitlyChanced.size(); ++i)    //check each explicitly chanced entry in the template and modify its chance based on quality.
-        {
-            if (ExplicitlyChanced[i].chance>=100.f)
-                return &ExplicitlyChanced[i];
-
-            Roll -= ExplicitlyChanced[i].chance;
-            if (Roll < 0)
-                return &ExplicitlyChanced[i];
-        }
+        std::vector<float>::const_iterator itr = std::upper_bound(Cumulative.begin(), Cumulative.end(), Roll);
+        if (itr != Cumulative.end())
+            return &ExplicitlyChanced[itr - Cumulative.begin()];
     }
     if (!EqualChanced.empty())                              // If nothing selected yet - an item is taken from equal-chanced part
         return &EqualChanced[irand(0, EqualChanced.size()-1)];
@@ -845,6 +851,24 @@ void LootTemplate::LootGroup::Verify(LootStore const& lootstore, uint32 id, uint
     }
 }
 
+void LootTemplate::LootGroup::Compile()
+{
+    Cumulative.clear();
+    Cumulative.reserve(ExplicitlyChanced.size());
+
+    float total = 0.0f;
+    for (LootStoreItemList::const_iterator i = ExplicitlyChanced.begin(); i != ExplicitlyChanced.end(); ++i)
+    {
+        // an entry with 100% takes every roll reaching it, the entries behind it never drop
+        if (i->chance >= 100.0f)
+            total = FLT_MAX;
+        else if (total != FLT_MAX)
+            total += i->chance;
+
+        Cumulative.push_back(total);
+    }
+}
+
 void LootTemplate::LootGroup::CheckLootRefs(LootTemplateMap const& /*store*/, LootIdSet* ref_set) const
 {
     for (LootStoreItemList::const_iterator ieItr=ExplicitlyChanced.begin(); ieItr != ExplicitlyChanced.end(); ++ieItr)
@@ -900,23 +924,18 @@ void LootTemplate::Process(Loot& loot, LootStore const& store, uint8 groupId) co
     }
 
     // Rolling non-grouped items
-    for (LootStoreItemList::const_iterator i = Entries.begin() ; i != Entries.end() ; ++i)
+    for (CompiledEntries::const_iterator i = Compiled.begin() ; i != Compiled.end() ; ++i)
     {
-        if (!i->Roll())
+        if (!i->always && !roll_chance_f(i->scaled ? i->chance * sWorld.getRate(Rates(i->rate)) : i->chance))
             continue;                                       // Bad luck for the entry
 
-        if (i->mincountOrRef < 0)                           // References processing
+        if (i->reference)                                   // References processing
         {
-            LootTemplate const* Referenced = LootTemplates_Reference.GetLootFor(-i->mincountOrRef);
-
-            if (!Referenced)
-                continue;                                   // Error message already printed at loading stage
-
-            for (uint32 loop=0; loop < i->maxcount; ++loop)// Ref multiplicator
-                Referenced->Process(loot, store, i->group); // Ref processing
+            for (uint32 loop=0; loop < i->item->maxcount; ++loop)// Ref multiplicator
+                i->reference->Process(loot, store, i->item->group);
         }
         else                                                // Plain entries (not a reference, not grouped)
-            loot.AddItem(*i);                               // Chance is already checked, just add
+            loot.AddItem(*i->item);                         // Chance is already checked, just add
     }
 
     // Now processing groups
@@ -999,6 +1018,45 @@ void LootTemplate::Verify(LootStore const& lootstore, uint32 id) const
     // TODO: References validity checks
 }
 
+// Resolves references and drop rates of the entries (after loading stage)
+// Must be redone whenever the reference store is reloaded
+void LootTemplate::Compile()
+{
+    Compiled.clear();
+    Compiled.reserve(Entries.size());
+
+    for (LootStoreItemList::const_iterator i = Entries.begin(); i != Entries.end(); ++i)
+    {
+        CompiledEntry entry;
+        entry.item = &*i;
+        entry.reference = NULL;
+        entry.chance = i->chance;
+        entry.rate = 0;
+        entry.scaled = false;
+        entry.always = i->chance >= 100.0f;
+
+        if (i->mincountOrRef < 0)                           // reference case
+        {
+            entry.reference = LootTemplates_Reference.GetLootFor(-i->mincountOrRef);
+            if (!entry.reference)
+                continue;                                   // Error message already printed at loading stage
+
+            entry.rate = RATE_DROP_ITEM_REFERENCED;
+            entry.scaled = true;
+        }
+        else if (ItemPrototype const* pProto = objmgr.GetItemPrototype(i->itemid))
+        {
+            entry.rate = qualityToRate[pProto->Quality];
+            entry.scaled = true;
+        }
+
+        Compiled.push_back(entry);
+    }
+
+    for (LootGroups::iterator i = Groups.begin(); i != Groups.end(); ++i)
+        i->Compile();
+}
+
 void LootTemplate::CheckLootRefs(LootTemplateMap const& store, LootIdSet* ref_set) const
 {
     for (LootStoreItemList::const_iterator ieItr = Entries.begin(); ieItr != Entries.end(); ++ieItr)
@@ -1227,5 +1285,16 @@ void LoadLootTemplates_Reference()
 
     // output error for any still listed ids (not referenced from any loot table)
     LootTemplates_Reference.ReportUnusedIds(ids_set);
+
+    // references resolved by the other stores point into the (re)loaded templates now
+    LootTemplates_Creature.Compile();
+    LootTemplates_Fishing.Compile();
+    LootTemplates_Gameobject.Compile();
+    LootTemplates_Item.Compile();
+    LootTemplates_Pickpocketing.Compile();
+    LootTemplates_Skinning.Compile();
+    LootTemplates_Disenchant.Compile();
+    LootTemplates_Prospecting.Compile();
+    LootTemplates_Mail.Compile();
 }
 
@@ -125,6 +125,9 @@ class LootStore
 
         char const* GetName() const { return m_name; }
         char const* GetEntryName() const { return m_entryName; }
+
+        // Prepares the templates for rolling, again whenever the reference store is reloaded
+        void Compile();
     protected:
         void LoadLootTable();
         void Clear();
@@ -153,9 +156,25 @@ class LootTemplate
         // Checks integrity of the template
         void Verify(LootStore const& store, uint32 Id) const;
         void CheckLootRefs(LootTemplateMap const& store, LootIdSet* ref_set) const;
+
+        // Resolves references and drop rates of the entries (after loading stage)
+        void Compile();
     private:
+        // Non-grouped entry as rolled at loot generation
+        struct CompiledEntry
+        {
+            LootStoreItem const* item;
+            LootTemplate const* reference;                  // resolved reference, NULL for plain entries
+            float chance;
+            uint8 rate;                                     // Rates index applied to the chance, if scaled
+            bool scaled;
+            bool always;                                    // chance >= 100%, no roll needed
+        };
+        typedef std::vector<CompiledEntry> CompiledEntries;
+
         LootStoreItemList Entries;                          // not grouped only
         LootGroups        Groups;                           // groups have own (optimised) processing, grouped entries go there
+        CompiledEntries   Compiled;                         // Entries in roll order, missing references left out
 };
 
 //=====================================================
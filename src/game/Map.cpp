@@ -17,6 +17,8 @@
 #include "MapManager.h"
 #include "ObjectMgr.h"
 #include "MoveMap.h"
+#include "PathFinder.h"
+#include "TickProfiler.h"
 
 #define DEFAULT_GRID_EXPIRY     300
 #define MAX_GRID_LOAD_TIME      50
@@ -24,6 +26,8 @@
 
 GridState* si_GridStates[MAX_GRID_STATE];
 
+MovementBroadcastStats Map::s_movementStats;
+
 Map::~Map()
 {
     UnloadAll();
@@ -40,8 +44,7 @@ Map::~Map()
     if (!m_scriptSchedule.empty())
         sWorld.DecreaseScheduledScriptCount(m_scriptSchedule.size());
 
-    // unload instance specific navigation data
-    MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_parentMap->GetId(), GetInstanceId());
+    delete m_pathCache;
 
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(GetId());
         sWorld.DecreaseScheduledScriptCount(m_scriptSchedule.size());
@@ -155,6 +158,9 @@ void Map::LoadMap(int gx,int gy, bool reload)
 
 void Map::LoadMapAndVMap(int gx,int gy)
 {
+    // results computed before the grid's terrain and vmaps were there
+    m_terrainCache.InvalidateGrid(gx, gy);
+
     LoadMap(gx,gy);
 
     if (i_InstanceId == 0) // Only load the data for the base map
@@ -187,10 +193,15 @@ i_mapEntry (sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode), i_InstanceId(Ins
 m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
 m_activeNonPlayersIter(m_activeNonPlayers.end()), i_gridExpiry(expiry),
-i_scriptLock(false)
+i_scriptLock(false),
+m_creatureGuids(objmgr.GetGuidGenerator(HIGHGUID_UNIT)), m_petGuids(objmgr.GetGuidGenerator(HIGHGUID_PET)),
+m_gameObjectGuids(objmgr.GetGuidGenerator(HIGHGUID_GAMEOBJECT)), m_dynObjectGuids(objmgr.GetGuidGenerator(HIGHGUID_DYNAMICOBJECT)),
+m_pathCache(NULL)
 {
     m_parentMap = (_parent ? _parent : this);
 
+    m_terrainCache.SetSize(sWorld.getConfig(CONFIG_TERRAIN_CACHE_SIZE));
+
     for (unsigned int idx=0; idx < MAX_NUMBER_OF_GRIDS; ++idx)
     {
         for (unsigned int j=0; j < MAX_NUMBER_OF_GRIDS; ++j)
@@ -572,8 +583,88 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<BlizzLike::O
     }
 }
 
+void Map::SendMovementMessage(Unit* sender, Unit* mover, WorldPacket* data)
+{
+    // heartbeats and facing changes only carry the latest state, any other
+    // movement packet is a transition the observers must see in order
+    bool replaceable = data->GetOpcode() == MSG_MOVE_HEARTBEAT || data->GetOpcode() == MSG_MOVE_SET_FACING;
+
+    if (sWorld.getConfig(CONFIG_MOVEMENT_COALESCE_HEARTBEATS))
+    {
+        if (replaceable)
+        {
+            PendingMovementMap::iterator itr = m_pendingMovement.find(mover->GetGUID());
+            if (itr != m_pendingMovement.end())
+                ++s_movementStats.coalesced;
+
+            PendingMovement& pending = m_pendingMovement[mover->GetGUID()];
+            pending.senderGuid = sender->GetGUID();
+            pending.data = *data;
+            return;
+        }
+
+        // an older heartbeat must not arrive after this packet
+        m_pendingMovement.erase(mover->GetGUID());
+    }
+
+    BroadcastMovement(sender, mover, data, data->GetOpcode() == MSG_MOVE_HEARTBEAT);
+}
+
+void Map::BroadcastMovement(WorldObject* sender, WorldObject* mover, WorldPacket* data, bool heartbeat)
+{
+    // distant observers get every Nth heartbeat only, never a facing change:
+    // the last one of a standing mover would not be followed by another packet
+    bool skipFar = false;
+    float fullRateDist = 0.0f;
+    if (heartbeat && sWorld.getConfig(CONFIG_MOVEMENT_DECIMATION_DISTANCE))
+    {
+        skipFar = mover->m_movementHeartbeats++ % sWorld.getConfig(CONFIG_MOVEMENT_DECIMATION_RATE) != 0;
+        fullRateDist = float(sWorld.getConfig(CONFIG_MOVEMENT_DECIMATION_DISTANCE));
+    }
+
+    BlizzLike::MovementDistDeliverer notifier(sender, data, GetVisibilityDistance(), fullRateDist, skipFar);
+    sender->VisitNearbyWorldObject(GetVisibilityDistance(), notifier);
+
+    if (notifier.i_forwarded)
+        s_movementStats.forwarded += notifier.i_forwarded;
+    if (notifier.i_decimated)
+        s_movementStats.decimated += notifier.i_decimated;
+}
+
+void Map::SendPendingMovement()
+{
+    if (m_pendingMovement.empty())
+        return;
+
+    for (PendingMovementMap::iterator itr = m_pendingMovement.begin(); itr != m_pendingMovement.end(); ++itr)
+    {
+        // mover may have left the map or logged out since
+        Unit* mover = ObjectAccessor::GetObjectInMap(itr->first, this, (Unit*)NULL);
+        if (!mover)
+            continue;
+
+        Unit* sender = itr->first == itr->second.senderGuid ? mover : ObjectAccessor::GetObjectInMap(itr->second.senderGuid, this, (Unit*)NULL);
+        if (!sender)
+            continue;
+
+        if (mover->GetTypeId() == TYPEID_PLAYER && mover->ToPlayer()->IsBeingTeleported())
+            continue;
+
+        BroadcastMovement(sender, mover, &itr->second.data, itr->second.data.GetOpcode() == MSG_MOVE_HEARTBEAT);
+    }
+
+    m_pendingMovement.clear();
+}
+
 void Map::Update(const uint32 &t_diff)
 {
+    PROFILE_ZONE_ARG("Map::Update", GetId());
+
+    if (m_pathCache)
+        m_pathCache->Update(getMSTime());
+
+    m_terrainCache.FlushStats();
+
     // update active cells around players and active objects
     resetMarkedCells();
 
@@ -585,6 +676,25 @@ void Map::Update(const uint32 &t_diff)
 
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
+    if (sWorld.getConfig(CONFIG_MAP_PACKET_PROCESSING))
+    {
+        // map-bound packets (movement, casts, melee) are handled here, on the thread updating this map
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* plr = m_mapRefIter->getSource();
+
+            if (!plr->IsInWorld())
+                continue;
+
+            WorldSession* pSession = plr->GetSession();
+            MapSessionFilter updater(pSession);
+            pSession->Update(t_diff, updater);
+        }
+    }
+
+    // heartbeats held back by this tick's movement packets
+    SendPendingMovement();
+
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
         Player* plr = m_mapRefIter->getSource();
@@ -594,10 +704,6 @@ void Map::Update(const uint32 &t_diff)
 
         // update players at tick
         plr->Update(t_diff);
-        //TODO: implement thread safe packets from BC?  Does this cause logout?
-        //WorldSession * pSession = plr->GetSession();
-        //MapSessionFilter updater(pSession);
-        //pSession->Update(t_diff, updater);
         VisitNearbyCellsOf(plr, grid_object_update, world_object_update);
     }
 
@@ -633,6 +739,8 @@ void Map::Update(const uint32 &t_diff)
 
     if (!m_mapRefManager.isEmpty() || !m_activeNonPlayers.empty())
         ProcessRelocationNotifies(t_diff);
+
+    SendObjectUpdates();
 }
 
 struct ResetNotifier
@@ -1038,6 +1146,8 @@ bool Map::UnloadGrid(const uint32 &x, const uint32 &y, bool unloadAll)
     int gx = (MAX_NUMBER_OF_GRIDS - 1) - x;
     int gy = (MAX_NUMBER_OF_GRIDS - 1) - y;
 
+    m_terrainCache.InvalidateGrid(gx, gy);
+
     // delete grid map, but don't delete if it is from parent map (and thus only reference)
     //+++if (GridMaps[gx][gy]) don't check for GridMaps[gx][gy], we might have to unload vmaps
     {
@@ -1622,6 +1732,35 @@ inline GridMap *Map::GetGrid(float x, float y)
     return GridMaps[gx][gy];
 }
 
+bool Map::IsGridMapLoaded(float x, float y) const
+{
+    int gx=(int)(32-x/SIZE_OF_GRIDS);
+    int gy=(int)(32-y/SIZE_OF_GRIDS);
+
+    if (gx < 0 || gx >= MAX_NUMBER_OF_GRIDS || gy < 0 || gy >= MAX_NUMBER_OF_GRIDS)
+        return false;
+
+    return GridMaps[gx][gy] != NULL;
+}
+
+float Map::GetVmapHeight(float x, float y, float z, float maxSearchDist) const
+{
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+
+    // other search distances are rare
+    if (maxSearchDist != DEFAULT_HEIGHT_SEARCH)
+        return vmgr->getHeight(GetId(), x, y, z + 2.0f, maxSearchDist);
+
+    float height;
+    if (m_terrainCache.GetVmapHeight(x, y, z, height))
+        return height;
+
+    // look from a bit higher pos to find the floor
+    height = vmgr->getHeight(GetId(), x, y, z + 2.0f, maxSearchDist);
+    m_terrainCache.SetVmapHeight(x, y, z, height);
+    return height;
+}
+
 float Map::GetHeight(float x, float y, float z, bool pUseVmaps, float maxSearchDist) const
 {
     // find raw .map surface under Z coordinates
@@ -1644,10 +1783,7 @@ float Map::GetHeight(float x, float y, float z, bool pUseVmaps, float maxSearchD
     {
         VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
         if (vmgr->isHeightCalcEnabled())
-        {
-            // look from a bit higher pos to find the floor
-            vmapHeight = vmgr->getHeight(GetId(), x, y, z + 2.0f, maxSearchDist);
-        }
+            vmapHeight = GetVmapHeight(x, y, z, maxSearchDist);    // the grid is loaded above
         else
             vmapHeight = VMAP_INVALID_HEIGHT_VALUE;
     }
@@ -1701,14 +1837,10 @@ inline bool IsOutdoorWMO(uint32 mogpFlags, uint32 mapId)
 
 bool Map::IsOutdoors(float x, float y, float z) const
 {
-    uint32 mogpFlags;
-    int32 adtId, rootId, groupId;
-
-    // no wmo found? -> outside by default
-    if (!GetAreaInfo(x, y, z, mogpFlags, adtId, rootId, groupId))
-        return true;
-
-    return IsOutdoorWMO(mogpFlags, i_mapEntry->MapID);
+    // same lookup as for the area, cached with it
+    bool outdoors;
+    GetAreaFlag(x, y, z, &outdoors);
+    return outdoors;
 }
 
 bool Map::GetAreaInfo(float x, float y, float z, uint32 &flags, int32 &adtId, int32 &rootId, int32 &groupId) const
@@ -1731,6 +1863,24 @@ bool Map::GetAreaInfo(float x, float y, float z, uint32 &flags, int32 &adtId, in
 }
 
 uint16 Map::GetAreaFlag(float x, float y, float z, bool *isOutdoors) const
+{
+    uint16 areaflag;
+    bool outdoors;
+    if (!m_terrainCache.GetArea(x, y, z, areaflag, outdoors))
+    {
+        // the vmaps are asked before the grid gets loaded, don't keep a result made without them
+        bool gridLoaded = IsGridMapLoaded(x, y);
+        areaflag = CalculateAreaFlag(x, y, z, &outdoors);
+        if (gridLoaded)
+            m_terrainCache.SetArea(x, y, z, areaflag, outdoors);
+    }
+
+    if (isOutdoors)
+        *isOutdoors = outdoors;
+    return areaflag;
+}
+
+uint16 Map::CalculateAreaFlag(float x, float y, float z, bool *isOutdoors) const
 {
     uint32 mogpFlags;
     int32 adtId, rootId, groupId;
@@ -2040,6 +2190,80 @@ void Map::DelayedUpdate(const uint32 t_diff)
             si_GridStates[grid->GetGridState()]->Update(*this, *grid, *info, grid->getX(), grid->getY(), t_diff);
         }
     }
+
+    // changes made after this map's update, by other maps or the world thread
+    SendObjectUpdates();
+}
+
+uint32 Map::GenerateLowGuid(HighGuid guidhigh)
+{
+    ObjectGuidBlock* block;
+    switch (guidhigh)
+    {
+        case HIGHGUID_UNIT:          block = &m_creatureGuids;   break;
+        case HIGHGUID_PET:           block = &m_petGuids;        break;
+        case HIGHGUID_GAMEOBJECT:    block = &m_gameObjectGuids; break;
+        case HIGHGUID_DYNAMICOBJECT: block = &m_dynObjectGuids;  break;
+        default:
+            return objmgr.GenerateLowGuid(guidhigh);
+    }
+
+    if (uint32 guid = block->Generate())
+        return guid;
+
+    // out of guids, reports the overflow
+    return objmgr.GenerateLowGuid(guidhigh);
+}
+
+PathCache& Map::GetPathCache()
+{
+    if (!m_pathCache)
+    {
+        m_pathCache = new PathCache;
+        m_pathCache->Update(getMSTime());
+    }
+
+    return *m_pathCache;
+}
+
+void Map::AddUpdateObject(Object* obj)
+{
+    BlizzLike::GeneralLock<ACE_Thread_Mutex> guard(i_objectsToUpdateLock);
+    i_objectsToUpdate.insert(obj);
+}
+
+void Map::RemoveUpdateObject(Object* obj)
+{
+    BlizzLike::GeneralLock<ACE_Thread_Mutex> guard(i_objectsToUpdateLock);
+    i_objectsToUpdate.erase(obj);
+}
+
+void Map::SendObjectUpdates()
+{
+    UpdateDataMapType update_players;
+
+    {
+        BlizzLike::GeneralLock<ACE_Thread_Mutex> guard(i_objectsToUpdateLock);
+
+        if (i_objectsToUpdate.empty())
+            return;
+
+        while (!i_objectsToUpdate.empty())
+        {
+            Object* obj = *i_objectsToUpdate.begin();
+            ASSERT(obj && obj->IsInWorld());
+            i_objectsToUpdate.erase(i_objectsToUpdate.begin());
+            obj->BuildUpdate(update_players);
+        }
+    }
+
+    WorldPacket packet;
+    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+    {
+        iter->second.BuildPacket(&packet);
+        iter->first->GetSession()->SendPacket(&packet);
+        packet.clear();
+    }
 }
 
 void Map::AddObjectToRemoveList(WorldObject *obj)
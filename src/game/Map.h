@@ -10,6 +10,7 @@
 #include "Policies/ThreadingModel.h"
 #include "ace/RW_Thread_Mutex.h"
 #include "ace/Thread_Mutex.h"
+#include "ace/Atomic_Op.h"
 
 #include "DBCStructure.h"
 #include "GridDefines.h"
@@ -18,6 +19,9 @@
 #include "SharedDefines.h"
 #include "GameSystem/GridRefManager.h"
 #include "MapRefManager.h"
+#include "WorldPacket.h"
+#include "ObjectGuid.h"
+#include "TerrainCache.h"
 
 #include <bitset>
 #include <list>
@@ -38,6 +42,7 @@ struct ScriptInfo;
 struct ScriptAction;
 struct Position;
 class BattleGround;
+class PathCache;
 namespace BlizzLike { struct ObjectUpdater; }
 
 struct ScriptAction
@@ -231,6 +236,23 @@ enum LevelRequirementVsMode
 
 typedef UNORDERED_MAP<Creature*, CreatureMover> CreatureMoveList;
 
+// last heartbeat of a mover, broadcast at the end of the map update
+struct PendingMovement
+{
+    uint64 senderGuid;                                      // charmer of a charmed mover, else the mover
+    WorldPacket data;
+};
+
+typedef UNORDERED_MAP<uint64, PendingMovement> PendingMovementMap;
+
+// counters of the movement broadcasts of all maps, observers are counted once per packet
+struct MovementBroadcastStats
+{
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> forwarded;        // packets queued to an observer
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> coalesced;        // heartbeats replaced by a later one of the same tick
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> decimated;        // heartbeats skipped for a distant observer
+};
+
 #define MAX_HEIGHT            100000.0f                     // can be use for find ground height at surface
 #define INVALID_HEIGHT       -100000.0f                     // for check, must be equal to VMAP_INVALID_HEIGHT, real value for unknown height is VMAP_INVALID_HEIGHT_VALUE
 #define MAX_FALL_DISTANCE     250000.0f                     // "unlimited fall" to find VMap ground if it is available, just larger than MAX_HEIGHT - INVALID_HEIGHT
@@ -274,6 +296,12 @@ class Map : public GridRefManager<NGridType>, public BlizzLike::ObjectLevelLocka
         */
 
         float GetVisibilityDistance() const { return m_VisibleDistance; }
+
+        // broadcasts a movement packet of mover, heartbeats may be held back until
+        // the end of this map's update and only the latest one of a mover is sent
+        void SendMovementMessage(Unit* sender, Unit* mover, WorldPacket* data);
+        static MovementBroadcastStats& GetMovementStats() { return s_movementStats; }
+
         //function for setting up visibility distance for maps on per-type/per-Id basis
         virtual void InitVisibilityDistance();
 
@@ -372,6 +400,11 @@ class Map : public GridRefManager<NGridType>, public BlizzLike::ObjectLevelLocka
         void AddObjectToSwitchList(WorldObject *obj, bool on);
         virtual void DelayedUpdate(const uint32 diff);
 
+        // objects of this map with changed fields, sent at the end of its update
+        void AddUpdateObject(Object* obj);
+        void RemoveUpdateObject(Object* obj);
+        void SendObjectUpdates();
+
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, CellPair cellpair);
         void UpdateObjectsVisibilityFor(Player* player, Cell cell, CellPair cellpair);
 
@@ -416,6 +449,12 @@ class Map : public GridRefManager<NGridType>, public BlizzLike::ObjectLevelLocka
 
         void UpdateIteratorBack(Player* player);
 
+        // guids for objects created in this map, taken from the map's own blocks
+        uint32 GenerateLowGuid(HighGuid guidhigh);
+
+        // poly paths searched by the units of this map, created on first use
+        PathCache& GetPathCache();
+
         TempSummon *SummonCreature(uint32 entry, const Position &pos, SummonPropertiesEntry const *properties = NULL, uint32 duration = 0, Unit* summoner = NULL, SpellEntry const* spellInfo = NULL);
         Creature* GetCreature(uint64 guid);
         GameObject* GetGameObject(uint64 guid);
@@ -462,6 +501,12 @@ class Map : public GridRefManager<NGridType>, public BlizzLike::ObjectLevelLocka
         void ScriptsProcess();
 
         void UpdateActiveCells(const float &x, const float &y, const uint32 &t_diff);
+
+        void BroadcastMovement(WorldObject* sender, WorldObject* mover, WorldPacket* data, bool heartbeat);
+        void SendPendingMovement();
+
+        PendingMovementMap m_pendingMovement;
+        static MovementBroadcastStats s_movementStats;
     protected:
         void SetUnloadReferenceLock(const GridPair &p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadReferenceLock(on); }
 
@@ -510,6 +555,21 @@ class Map : public GridRefManager<NGridType>, public BlizzLike::ObjectLevelLocka
         std::set<WorldObject *> i_objectsToRemove;
         std::map<WorldObject*, bool> i_objectsToSwitch;
         std::set<WorldObject*> i_worldObjects;
+        std::set<Object*> i_objectsToUpdate;
+        ACE_Thread_Mutex i_objectsToUpdateLock;
+
+        ObjectGuidBlock m_creatureGuids;
+        ObjectGuidBlock m_petGuids;
+        ObjectGuidBlock m_gameObjectGuids;
+        ObjectGuidBlock m_dynObjectGuids;
+
+        PathCache* m_pathCache;
+
+        // vmap results of GetHeight and results of GetAreaFlag
+        mutable TerrainCache m_terrainCache;
+        float GetVmapHeight(float x, float y, float z, float maxSearchDist) const;
+        uint16 CalculateAreaFlag(float x, float y, float z, bool *isOutdoors) const;
+        bool IsGridMapLoaded(float x, float y) const;
         std::multimap<time_t, ScriptAction> m_scriptSchedule;
 
         // Type specific code for add/remove to/from grid
@@ -17,6 +17,7 @@
 #include "CellImpl.h"
 #include "Corpse.h"
 #include "ObjectMgr.h"
+#include "TickProfiler.h"
 
 #define CLASS_LOCK BlizzLike::ClassLevelLockable<MapManager, ACE_Thread_Mutex>
 INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
@@ -57,6 +58,10 @@ void MapManager::Initialize()
     if (num_threads > 0 && m_updater.activate(num_threads) == -1)
         abort();
 
+    int path_threads(sWorld.getConfig(CONFIG_MMAP_PATH_THREADS));
+    if (path_threads > 0 && sWorld.getConfig(CONFIG_BOOL_MMAP_ENABLED) && m_pathfinding.activate(path_threads) == -1)
+        abort();
+
     InitMaxInstanceId();
 }
 
@@ -232,6 +237,15 @@ void MapManager::Update(time_t diff)
     if (!i_timer.Passed())
         return;
 
+    PROFILE_ZONE("MapManager::Update");
+
+    // paths requested during the last map updates are needed now
+    if (m_pathfinding.activated())
+    {
+        PROFILE_ZONE("PathfindingService::wait");
+        m_pathfinding.wait();
+    }
+
     MapMapType::iterator iter = i_maps.begin();
     for (; iter != i_maps.end(); ++iter)
     {
@@ -250,6 +264,9 @@ void MapManager::Update(time_t diff)
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
         (*iter)->Update(i_timer.GetCurrent());
 
+    if (m_pathfinding.activated())
+        m_pathfinding.start();
+
     i_timer.SetCurrent(0);
 }
 
@@ -275,6 +292,9 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    if (m_pathfinding.activated())
+        m_pathfinding.deactivate();
+
     for (MapMapType::iterator iter=i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnloadAll();
 
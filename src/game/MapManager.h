@@ -13,6 +13,7 @@
 #include "Map.h"
 #include "GridStates.h"
 #include "MapUpdater.h"
+#include "PathfindingService.h"
 
 class Transport;
 
@@ -117,6 +118,8 @@ class MapManager : public BlizzLike::Singleton<MapManager, BlizzLike::ClassLevel
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
 
+        PathfindingService& GetPathfindingService() { return m_pathfinding; }
+
     private:
         // debugging code, should be deleted some day
         void checkAndCorrectGridStatesArray();              // just for debugging to find some memory overwrites
@@ -143,6 +146,7 @@ class MapManager : public BlizzLike::Singleton<MapManager, BlizzLike::ClassLevel
 
         uint32 i_MaxInstanceId;
         MapUpdater m_updater;
+        PathfindingService m_pathfinding;
 };
 #endif
 
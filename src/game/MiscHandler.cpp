@@ -29,6 +29,7 @@
 #include "SpellAuras.h"
 #include "Pet.h"
 #include "SocialMgr.h"
+#include "WhoListMgr.h"
 #include "CellImpl.h"
 #include "AccountMgr.h"
 #include "ScriptMgr.h"
@@ -135,6 +136,13 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
     DEBUG_LOG("WORLD: Recvd CMSG_WHO Message");
     //recv_data.hexlike();
 
+    // add-ons tend to spam /who, drop requests over the per session limit
+    if (!sWhoListMgr.RegisterQuery(GetSecurity(), m_whoQueryWindowEnd, m_whoQueryCount))
+    {
+        recv_data.rpos(recv_data.wpos());                   // prevent warnings spam
+        return;
+    }
+
     uint32 clientcount = 0;
 
     uint32 level_min, level_max, racemask, classmask, zones_count, str_count;
@@ -197,6 +205,7 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
 
     uint32 team = _player->GetTeam();
     uint32 security = GetSecurity();
+    uint64 guid = _player->GetGUID();
     bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_ALLOW_TWO_SIDE_WHO_LIST);
     bool gmInWhoList         = sWorld.getConfig(CONFIG_GM_IN_WHO_LIST);
 
@@ -204,108 +213,78 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
     data << uint32(clientcount);                            // clientcount place holder, listed count
     data << uint32(clientcount);                            // clientcount place holder, online count
 
-    ObjectAccessor::Guard guard(*HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = ObjectAccessor::Instance().GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+    // work on the periodically rebuilt snapshot, no global player lock needed here
+    WhoListSnapshot_AutoPtr snapshot = sWhoListMgr.GetSnapshot();
+    WhoListSnapshot::PlayerInfoList const& players = snapshot->GetPlayers();
+
+    WhoListSnapshot::IndexList candidates;
+    snapshot->SelectCandidates(level_min, level_max, zoneids, zones_count, candidates);
+
+    for (WhoListSnapshot::IndexList::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
     {
+        WhoListPlayerInfo const& info = players[*itr];
+
         if (security == SEC_PLAYER)
         {
             // player can see member of other team only if CONFIG_ALLOW_TWO_SIDE_WHO_LIST
-            if (itr->second->GetTeam() != team && !allowTwoSideWhoList)
+            if (info.team != team && !allowTwoSideWhoList)
                 continue;
 
             // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
-            if ((itr->second->GetSession()->GetSecurity() > SEC_PLAYER && !gmInWhoList))
+            if (info.security > SEC_PLAYER && !gmInWhoList)
                 continue;
         }
 
-        //do not process players which are not in world
-        if (!(itr->second->IsInWorld()))
-            continue;
-
         // check if target is globally visible for player
-        if (!(itr->second->IsVisibleGloballyFor(_player)))
-            continue;
-
-        // check if target's level is in level range
-        uint32 lvl = itr->second->getLevel();
-        if (lvl < level_min || lvl > level_max)
+        if (!WhoListSnapshot::IsVisibleGloballyFor(info, guid, security))
             continue;
 
         // check if class matches classmask
-        uint32 class_ = itr->second->getClass();
-        if (!(classmask & (1 << class_)))
+        if (!(classmask & (1 << info.class_)))
             continue;
 
         // check if race matches racemask
-        uint32 race = itr->second->getRace();
-        if (!(racemask & (1 << race)))
-            continue;
-
-        uint32 pzoneid = itr->second->GetZoneId();
-        uint8 gender = itr->second->getGender();
-
-        bool z_show = true;
-        for (uint32 i = 0; i < zones_count; ++i)
-        {
-            if (zoneids[i] == pzoneid)
-            {
-                z_show = true;
-                break;
-            }
-
-            z_show = false;
-        }
-        if (!z_show)
-            continue;
-
-        std::string pname = itr->second->GetName();
-        std::wstring wpname;
-        if (!Utf8toWStr(pname,wpname))
+        if (!(racemask & (1 << info.race)))
             continue;
-        wstrToLower(wpname);
 
-        if (!(wplayer_name.empty() || wpname.find(wplayer_name) != std::wstring::npos))
+        if (!(wplayer_name.empty() || info.wname.find(wplayer_name) != std::wstring::npos))
             continue;
 
-        std::string gname = objmgr.GetGuildNameById(itr->second->GetGuildId());
-        std::wstring wgname;
-        if (!Utf8toWStr(gname,wgname))
+        if (!(wguild_name.empty() || info.wguildName.find(wguild_name) != std::wstring::npos))
             continue;
-        wstrToLower(wgname);
-
-        if (!(wguild_name.empty() || wgname.find(wguild_name) != std::wstring::npos))
-            continue;
-
-        std::string aname;
-        if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(itr->second->GetZoneId()))
-            aname = areaEntry->area_name[GetSessionDbcLocale()];
 
         bool s_show = true;
-        for (uint32 i = 0; i < str_count; ++i)
+        if (str_count)
         {
-            if (!str[i].empty())
+            std::string aname;
+            if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(info.zoneId))
+                aname = areaEntry->area_name[GetSessionDbcLocale()];
+
+            for (uint32 i = 0; i < str_count; ++i)
             {
-                if (wgname.find(str[i]) != std::wstring::npos ||
-                    wpname.find(str[i]) != std::wstring::npos ||
-                    Utf8FitTo(aname, str[i]))
+                if (!str[i].empty())
                 {
-                    s_show = true;
-                    break;
+                    if (info.wguildName.find(str[i]) != std::wstring::npos ||
+                        info.wname.find(str[i]) != std::wstring::npos ||
+                        Utf8FitTo(aname, str[i]))
+                    {
+                        s_show = true;
+                        break;
+                    }
+                    s_show = false;
                 }
-                s_show = false;
             }
         }
         if (!s_show)
             continue;
 
-        data << pname;                                      // player name
-        data << gname;                                      // guild name
-        data << uint32(lvl);                                // player level
-        data << uint32(class_);                             // player class
-        data << uint32(race);                               // player race
-        data << uint8(gender);                              // player gender
-        data << uint32(pzoneid);                            // player zone id
+        data << info.name;                                  // player name
+        data << info.guildName;                             // guild name
+        data << uint32(info.level);                         // player level
+        data << uint32(info.class_);                        // player class
+        data << uint32(info.race);                          // player race
+        data << uint8(info.gender);                         // player gender
+        data << uint32(info.zoneId);                        // player zone id
 
         // 49 is maximum player count sent to client - can be overridden
         // through config, but is unstable
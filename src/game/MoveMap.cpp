@@ -10,8 +10,22 @@
 #include "MoveMap.h"
 #include "MoveMapSharedDefines.h"
 
+#include <ace/TSS_T.h>
+#include <ace/Guard_T.h>
+
 namespace MMAP
 {
+    // mapId -> (generation of the mesh, query) of one thread
+    typedef UNORDERED_MAP<uint32, std::pair<uint32, dtNavMeshQuery*> > ThreadNavMeshQueries;
+
+    // not owning, the queries belong to MMapData
+    struct NavMeshQueryThreadSlot
+    {
+        ThreadNavMeshQueries queries;
+    };
+
+    ACE_TSS<NavMeshQueryThreadSlot> s_threadQueries;
+
     // ######################## MMapFactory ########################
     // our global singelton copy
     MMapManager *g_MMapManager = NULL;
@@ -73,14 +87,46 @@ namespace MMAP
         for (MMapDataSet::iterator i = loadedMMaps.begin(); i != loadedMMaps.end(); ++i)
             delete i->second;
 
+        for (MeshLockSet::iterator i = meshLocks.begin(); i != meshLocks.end(); ++i)
+            delete i->second;
+
         // by now we should not have maps loaded
         // if we had, tiles in MMapData->mmapLoadedTiles, their actual data is lost!
     }
 
+    uint32 MMapManager::getLoadedMapsCount() const
+    {
+        ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, mapsLock, 0);
+        return loadedMMaps.size();
+    }
+
+    ACE_RW_Thread_Mutex& MMapManager::GetMeshLock(uint32 mapId)
+    {
+        {
+            ACE_Read_Guard<ACE_RW_Thread_Mutex> guard(mapsLock);
+            MeshLockSet::const_iterator itr = meshLocks.find(mapId);
+            if (itr != meshLocks.end())
+                return *itr->second;
+        }
+
+        ACE_Write_Guard<ACE_RW_Thread_Mutex> guard(mapsLock);
+        ACE_RW_Thread_Mutex*& lock = meshLocks[mapId];
+        if (!lock)
+            lock = new ACE_RW_Thread_Mutex();
+        return *lock;
+    }
+
+    MMapData* MMapManager::findMapData(uint32 mapId) const
+    {
+        ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, mapsLock, NULL);
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        return itr != loadedMMaps.end() ? itr->second : NULL;
+    }
+
     bool MMapManager::loadMapData(uint32 mapId)
     {
         // we already have this map loaded?
-        if (loadedMMaps.find(mapId) != loadedMMaps.end())
+        if (findMapData(mapId))
             return true;
 
         // load and init dtNavMesh - read parameters from file
@@ -116,9 +162,10 @@ namespace MMAP
         sLog.outDetail("MMAP:loadMapData: Loaded %03i.mmap", mapId);
 
         // store inside our map list
-        MMapData* mmap_data = new MMapData(mesh);
+        MMapData* mmap_data = new MMapData(mesh, uint32(++lastGeneration));
         mmap_data->mmapLoadedTiles.clear();
 
+        ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, mapsLock, false);
         loadedMMaps.insert(std::pair<uint32, MMapData*>(mapId, mmap_data));
         return true;
     }
@@ -130,12 +177,14 @@ namespace MMAP
 
     bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
     {
+        ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, GetMeshLock(mapId), false);
+
         // make sure the mmap is loaded and ready to load tiles
         if(!loadMapData(mapId))
             return false;
 
         // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
+        MMapData* mmap = findMapData(mapId);
         ASSERT(mmap->navMesh);
 
         // check if we already have this tile loaded
@@ -213,16 +262,17 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
+        ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, GetMeshLock(mapId), false);
+
         // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = findMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             sLog.outDebug("MMAP:unloadMap: Asked to unload not loaded navmesh map. %03u%02i%02i.mmtile", mapId, x, y);
             return false;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
-
         // check if we have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
         if (mmap->mmapLoadedTiles.find(packedGridPos) == mmap->mmapLoadedTiles.end())
@@ -256,7 +306,10 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, GetMeshLock(mapId), false);
+
+        MMapData* mmap = findMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             sLog.outDebug("MMAP:unloadMap: Asked to unload not loaded navmesh map %03u", mapId);
@@ -264,7 +317,6 @@ namespace MMAP
         }
 
         // unload all tiles from given map
-        MMapData* mmap = loadedMMaps[mapId];
         for (MMapTileSet::iterator i = mmap->mmapLoadedTiles.begin(); i != mmap->mmapLoadedTiles.end(); ++i)
         {
             uint32 x = (i->first >> 16);
@@ -278,69 +330,52 @@ namespace MMAP
             }
         }
 
+        navMeshQueries -= long(mmap->navMeshQueries.size());
+        {
+            ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, mapsGuard, mapsLock, false);
+            loadedMMaps.erase(mapId);
+        }
         delete mmap;
-        loadedMMaps.erase(mapId);
         sLog.outDetail("MMAP:unloadMap: Unloaded %03i.mmap", mapId);
 
         return true;
     }
 
-    bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
+    dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
-        // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-        {
-            // file may not exist, therefore not loaded
-            sLog.outDebug("MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %03u", mapId);
-            return false;
-        }
-
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-        {
-            sLog.outDebug("MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
-            return false;
-        }
-
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
-
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
-        sLog.outDetail("MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
-
-        return true;
+        MMapData* mmap = findMapData(mapId);
+        return mmap ? mmap->navMesh : NULL;
     }
 
-    dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
+    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = findMapData(mapId);
+        if (!mmap)
             return NULL;
 
-        return loadedMMaps[mapId]->navMesh;
-    }
+        ThreadNavMeshQueries& queries = s_threadQueries->queries;
+        ThreadNavMeshQueries::iterator itr = queries.find(mapId);
+        if (itr != queries.end() && itr->second.first == mmap->generation)
+            return itr->second.second;
 
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
-    {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        // allocate mesh query
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        ASSERT(query);
+        if (DT_SUCCESS != query->init(mmap->navMesh, 1024))
+        {
+            dtFreeNavMeshQuery(query);
+            sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u", mapId);
             return NULL;
+        }
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
         {
-             // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            ASSERT(query);
-            if(DT_SUCCESS != query->init(mmap->navMesh, 1024))
-            {
-                dtFreeNavMeshQuery(query);
-                sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-                return NULL;
-            }
-
-            sLog.outDetail("MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mmap->navMeshQueriesLock, NULL);
+            mmap->navMeshQueries.push_back(query);
+            ++navMeshQueries;
         }
 
-        return mmap->navMeshQueries[instanceId];
+        sLog.outDetail("MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u", mapId);
+        queries[mapId] = std::make_pair(mmap->generation, query);
+        return query;
     }
 }
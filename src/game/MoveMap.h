@@ -8,6 +8,11 @@
 
 #include "Utilities/UnorderedMap.h"
 
+#include <ace/Atomic_Op.h>
+#include <ace/RW_Thread_Mutex.h>
+#include <ace/Thread_Mutex.h>
+#include <vector>
+
 #include "DetourAlloc.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
@@ -27,56 +32,73 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef UNORDERED_MAP<uint32, dtTileRef> MMapTileSet;
-    typedef UNORDERED_MAP<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::vector<dtNavMeshQuery*> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh, uint32 gen) : navMesh(mesh), generation(gen) {}
         ~MMapData()
         {
             for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
-                dtFreeNavMeshQuery(i->second);
+                dtFreeNavMeshQuery(*i);
 
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
 
         dtNavMesh* navMesh;
+        uint32 generation;                  // tells the threads their cached query belongs to an unloaded mesh
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // dtNavMeshQuery is not thread safe, every thread gets its own one, shared by
+        // all instances updated there; owned here, freed with the mesh
+        NavMeshQuerySet navMeshQueries;
+        ACE_Thread_Mutex navMeshQueriesLock;
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
     };
 
 
     typedef UNORDERED_MAP<uint32, MMapData*> MMapDataSet;
+    typedef UNORDERED_MAP<uint32, ACE_RW_Thread_Mutex*> MeshLockSet;
 
     // singelton class
     // holds all all access to mmap loading unloading and meshes
+    // the tiles of a map are loaded and unloaded under its own mesh lock,
+    // so maps updated by different threads do not wait for each other
     class MMapManager
     {
         public:
-            MMapManager() : loadedTiles(0) {}
+            MMapManager() : loadedTiles(0), navMeshQueries(0), lastGeneration(0) {}
             ~MMapManager();
 
             bool loadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
-            bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // query of the calling thread, only use it on that thread
+            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
-            uint32 getLoadedTilesCount() const { return loadedTiles; }
-            uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
+            uint32 getLoadedTilesCount() const { return uint32(loadedTiles.value()); }
+            uint32 getLoadedMapsCount() const;
+            uint32 getNavMeshQueriesCount() const { return uint32(navMeshQueries.value()); }
+
+            // held for reading by every search, the tiles and the mesh of the map
+            // change under the write lock
+            ACE_RW_Thread_Mutex& GetMeshLock(uint32 mapId);
         private:
             bool loadMapData(uint32 mapId);
+            MMapData* findMapData(uint32 mapId) const;
             uint32 packTileID(int32 x, int32 y);
 
+            // only written when a map gets or frees its mesh, or gets its mesh lock
             MMapDataSet loadedMMaps;
-            uint32 loadedTiles;
+            MeshLockSet meshLocks;          // kept until shutdown, a search may hold the lock of an unloaded map
+            mutable ACE_RW_Thread_Mutex mapsLock;
+
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> loadedTiles;
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> navMeshQueries;
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> lastGeneration;
     };
 
     // static class
@@ -277,7 +277,8 @@ void WorldSession::HandleMovementOpcodes(WorldPacket& recv_data)
             // elevators also cause the client to send MOVEFLAG_ONTRANSPORT - just unmount if the guid can be found in the transport list
             for (MapManager::TransportSet::iterator iter = MapManager::Instance().m_Transports.begin(); iter != MapManager::Instance().m_Transports.end(); ++iter)
             {
-                if ((*iter)->GetGUID() == movementInfo.t_guid)
+                // a transport of another map is updated by another thread, never board it
+                if ((*iter)->GetGUID() == movementInfo.t_guid && (*iter)->GetMapId() == plMover->GetMapId())
                 {
                     // unmount before boarding
                     plMover->RemoveSpellsCausingAura(SPELL_AURA_MOUNTED);
@@ -312,9 +313,9 @@ void WorldSession::HandleMovementOpcodes(WorldPacket& recv_data)
     data << mover->GetPackGUID();
     data.append(recv_data.contents(), recv_data.size());
     if (mover->isCharmed() && mover->GetCharmer())
-        mover->GetCharmer()->SendMessageToSet(&data, false);
+        mover->GetMap()->SendMovementMessage(mover->GetCharmer(), mover, &data);
     else
-        mover->SendMessageToSet(&data, false);
+        mover->GetMap()->SendMovementMessage(mover, mover, &data);
 
     mover->m_movementInfo = movementInfo;
     mover->SetPosition(movementInfo.GetPos()->GetPositionX(), movementInfo.GetPos()->GetPositionY(), movementInfo.GetPos()->GetPositionZ(), movementInfo.GetPos()->GetOrientation());
@@ -49,6 +49,8 @@ uint32 GuidHigh2TypeId(uint32 guid_hi)
     return TYPEID_OBJECT;                                   // unknown
 }
 
+ValuesUpdateStats Object::s_valuesUpdateStats;
+
 Object::Object()
 {
     m_objectTypeId      = TYPEID_OBJECT;
@@ -202,7 +204,12 @@ void Object::SendUpdateToPlayer(Player* player)
 void Object::BuildValuesUpdateBlockForPlayer(UpdateData *data, Player* target) const
 {
     ByteBuffer buf(500);
+    _BuildValuesUpdateBlock(buf, target);
+    data->AddUpdateBlock(buf);
+}
 
+void Object::_BuildValuesUpdateBlock(ByteBuffer& buf, Player* target) const
+{
     buf << (uint8) UPDATETYPE_VALUES;
     //buf << GetPackGUID();                                 //client crashes when using this. but not have crash in debug mode
     buf << (uint8)0xFF;
@@ -213,8 +220,43 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData *data, Player* target) c
 
     _SetUpdateBits(&updateMask, target);
     _BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
+}
 
-    data->AddUpdateBlock(buf);
+// Everything _SetUpdateBits and _BuildValuesUpdate make depend on the target
+uint32 Object::GetValuesUpdateClass(Player* target) const
+{
+    uint32 valuesClass = 0;
+
+    if (target == this)
+        valuesClass |= VALUES_UPDATE_CLASS_SELF;
+    if (target->isGameMaster())
+        valuesClass |= VALUES_UPDATE_CLASS_GM;
+
+    switch (GetTypeId())
+    {
+        case TYPEID_UNIT:
+            if (IsValueChanged(UNIT_DYNAMIC_FLAGS) && target->isAllowedToLoot(ToCreature()))
+                valuesClass |= VALUES_UPDATE_CLASS_LOOT;
+            break;
+        case TYPEID_PLAYER:
+            if (target != this && (IsValueChanged(UNIT_FIELD_BYTES_2) || IsValueChanged(UNIT_FIELD_FACTIONTEMPLATE)) &&
+                (target->IsInSameGroupWith(ToPlayer()) || target->IsInSameRaidWith(ToPlayer())))
+            {
+                // hostile group members are sent their own faction
+                if (IsValueChanged(UNIT_FIELD_FACTIONTEMPLATE))
+                    return VALUES_UPDATE_CLASS_UNIQUE;
+                valuesClass |= VALUES_UPDATE_CLASS_GROUP;
+            }
+            break;
+        case TYPEID_GAMEOBJECT:
+            if (!((GameObject*)this)->IsTransport() && ((GameObject*)this)->ActivateToQuest(target))
+                valuesClass |= VALUES_UPDATE_CLASS_QUEST;
+            break;
+        default:
+            break;
+    }
+
+    return valuesClass;
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData * data) const
@@ -681,12 +723,22 @@ void Object::ClearUpdateMask(bool remove)
     if (m_objectUpdated)
     {
         if (remove)
-            ObjectAccessor::Instance().RemoveUpdateObject(this);
+            RemoveFromObjectUpdate();
         m_objectUpdated = false;
     }
 }
 
-void Object::BuildFieldsUpdate(Player* pl, UpdateDataMapType &data_map) const
+void Object::AddToObjectUpdate()
+{
+    ObjectAccessor::Instance().AddUpdateObject(this);
+}
+
+void Object::RemoveFromObjectUpdate()
+{
+    ObjectAccessor::Instance().RemoveUpdateObject(this);
+}
+
+void Object::BuildFieldsUpdate(Player* pl, UpdateDataMapType &data_map, ValuesUpdateBlockCache* cache) const
 {
     UpdateDataMapType::iterator iter = data_map.find(pl);
 
@@ -697,7 +749,30 @@ void Object::BuildFieldsUpdate(Player* pl, UpdateDataMapType &data_map) const
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    uint32 valuesClass = cache ? GetValuesUpdateClass(pl) : uint32(VALUES_UPDATE_CLASS_UNIQUE);
+    if (valuesClass == VALUES_UPDATE_CLASS_UNIQUE)
+    {
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+        if (cache)
+            ++cache->built;
+        return;
+    }
+
+    // the block of an earlier recipient of the same class is reused as is
+    for (size_t i = 0; i < cache->blocks.size(); ++i)
+    {
+        if (cache->blocks[i].first == valuesClass)
+        {
+            iter->second.AddUpdateBlock(cache->blocks[i].second);
+            ++cache->shared;
+            return;
+        }
+    }
+
+    cache->blocks.push_back(std::make_pair(valuesClass, ByteBuffer()));
+    _BuildValuesUpdateBlock(cache->blocks.back().second, pl);
+    iter->second.AddUpdateBlock(cache->blocks.back().second);
+    ++cache->built;
 }
 
 bool Object::LoadValues(const char* data)
@@ -768,14 +843,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     {
         m_int32Values[ index ] = value;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -787,14 +855,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     {
         m_uint32Values[ index ] = value;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -806,14 +867,7 @@ void Object::SetUInt64Value(uint16 index, const uint64 &value)
         m_uint32Values[ index ] = *((uint32*)&value);
         m_uint32Values[ index + 1 ] = *(((uint32*)&value) + 1);
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -825,14 +879,7 @@ bool Object::AddUInt64Value(uint16 index, const uint64 &value)
         m_uint32Values[ index ] = *((uint32*)&value);
         m_uint32Values[ index + 1 ] = *(((uint32*)&value) + 1);
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
         return true;
     }
     return false;
@@ -846,14 +893,7 @@ bool Object::RemoveUInt64Value(uint16 index, const uint64 &value)
         m_uint32Values[ index ] = 0;
         m_uint32Values[ index + 1 ] = 0;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
         return true;
     }
     return false;
@@ -867,14 +907,7 @@ void Object::SetFloatValue(uint16 index, float value)
     {
         m_floatValues[ index ] = value;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -893,14 +926,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
         m_uint32Values[ index ] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[ index ] |= uint32(uint32(value) << (offset * 8));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -919,14 +945,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
         m_uint32Values[ index ] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[ index ] |= uint32(uint32(value) << (offset * 16));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -988,14 +1007,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     {
         m_uint32Values[ index ] = newval;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1011,14 +1023,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     {
         m_uint32Values[ index ] = newval;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1036,14 +1041,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     {
         m_uint32Values[ index ] |= uint32(uint32(newFlag) << (offset * 8));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1061,14 +1059,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     {
         m_uint32Values[ index ] &= ~uint32(uint32(oldFlag) << (offset * 8));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1090,9 +1081,10 @@ bool Position::HasInLine(const Unit* const target, float distance, float width)
 }
 
 WorldObject::WorldObject()
-    : WorldLocation(), m_InstanceId(0), m_currMap(NULL)
+    : WorldLocation(), m_InstanceId(0), m_currMap(NULL), m_updateQueueMap(NULL)
     , m_zoneScript(NULL)
     , m_isActive(false), m_isWorldObject(false)
+    , m_movementHeartbeats(0)
     , m_name("")
     , m_notifyflags(0), m_executed_notifies(0)
 {
@@ -1216,6 +1208,28 @@ bool WorldObject::IsWithinLOS(float ox, float oy, float oz) const
     return vMapManager->isInLineOfSight(GetMapId(), x, y, z+2.0f, ox, oy, oz+2.0f);
 }
 
+void WorldObject::IsWithinLOSInMap(WorldObject const* const* objs, uint8* results, uint32 count) const
+{
+    if (!count)
+        return;
+
+    std::vector<float> positions(count * 3);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        objs[i]->GetPosition(positions[i*3], positions[i*3+1], positions[i*3+2]);
+        positions[i*3+2] += 2.0f;
+    }
+
+    float x,y,z;
+    GetPosition(x,y,z);
+    VMAP::IVMapManager *vMapManager = VMAP::VMapFactory::createOrGetVMapManager();
+    vMapManager->isInLineOfSight(GetMapId(), x, y, z+2.0f, &positions[0], results, count);
+
+    for (uint32 i = 0; i < count; ++i)
+        if (!IsInMap(objs[i]))
+            results[i] = false;
+}
+
 bool WorldObject::GetDistanceOrder(WorldObject const* obj1, WorldObject const* obj2, bool is3D /* = true */) const
 {
     float dx1 = GetPositionX() - obj1->GetPositionX();
@@ -1550,14 +1564,7 @@ void WorldObject::SendPlaySound(uint32 Sound, bool OnlySelf)
 void Object::ForceValuesUpdateAtIndex(uint32 i)
 {
     m_uint32Values_mirror[i] = GetUInt32Value(i) + 1; // makes server think the field changed
-    if (m_inWorld)
-    {
-        if (!m_objectUpdated)
-        {
-            ObjectAccessor::Instance().AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
-    }
+    AddToObjectUpdateIfNeeded();
 }
 
 namespace BlizzLike
@@ -1725,6 +1732,33 @@ void WorldObject::SetMap(Map * map)
         m_currMap->AddWorldObject(this);
 }
 
+// changes of objects in a map are sent by the map itself, see Map::SendObjectUpdates
+void WorldObject::AddToObjectUpdate()
+{
+    if (m_currMap)
+    {
+        m_updateQueueMap = m_currMap;
+        m_updateQueueMap->AddUpdateObject(this);
+    }
+    else
+        Object::AddToObjectUpdate();
+}
+
+void WorldObject::RemoveFromObjectUpdate()
+{
+    // not queued, m_updateQueueMap may name a map that is gone by now
+    if (!m_objectUpdated)
+        return;
+
+    if (m_updateQueueMap)
+    {
+        m_updateQueueMap->RemoveUpdateObject(this);
+        m_updateQueueMap = NULL;
+    }
+    else
+        Object::RemoveFromObjectUpdate();
+}
+
 void WorldObject::ResetMap()
 {
     ASSERT(m_currMap);
@@ -1824,7 +1858,7 @@ TempSummon *Map::SummonCreature(uint32 entry, const Position &pos, SummonPropert
             return NULL;
     }
 
-    if (!summon->Create(objmgr.GenerateLowGuid(HIGHGUID_UNIT), this, entry, team, pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), pos.GetOrientation()))
+    if (!summon->Create(GenerateLowGuid(HIGHGUID_UNIT), this, entry, team, pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), pos.GetOrientation()))
     {
         delete summon;
         return NULL;
@@ -1914,7 +1948,7 @@ Pet* Player::SummonPet(uint32 entry, float x, float y, float z, float ang, PetTy
 
     Map *map = GetMap();
     uint32 pet_number = objmgr.GeneratePetNumber();
-    if (!pet->Create(objmgr.GenerateLowGuid(HIGHGUID_PET), map, entry, pet_number))
+    if (!pet->Create(map->GenerateLowGuid(HIGHGUID_PET), map, entry, pet_number))
     {
         sLog.outError("no such creature entry %u", entry);
         delete pet;
@@ -2002,7 +2036,7 @@ GameObject* WorldObject::SummonGameObject(uint32 entry, float x, float y, float
     }
     Map *map = GetMap();
     GameObject* go = new GameObject();
-    if (!go->Create(objmgr.GenerateLowGuid(HIGHGUID_GAMEOBJECT),entry,map,x,y,z,ang,rotation0,rotation1,rotation2,rotation3,100,GO_STATE_READY))
+    if (!go->Create(map->GenerateLowGuid(HIGHGUID_GAMEOBJECT),entry,map,x,y,z,ang,rotation0,rotation1,rotation2,rotation3,100,GO_STATE_READY))
     {
         delete go;
         return NULL;
@@ -2218,6 +2252,7 @@ struct WorldObjectChangeAccumulator
     UpdateDataMapType &i_updateDatas;
     WorldObject &i_object;
     std::set<uint64> plr_list;
+    ValuesUpdateBlockCache i_blocks;
     WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj) {}
     void Visit(PlayerMapType &m)
     {
@@ -2264,7 +2299,7 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (plr_list.find(plr->GetGUID()) == plr_list.end() && plr->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(plr, i_updateDatas);
+            i_object.BuildFieldsUpdate(plr, i_updateDatas, &i_blocks);
             plr_list.insert(plr->GetGUID());
         }
     }
@@ -2284,6 +2319,12 @@ void WorldObject::BuildUpdate(UpdateDataMapType& data_map)
     //we must build packets for all visible players
     cell.Visit(p, player_notifier, map, *this, map.GetVisibilityDistance());
 
+    ValuesUpdateStats& stats = GetValuesUpdateStats();
+    stats.built += notifier.i_blocks.built;
+    stats.shared += notifier.i_blocks.shared;
+
+    // the queue holding the object has just dequeued it
+    m_updateQueueMap = NULL;
     ClearUpdateMask(false);
 }
 
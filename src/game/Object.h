@@ -15,8 +15,11 @@
 #include "GridDefines.h"
 #include "Map.h"
 
+#include <ace/Atomic_Op.h>
+
 #include <set>
 #include <string>
+#include <vector>
 
 #define CONTACT_DISTANCE            0.5f
 #define INTERACTION_DISTANCE        7.0f
@@ -118,6 +121,34 @@ class Unit;
 
 typedef UNORDERED_MAP<Player*, UpdateData> UpdateDataMapType;
 
+// Recipients of the same class get byte-identical values update blocks of an object
+enum ValuesUpdateClass
+{
+    VALUES_UPDATE_CLASS_SELF    = 0x01,                     // player's own fields
+    VALUES_UPDATE_CLASS_GM      = 0x02,                     // gamemaster view of flags and trigger models
+    VALUES_UPDATE_CLASS_LOOT    = 0x04,                     // allowed to loot the creature
+    VALUES_UPDATE_CLASS_GROUP   = 0x08,                     // group member of the player
+    VALUES_UPDATE_CLASS_QUEST   = 0x10,                     // gameobject activated for the recipient's quests
+    VALUES_UPDATE_CLASS_UNIQUE  = 0xFFFFFFFF                // built for the recipient alone
+};
+
+// Values update blocks of one object change, one per recipient class
+struct ValuesUpdateBlockCache
+{
+    ValuesUpdateBlockCache() : built(0), shared(0) {}
+
+    std::vector<std::pair<uint32, ByteBuffer> > blocks;
+    uint32 built;
+    uint32 shared;                                          // recipients which got an already built block
+};
+
+// counters of the values update blocks sent by ObjectAccessor::Update
+struct ValuesUpdateStats
+{
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> built;
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> shared;
+};
+
 class Object
 {
     public:
@@ -304,6 +335,7 @@ class Object
         }
 
         void ClearUpdateMask(bool remove);
+        virtual void RemoveFromObjectUpdate();
 
         bool LoadValues(const char* data);
 
@@ -312,7 +344,9 @@ class Object
         virtual bool hasQuest(uint32 /* quest_id */) const { return false; }
         virtual bool hasInvolvedQuest(uint32 /* quest_id */) const { return false; }
         virtual void BuildUpdate(UpdateDataMapType&) {}
-        void BuildFieldsUpdate(Player*, UpdateDataMapType &) const;
+        void BuildFieldsUpdate(Player*, UpdateDataMapType &, ValuesUpdateBlockCache* cache = NULL) const;
+        uint32 GetValuesUpdateClass(Player* target) const;
+        static ValuesUpdateStats& GetValuesUpdateStats() { return s_valuesUpdateStats; }
 
         // FG: some hacky helpers
         void ForceValuesUpdateAtIndex(uint32);
@@ -337,6 +371,17 @@ class Object
         virtual void _SetCreateBits(UpdateMask *updateMask, Player* target) const;
         void _BuildMovementUpdate(ByteBuffer * data, uint8 updateFlags) const;
         void _BuildValuesUpdate(uint8 updatetype, ByteBuffer *data, UpdateMask *updateMask, Player* target) const;
+        void _BuildValuesUpdateBlock(ByteBuffer& buf, Player* target) const;
+
+        void AddToObjectUpdateIfNeeded()
+        {
+            if (m_inWorld && !m_objectUpdated)
+            {
+                AddToObjectUpdate();
+                m_objectUpdated = true;
+            }
+        }
+        virtual void AddToObjectUpdate();
 
         uint16 m_objectType;
 
@@ -357,6 +402,10 @@ class Object
         bool m_objectUpdated;
 
     private:
+        bool IsValueChanged(uint16 index) const { return m_uint32Values[index] != m_uint32Values_mirror[index]; }
+
+        static ValuesUpdateStats s_valuesUpdateStats;
+
         bool m_inWorld;
 
         PackedGuid m_PackGUID;
@@ -664,6 +713,26 @@ class WorldObject : public Object, public WorldLocation
         }
         bool IsWithinLOS(float x, float y, float z) const;
         bool IsWithinLOSInMap(const WorldObject* obj) const;
+        // results[i] as IsWithinLOSInMap(objs[i]), the vmap rays are traced in one batch
+        void IsWithinLOSInMap(WorldObject const* const* objs, uint8* results, uint32 count) const;
+        template<class L> void RemoveNotWithinLOSInMap(L& objs) const
+        {
+            if (objs.empty())
+                return;
+
+            std::vector<WorldObject const*> checked(objs.begin(), objs.end());
+            std::vector<uint8> results(checked.size());
+            IsWithinLOSInMap(&checked[0], &results[0], checked.size());
+
+            uint32 i = 0;
+            for (typename L::iterator itr = objs.begin(); itr != objs.end(); ++i)
+            {
+                if (results[i])
+                    ++itr;
+                else
+                    objs.erase(itr++);
+            }
+        }
         bool GetDistanceOrder(WorldObject const* obj1, WorldObject const* obj2, bool is3D = true) const;
         bool IsInRange(WorldObject const* obj, float minRange, float maxRange, bool is3D = true) const;
         bool IsInRange2d(float x, float y, float minRange, float maxRange) const;
@@ -710,6 +779,7 @@ class WorldObject : public Object, public WorldLocation
 
         virtual void SetMap(Map * map);
         virtual void ResetMap();
+        void RemoveFromObjectUpdate();
         Map * GetMap() const { ASSERT(m_currMap); return m_currMap; }
         Map * FindMap() const { return m_currMap; }
         //used to check all object's GetMap() calls when object is not in world!
@@ -764,6 +834,7 @@ class WorldObject : public Object, public WorldLocation
         bool m_isWorldObject;
 
         MovementInfo m_movementInfo;
+        uint32 m_movementHeartbeats;                        // broadcast heartbeats, drives the distance decimation
 
     protected:
         explicit WorldObject();
@@ -777,8 +848,11 @@ class WorldObject : public Object, public WorldLocation
         void SetLocationMapId(uint32 _mapId) { m_mapId = _mapId; }
         void SetLocationInstanceId(uint32 _instanceId) { m_InstanceId = _instanceId; }
 
+        void AddToObjectUpdate();
+
     private:
         Map * m_currMap;                                    //current object's Map location
+        Map * m_updateQueueMap;                             // map whose dirty queue holds the object
 
         //uint32 m_mapId;                                     // object at map with map_id
         uint32 m_InstanceId;                                // in map copy with instance id
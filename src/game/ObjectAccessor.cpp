@@ -24,6 +24,7 @@
 #include "ObjectGuid.h"
 #include "MapInstanced.h"
 #include "World.h"
+#include "TickProfiler.h"
 
 #include <cmath>
 
@@ -31,7 +32,8 @@
 INSTANTIATE_SINGLETON_2(ObjectAccessor, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(ObjectAccessor, ACE_Thread_Mutex);
 
-ObjectAccessor::ObjectAccessor()
+ObjectAccessor::ObjectAccessor() : i_valuesBlocksBuilt(0), i_valuesBlocksShared(0),
+    i_valuesBlocksBuiltTotal(0), i_valuesBlocksSharedTotal(0)
 {
 }
 
@@ -325,8 +327,11 @@ void ObjectAccessor::RemoveOldCorpses()
 
 void ObjectAccessor::Update(uint32 /*diff*/)
 {
+    PROFILE_ZONE("ObjectAccessor::Update");
+
     UpdateDataMapType update_players;
 
+    // objects in a map are sent by its update, only the remaining ones (items) are queued here
     // Critical section
     {
         Guard guard(i_updateGuard);
@@ -340,6 +345,14 @@ void ObjectAccessor::Update(uint32 /*diff*/)
         }
     }
 
+    ValuesUpdateStats& stats = Object::GetValuesUpdateStats();
+    long built = stats.built.value();
+    long shared = stats.shared.value();
+    i_valuesBlocksBuilt = uint32(built - i_valuesBlocksBuiltTotal);
+    i_valuesBlocksShared = uint32(shared - i_valuesBlocksSharedTotal);
+    i_valuesBlocksBuiltTotal = built;
+    i_valuesBlocksSharedTotal = shared;
+
     WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
     for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
     {
@@ -184,7 +184,7 @@ class ObjectAccessor : public BlizzLike::Singleton<ObjectAccessor, BlizzLike::Cl
         void RemoveObject(Player* pl)
         {
             HashMapHolder<Player>::Remove(pl);
-            RemoveUpdateObject((Object*)pl);
+            pl->RemoveFromObjectUpdate();
         }
 
         void SaveAllPlayers();
@@ -203,6 +203,10 @@ class ObjectAccessor : public BlizzLike::Singleton<ObjectAccessor, BlizzLike::Cl
 
         void Update(uint32 diff);
 
+        // values update blocks of the last tick (map updates included), serialized and reused for further recipients
+        uint32 GetLastValuesBlocksBuilt() const { return i_valuesBlocksBuilt; }
+        uint32 GetLastValuesBlocksShared() const { return i_valuesBlocksShared; }
+
         Corpse* GetCorpseForPlayerGUID(uint64 guid);
         void RemoveCorpse(Corpse* corpse);
         void AddCorpse(Corpse* corpse);
@@ -222,6 +226,10 @@ class ObjectAccessor : public BlizzLike::Singleton<ObjectAccessor, BlizzLike::Cl
         void _update();
 
         std::set<Object*> i_objects;
+        uint32 i_valuesBlocksBuilt;
+        uint32 i_valuesBlocksShared;
+        long i_valuesBlocksBuiltTotal;
+        long i_valuesBlocksSharedTotal;
 
         LockType i_updateGuard;
         LockType i_corpseGuard;
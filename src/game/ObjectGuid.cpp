@@ -60,3 +60,116 @@ ByteBuffer &operator>>(ByteBuffer& buf, PackedGuidReader const& guid)
     return buf;
 }
 
+
+ObjectGuidGenerator::ObjectGuidGenerator(uint32 maxGuid)
+    : m_next(1), m_maxGuid(maxGuid), m_recycleDelay(0), m_blockSize(1), m_freeCount(0)
+{
+}
+
+uint32 ObjectGuidGenerator::Reserve(uint32 count)
+{
+    // past the end the counter is left alone, it must not wrap around
+    if (m_next.value() > m_maxGuid)
+        return 0;
+
+    unsigned long end = (m_next += count);
+    unsigned long first = end - count;
+    if (end < first || end - 1 > m_maxGuid)
+        return 0;
+
+    return uint32(first);
+}
+
+uint32 ObjectGuidGenerator::Generate()
+{
+    std::vector<uint32> guids;
+    if (TakeRecycled(guids, 1, false))
+        return guids[0];
+
+    if (uint32 guid = Reserve(1))
+        return guid;
+
+    return TakeRecycled(guids, 1, true) ? guids[0] : 0;
+}
+
+uint32 ObjectGuidGenerator::TakeRecycled(std::vector<uint32>& guids, uint32 count, bool ignoreDelay)
+{
+    // nothing was recycled, always the case with a delay of 0
+    if (!m_freeCount.value())
+        return 0;
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_freeLock, 0);
+
+    time_t now = time(NULL);
+    uint32 taken = 0;
+    while (taken < count && !m_free.empty())
+    {
+        if (!ignoreDelay && m_free.front().first + time_t(m_recycleDelay) > now)
+            break;
+
+        guids.push_back(m_free.front().second);
+        m_free.pop_front();
+        --m_freeCount;
+        ++taken;
+    }
+
+    return taken;
+}
+
+void ObjectGuidGenerator::Recycle(uint32 guid)
+{
+    if (!m_recycleDelay || !guid)
+        return;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_freeLock);
+    m_free.push_back(FreeGuid(time(NULL), guid));
+    ++m_freeCount;
+}
+
+uint32 ObjectGuidGenerator::GetRecycledCount() const
+{
+    return uint32(m_freeCount.value());
+}
+
+ObjectGuidBlock::~ObjectGuidBlock()
+{
+    // not used yet, they just wait the recycle delay once more
+    for (; m_next < m_end; ++m_next)
+        m_generator.Recycle(m_next);
+
+    for (size_t i = 0; i < m_recycled.size(); ++i)
+        m_generator.Recycle(m_recycled[i]);
+}
+
+void ObjectGuidBlock::Refill()
+{
+    uint32 size = m_generator.GetBlockSize();
+
+    if (m_generator.TakeRecycled(m_recycled, size, false))
+        return;
+
+    if (uint32 first = m_generator.Reserve(size))
+    {
+        m_next = first;
+        m_end = first + size;
+        return;
+    }
+
+    // counter exhausted, free guids are all that is left
+    m_generator.TakeRecycled(m_recycled, size, true);
+}
+
+uint32 ObjectGuidBlock::Generate()
+{
+    if (m_recycled.empty() && m_next == m_end)
+        Refill();
+
+    if (!m_recycled.empty())
+    {
+        uint32 guid = m_recycled.back();
+        m_recycled.pop_back();
+        return guid;
+    }
+
+    return m_next < m_end ? m_next++ : 0;
+}
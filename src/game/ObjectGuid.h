@@ -9,6 +9,12 @@
 #include "Common.h"
 #include "ByteBuffer.h"
 
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+#include <deque>
+#include <vector>
+
 enum TypeID
 {
     TYPEID_OBJECT        = 0,
@@ -221,5 +227,71 @@ ByteBuffer& operator>> (ByteBuffer& buf, PackedGuidReader const& guid);
 
 inline PackedGuid ObjectGuid::WriteAsPacked() const { return PackedGuid(*this); }
 
+// Low guid counter of one high guid type, may be used from any thread.
+//
+// New guids are taken from the counter with an atomic add, singly or as a
+// block for an ObjectGuidBlock. Guids of temporary objects can be given
+// back; they are handed out again once they were free for the recycle
+// delay, so clients and scripts had time to forget the old object. When
+// the counter is exhausted free guids are used regardless of their age.
+// A script that keeps a raw uint64 guid of a temporary creature for longer
+// than the delay may find a new, unrelated creature under it.
+class ObjectGuidGenerator
+{
+    public:
+        explicit ObjectGuidGenerator(uint32 maxGuid);
+
+        void Set(uint32 next) { m_next = next; }
+        uint32 GetNextAfterMaxUsed() const { return uint32(m_next.value()); }
+
+        // recycle delay in seconds, 0 disables recycling
+        void SetRecycleDelay(uint32 delay) { m_recycleDelay = delay; }
+        void SetBlockSize(uint32 size) { m_blockSize = size ? size : 1; }
+        uint32 GetBlockSize() const { return m_blockSize; }
+
+        // 0 if no guid is left
+        uint32 Generate();
+        // first of count consecutive new guids, 0 if they don't fit any more
+        uint32 Reserve(uint32 count);
+        // moves up to count free guids to guids, returns the number taken
+        uint32 TakeRecycled(std::vector<uint32>& guids, uint32 count, bool ignoreDelay);
+        void Recycle(uint32 guid);
+
+        uint32 GetRecycledCount() const;
+
+    private:
+        typedef std::pair<time_t, uint32> FreeGuid;         // time the guid was freed, guid
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, unsigned long> m_next;
+        uint32 m_maxGuid;
+        uint32 m_recycleDelay;
+        uint32 m_blockSize;
+
+        mutable ACE_Thread_Mutex m_freeLock;
+        std::deque<FreeGuid> m_free;                        // oldest first
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_freeCount;  // size of m_free, read without the lock
+};
+
+// Guids a map hands out to the objects it creates, taken from the generator
+// a block at a time. Not thread-safe, only the thread updating the map uses it.
+// Unused guids go back to the generator when the block is destroyed.
+class ObjectGuidBlock
+{
+    public:
+        explicit ObjectGuidBlock(ObjectGuidGenerator& generator) : m_generator(generator), m_next(0), m_end(0) {}
+        ~ObjectGuidBlock();
+
+        // 0 if no guid is left
+        uint32 Generate();
+
+    private:
+        void Refill();
+
+        ObjectGuidGenerator& m_generator;
+        uint32 m_next;                                      // unused range of new guids [m_next, m_end)
+        uint32 m_end;
+        std::vector<uint32> m_recycled;
+};
+
 #endif
 
@@ -182,15 +182,15 @@ LanguageDesc const* GetLanguageDescByID(uint32 lang)
     return NULL;
 }
 
-ObjectMgr::ObjectMgr()
-{
-    m_hiCharGuid        = 1;
-    m_hiCreatureGuid    = 1;
-    m_hiPetGuid         = 1;
-    m_hiItemGuid        = 1;
-    m_hiGoGuid          = 1;
-    m_hiDoGuid          = 1;
-    m_hiCorpseGuid      = 1;
+ObjectMgr::ObjectMgr() :
+    m_hiCharGuid(0xFFFFFFFD),
+    m_hiCreatureGuid(0x00FFFFFD),
+    m_hiPetGuid(0x00FFFFFD),
+    m_hiItemGuid(0xFFFFFFFD),
+    m_hiGoGuid(0x00FFFFFD),
+    m_hiDoGuid(0xFFFFFFFD),
+    m_hiCorpseGuid(0xFFFFFFFD)
+{
     m_hiPetNumber       = 1;
     m_ItemTextId        = 1;
     m_mailid            = 1;
@@ -5296,28 +5296,29 @@ void ObjectMgr::SetHighestGuids()
 {
     QueryResult_AutoPtr result = CharacterDatabase.Query("SELECT MAX(guid) FROM characters");
     if (result)
-        m_hiCharGuid = (*result)[0].GetUInt32()+1;
+        m_hiCharGuid.Set((*result)[0].GetUInt32()+1);
 
     result = WorldDatabase.Query("SELECT MAX(guid) FROM creature");
     if (result)
-        m_hiCreatureGuid = (*result)[0].GetUInt32()+1;
+        m_hiCreatureGuid.Set((*result)[0].GetUInt32()+1);
 
-    // pet guids are not saved to DB, set to 0 (pet guid != pet id)
-    m_hiPetGuid = 0;
+    // pet guids are not saved to DB, start from 1 (pet guid != pet id)
+    m_hiPetGuid.Set(1);
 
     result = CharacterDatabase.Query("SELECT MAX(guid) FROM item_instance");
     if (result)
-        m_hiItemGuid = (*result)[0].GetUInt32()+1;
+        m_hiItemGuid.Set((*result)[0].GetUInt32()+1);
 
     // Cleanup other tables from not existed guids ( >= m_hiItemGuid)
-    CharacterDatabase.PExecute("DELETE FROM character_inventory WHERE item >= '%u'", m_hiItemGuid);
-    CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid >= '%u'", m_hiItemGuid);
-    CharacterDatabase.PExecute("DELETE FROM auctionhouse WHERE itemguid >= '%u'", m_hiItemGuid);
-    CharacterDatabase.PExecute("DELETE FROM guild_bank_item WHERE item_guid >= '%u'", m_hiItemGuid);
+    uint32 hiItemGuid = m_hiItemGuid.GetNextAfterMaxUsed();
+    CharacterDatabase.PExecute("DELETE FROM character_inventory WHERE item >= '%u'", hiItemGuid);
+    CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid >= '%u'", hiItemGuid);
+    CharacterDatabase.PExecute("DELETE FROM auctionhouse WHERE itemguid >= '%u'", hiItemGuid);
+    CharacterDatabase.PExecute("DELETE FROM guild_bank_item WHERE item_guid >= '%u'", hiItemGuid);
 
     result = WorldDatabase.Query("SELECT MAX(guid) FROM gameobject");
     if (result)
-        m_hiGoGuid = (*result)[0].GetUInt32()+1;
+        m_hiGoGuid.Set((*result)[0].GetUInt32()+1);
 
     result = CharacterDatabase.Query("SELECT MAX(id) FROM auctionhouse");
     if (result)
@@ -5333,7 +5334,15 @@ void ObjectMgr::SetHighestGuids()
 
     result = CharacterDatabase.Query("SELECT MAX(guid) FROM corpse");
     if (result)
-        m_hiCorpseGuid = (*result)[0].GetUInt32()+1;
+        m_hiCorpseGuid.Set((*result)[0].GetUInt32()+1);
+
+    // guids of temporary objects, handed out by the maps in blocks
+    ObjectGuidGenerator* mapGuids[] = { &m_hiCreatureGuid, &m_hiPetGuid, &m_hiGoGuid, &m_hiDoGuid };
+    for (uint8 i = 0; i < 4; ++i)
+    {
+        mapGuids[i]->SetBlockSize(sWorld.getConfig(CONFIG_GUID_MAP_BLOCK_SIZE));
+        mapGuids[i]->SetRecycleDelay(sWorld.getConfig(CONFIG_GUID_RECYCLE_DELAY));
+    }
 
     result = CharacterDatabase.Query("SELECT MAX(arenateamid) FROM arena_team");
     if (result)
@@ -5408,65 +5417,35 @@ uint32 ObjectMgr::CreateItemText(std::string text)
     return newItemTextId;
 }
 
-uint32 ObjectMgr::GenerateLowGuid(HighGuid guidhigh)
+ObjectGuidGenerator& ObjectMgr::GetGuidGenerator(HighGuid guidhigh)
 {
     switch(guidhigh)
     {
-        case HIGHGUID_ITEM:
-            if (m_hiItemGuid >= 0xFFFFFFFE)
-            {
-                sLog.outError("Item guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiItemGuid++;
-        case HIGHGUID_UNIT:
-            if (m_hiCreatureGuid >= 0x00FFFFFE)
-            {
-                sLog.outError("Creature guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiCreatureGuid++;
-        case HIGHGUID_PET:
-            if (m_hiPetGuid >= 0x00FFFFFE)
-            {
-                sLog.outError("Pet guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiPetGuid++;
-        case HIGHGUID_PLAYER:
-            if (m_hiCharGuid >= 0xFFFFFFFE)
-            {
-                sLog.outError("Players guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiCharGuid++;
-        case HIGHGUID_GAMEOBJECT:
-            if (m_hiGoGuid >= 0x00FFFFFE)
-            {
-                sLog.outError("Gameobject guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiGoGuid++;
-        case HIGHGUID_CORPSE:
-            if (m_hiCorpseGuid >= 0xFFFFFFFE)
-            {
-                sLog.outError("Corpse guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiCorpseGuid++;
-        case HIGHGUID_DYNAMICOBJECT:
-            if (m_hiDoGuid >= 0xFFFFFFFE)
-            {
-                sLog.outError("DynamicObject guid overflow!! Can't continue, shutting down server. ");
-                World::StopNow(ERROR_EXIT_CODE);
-            }
-            return m_hiDoGuid++;
+        case HIGHGUID_ITEM:          return m_hiItemGuid;
+        case HIGHGUID_UNIT:          return m_hiCreatureGuid;
+        case HIGHGUID_PET:           return m_hiPetGuid;
+        case HIGHGUID_PLAYER:        return m_hiCharGuid;
+        case HIGHGUID_GAMEOBJECT:    return m_hiGoGuid;
+        case HIGHGUID_CORPSE:        return m_hiCorpseGuid;
+        case HIGHGUID_DYNAMICOBJECT: return m_hiDoGuid;
         default:
             ASSERT(0);
     }
 
     ASSERT(0);
-    return 0;
+    return m_hiItemGuid;
+}
+
+uint32 ObjectMgr::GenerateLowGuid(HighGuid guidhigh)
+{
+    uint32 guid = GetGuidGenerator(guidhigh).Generate();
+    if (!guid)
+    {
+        sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", ObjectGuid(guidhigh, 0, 1).GetTypeName());
+        World::StopNow(ERROR_EXIT_CODE);
+    }
+
+    return guid;
 }
 
 void ObjectMgr::LoadGameObjectLocales()
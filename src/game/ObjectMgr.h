@@ -794,6 +794,8 @@ class ObjectMgr
 
         void SetHighestGuids();
         uint32 GenerateLowGuid(HighGuid guidhigh);
+        ObjectGuidGenerator& GetGuidGenerator(HighGuid guidhigh);
+        void RecycleLowGuid(HighGuid guidhigh, uint32 guid) { GetGuidGenerator(guidhigh).Recycle(guid); }
         uint32 GenerateAuctionID();
         uint32 GenerateMailID();
         uint32 GenerateItemTextID();
@@ -1021,14 +1023,14 @@ class ObjectMgr
         uint32 m_guildId;
         uint32 m_hiPetNumber;
 
-        // first free low guid for seelcted guid type
-        uint32 m_hiCharGuid;
-        uint32 m_hiCreatureGuid;
-        uint32 m_hiPetGuid;
-        uint32 m_hiItemGuid;
-        uint32 m_hiGoGuid;
-        uint32 m_hiDoGuid;
-        uint32 m_hiCorpseGuid;
+        // low guid counters for selected guid type
+        ObjectGuidGenerator m_hiCharGuid;
+        ObjectGuidGenerator m_hiCreatureGuid;
+        ObjectGuidGenerator m_hiPetGuid;
+        ObjectGuidGenerator m_hiItemGuid;
+        ObjectGuidGenerator m_hiGoGuid;
+        ObjectGuidGenerator m_hiDoGuid;
+        ObjectGuidGenerator m_hiCorpseGuid;
 
         QuestMap            mQuestTemplates;
 
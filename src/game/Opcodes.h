@@ -1091,6 +1091,13 @@ enum SessionStatus
     STATUS_NEVER                                            // Opcode not accepted from client (deprecated or server side only)
 };
 
+// Thread a packet may be handled in
+enum PacketProcessing
+{
+    PROCESS_THREADUNSAFE = 0,                               // world thread only, may touch global state (default)
+    PROCESS_THREADSAFE                                      // only touches the player and its map, may be handled in the map update
+};
+
 class WorldPacket;
 
 struct OpcodeHandler
@@ -1098,6 +1105,7 @@ struct OpcodeHandler
     char const* name;
     SessionStatus status;
     void (WorldSession::*handler)(WorldPacket& recvPacket);
+    PacketProcessing processing;
 };
 
 extern OpcodeHandler opcodeTable[NUM_MSG_TYPES];
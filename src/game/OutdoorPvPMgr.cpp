@@ -13,6 +13,7 @@
 #include "ObjectMgr.h"
 #include "Player.h"
 #include "Policies/SingletonImp.h"
+#include "TickProfiler.h"
 
 INSTANTIATE_SINGLETON_1(OutdoorPvPMgr);
 
@@ -156,6 +157,8 @@ OutdoorPvP * OutdoorPvPMgr::GetOutdoorPvPToZoneId(uint32 zoneid)
 
 void OutdoorPvPMgr::Update(uint32 diff)
 {
+    PROFILE_ZONE("OutdoorPvPMgr::Update");
+
     m_UpdateTimer += diff;
     if (m_UpdateTimer > OUTDOORPVP_OBJECTIVE_UPDATE_INTERVAL)
     {
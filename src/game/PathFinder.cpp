@@ -8,14 +8,70 @@
 #include "Creature.h"
 #include "PathFinder.h"
 #include "Log.h"
+#include "World.h"
+#include "Timer.h"
+#include "MapManager.h"
 
 #include "DetourCommon.h"
 
+////////////////// PathCache //////////////////
+PathfindingStats PathCache::s_stats;
+
+void PathCache::Update(uint32 now)
+{
+    m_now = now;
+    m_budget = sWorld.getConfig(CONFIG_MMAP_TICK_POLY_BUDGET);
+
+    uint32 cacheTime = sWorld.getConfig(CONFIG_MMAP_PATH_CACHE_TIME);
+    if (getMSTimeDiff(m_lastPurge, now) < cacheTime)
+        return;
+
+    m_lastPurge = now;
+    for (EntryMap::iterator itr = m_entries.begin(); itr != m_entries.end();)
+    {
+        if (getMSTimeDiff(itr->second.time, now) >= cacheTime)
+            m_entries.erase(itr++);
+        else
+            ++itr;
+    }
+}
+
+bool PathCache::Find(dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, dtPolyRef* path, uint32& length) const
+{
+    EntryMap::const_iterator itr = m_entries.find(Key(startPoly, endPoly, includeFlags));
+    if (itr == m_entries.end())
+        return false;
+
+    if (getMSTimeDiff(itr->second.time, m_now) >= sWorld.getConfig(CONFIG_MMAP_PATH_CACHE_TIME))
+        return false;
+
+    length = itr->second.polys.size();
+    std::copy(itr->second.polys.begin(), itr->second.polys.end(), path);
+    return true;
+}
+
+void PathCache::Store(dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, dtPolyRef const* path, uint32 length)
+{
+    if (!sWorld.getConfig(CONFIG_MMAP_PATH_CACHE_TIME))
+        return;
+
+    Entry& entry = m_entries[Key(startPoly, endPoly, includeFlags)];
+    entry.time = m_now;
+    entry.polys.assign(path, path + length);
+}
+
+bool PathCache::HasBudget() const
+{
+    return !sWorld.getConfig(CONFIG_MMAP_TICK_POLY_BUDGET) || m_budget;
+}
+
 ////////////////// PathInfo //////////////////
-PathInfo::PathInfo(const Unit* owner, float destX, float destY, float destZ, bool forceDest) :
+PathInfo::PathInfo(const Unit* owner, float destX, float destY, float destZ, bool forceDest, bool async) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_forceDestination(forceDest), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
-    m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL)
+    m_sourceUnit(owner), m_sourceGuidLow(owner->GetGUIDLow()), m_mapId(owner->GetMapId()),
+    m_canFly(false), m_canSwim(false), m_startUnderWater(false), m_endUnderWater(false),
+    m_navMesh(NULL), m_navMeshQuery(NULL), m_pathCache(NULL), m_async(async), m_request(NULL)
 {
     PathNode endPoint(destX, destY, destZ);
     setEndPosition(endPoint);
@@ -27,20 +83,17 @@ PathInfo::PathInfo(const Unit* owner, float destX, float destY, float destZ, boo
 
     //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathInfo::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
 
-    uint32 mapId = m_sourceUnit->GetMapId();
-    if (MMAP::MMapFactory::IsPathfindingEnabled(mapId))
-    {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        m_navMesh = mmap->GetNavMesh(mapId);
-        m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
-    }
+    loadNavMesh();
+
+    if (Map* map = m_sourceUnit->FindMap())
+        m_pathCache = &map->GetPathCache();
 
     createFilter();
 
     if (m_navMesh && m_navMeshQuery && HaveTile(endPoint) &&
             !m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING))
     {
-        BuildPolyPath(startPoint, endPoint);
+        BuildPath(startPoint, endPoint);
     }
     else
     {
@@ -52,10 +105,24 @@ PathInfo::PathInfo(const Unit* owner, float destX, float destY, float destZ, boo
 PathInfo::~PathInfo()
 {
     //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathInfo::~PathInfo() for %u \n", m_sourceUnit->GetGUIDLow());
+    DropAsyncRequest();
 }
 
 bool PathInfo::Update(float destX, float destY, float destZ, bool forceDest)
 {
+    if (m_request)
+    {
+        // the service searched it since the last map update, the destination may be a tick old
+        if (m_request->IsDone())
+        {
+            TakeAsyncResult();
+            return true;
+        }
+
+        // submitted in this update, or outside of the map updates; search again
+        DropAsyncRequest();
+    }
+
     PathNode newDest(destX, destY, destZ);
     PathNode oldDest = getEndPosition();
     setEndPosition(newDest);
@@ -68,6 +135,9 @@ bool PathInfo::Update(float destX, float destY, float destZ, bool forceDest)
 
     m_forceDestination = forceDest;
 
+    // the map may be updated by another thread than last time
+    loadNavMesh();
+
     //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathInfo::Update() for %u \n", m_sourceUnit->GetGUIDLow());
 
     // make sure navMesh works - we can run on map w/o mmap
@@ -96,14 +166,136 @@ bool PathInfo::Update(float destX, float destY, float destZ, bool forceDest)
 
         return false;
     }
+    else if (m_pathPoints.size() > 2 && m_pathCache && !m_pathCache->HasBudget() && !isAsync())
+    {
+        // target moved, but the map searched enough this update
+        // keep following the old path, the next update recalculates it
+        ++PathCache::GetStats().deferred;
+
+        m_pathPoints.crop(1, 0);
+        setNextPosition(m_pathPoints[1]);
+
+        return false;
+    }
     else
     {
         // target moved, so we need to update the poly path
-        BuildPolyPath(newStart, newDest);
+        BuildPath(newStart, newDest);
         return true;
     }
 }
 
+void PathInfo::loadNavMesh()
+{
+    m_navMesh = NULL;
+    m_navMeshQuery = NULL;
+
+    if (m_sourceUnit)
+        m_mapId = m_sourceUnit->GetMapId();
+
+    if (MMAP::MMapFactory::IsPathfindingEnabled(m_mapId))
+    {
+        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+        m_navMesh = mmap->GetNavMesh(m_mapId);
+        m_navMeshQuery = mmap->GetNavMeshQuery(m_mapId);
+    }
+}
+
+bool PathInfo::isAsync() const
+{
+    return m_async && m_sourceUnit && MapManager::Instance().GetPathfindingService().activated();
+}
+
+void PathInfo::takeUnderWater()
+{
+    // only asked by BuildPolyPath for units that either swim or fly
+    if (m_canSwim != m_canFly)
+    {
+        m_startUnderWater = m_sourceUnit->GetBaseMap()->IsUnderWater(m_startPosition.x, m_startPosition.y, m_startPosition.z);
+        m_endUnderWater = m_sourceUnit->GetBaseMap()->IsUnderWater(m_endPosition.x, m_endPosition.y, m_endPosition.z);
+    }
+}
+
+bool PathInfo::hasAsyncResult() const
+{
+    return m_request && m_request->IsDone();
+}
+
+void PathInfo::BuildPath(const PathNode &startPos, const PathNode &endPos)
+{
+    if (!isAsync())
+    {
+        // asking the map may load a grid, which adds tiles under the write lock
+        takeUnderWater();
+
+        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+        ACE_READ_GUARD(ACE_RW_Thread_Mutex, guard, mmap->GetMeshLock(m_mapId));
+
+        // the mesh may have been unloaded since it was looked up
+        loadNavMesh();
+        if (m_navMesh && m_navMeshQuery)
+            BuildPolyPath(startPos, endPos);
+        else
+        {
+            BuildShortcut();
+            m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        }
+        return;
+    }
+
+    SubmitPath();
+
+    // keep following the old path until the new one is there, else go straight
+    if (m_pathPoints.size() > 2)
+    {
+        m_pathPoints.crop(1, 0);
+        setNextPosition(m_pathPoints[1]);
+    }
+    else
+    {
+        BuildShortcut();
+        m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+    }
+}
+
+void PathInfo::SubmitPath()
+{
+    DropAsyncRequest();
+
+    // the worker can't ask the map
+    takeUnderWater();
+
+    m_request = new PathRequest(*this);
+    MapManager::Instance().GetPathfindingService().schedule(m_request);
+    ++PathCache::GetStats().async;
+}
+
+void PathInfo::TakeAsyncResult()
+{
+    PathInfo const& result = m_request->GetPath();
+
+    m_polyLength = result.m_polyLength;
+    memcpy(m_pathPolyRefs, result.m_pathPolyRefs, m_polyLength * sizeof(dtPolyRef));
+    m_pathPoints = result.m_pathPoints;
+    m_type = result.m_type;
+
+    m_startPosition = result.m_startPosition;
+    m_nextPosition = result.m_nextPosition;
+    m_endPosition = result.m_endPosition;
+    m_actualEndPosition = result.m_actualEndPosition;
+
+    DropAsyncRequest();
+}
+
+void PathInfo::DropAsyncRequest()
+{
+    if (!m_request)
+        return;
+
+    m_request->Release();
+    m_request = NULL;
+}
+
 dtPolyRef PathInfo::getPathPolyByPosition(const dtPolyRef *polyPath, uint32 polyPathSize, const float* point, float *distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -189,8 +381,7 @@ void PathInfo::BuildPolyPath(const PathNode &startPos, const PathNode &endPos)
     {
         //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
         BuildShortcut();
-        m_type = (m_sourceUnit->GetTypeId() == TYPEID_UNIT && ((Creature*)m_sourceUnit)->canFly())
-                    ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+        m_type = m_canFly ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
         return;
     }
 
@@ -201,21 +392,19 @@ void PathInfo::BuildPolyPath(const PathNode &startPos, const PathNode &endPos)
         //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", distToStartPoly, distToEndPoly);
 
         bool buildShotrcut = false;
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_canSwim || m_canFly)
         {
-            Creature* owner = (Creature*)m_sourceUnit;
-
-            PathNode p = (distToStartPoly > 7.0f) ? startPos : endPos;
-            if (m_sourceUnit->GetBaseMap()->IsUnderWater(p.x, p.y, p.z))
+            bool start = distToStartPoly > 7.0f;
+            if (isUnderWater(start))
             {
                 //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: underWater case\n");
-                if (owner->canSwim())
+                if (m_canSwim)
                     buildShotrcut = true;
             }
             else
             {
                 //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: flying case\n");
-                if (owner->canFly())
+                if (m_canFly)
                     buildShotrcut = true;
             }
         }
@@ -352,9 +541,13 @@ void PathInfo::BuildPolyPath(const PathNode &startPos, const PathNode &endPos)
             // this is probably an error state, but we'll leave it
             // and hopefully recover on the next Update
             // we still need to copy our preffix
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+            sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
         }
 
+        ++PathCache::GetStats().searched;
+        if (m_pathCache)
+            m_pathCache->ConsumeBudget(suffixPolyLength);
+
         //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u \n",m_polyLength, prefixPolyLength, suffixPolyLength);
 
         // new path = prefix + suffix - overlap
@@ -371,23 +564,36 @@ void PathInfo::BuildPolyPath(const PathNode &startPos, const PathNode &endPos)
         // free and invalidate old path data
         clear();
 
-        dtStatus dtResult = m_navMeshQuery->findPath(
-                startPoly,          // start polygon
-                endPoly,            // end polygon
-                startPoint,         // start position
-                endPoint,           // end position
-                &m_filter,           // polygon search filter
-                m_pathPolyRefs,     // [out] path
-                (int*)&m_polyLength,
-                MAX_PATH_LENGTH);   // max number of polygons in output path
-
-        if (!m_polyLength || dtResult != DT_SUCCESS)
+        // units heading for the same polygon from the same one take the path searched first
+        if (m_pathCache && m_pathCache->Find(startPoly, endPoly, m_filter.getIncludeFlags(), m_pathPolyRefs, m_polyLength))
+            ++PathCache::GetStats().cacheHits;
+        else
         {
-            // only happens if we passed bad data to findPath(), or navmesh is messed up
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
-            BuildShortcut();
-            m_type = PATHFIND_NOPATH;
-            return;
+            dtStatus dtResult = m_navMeshQuery->findPath(
+                    startPoly,          // start polygon
+                    endPoly,            // end polygon
+                    startPoint,         // start position
+                    endPoint,           // end position
+                    &m_filter,           // polygon search filter
+                    m_pathPolyRefs,     // [out] path
+                    (int*)&m_polyLength,
+                    MAX_PATH_LENGTH);   // max number of polygons in output path
+
+            if (!m_polyLength || dtResult != DT_SUCCESS)
+            {
+                // only happens if we passed bad data to findPath(), or navmesh is messed up
+                sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
+                BuildShortcut();
+                m_type = PATHFIND_NOPATH;
+                return;
+            }
+
+            ++PathCache::GetStats().searched;
+            if (m_pathCache)
+            {
+                m_pathCache->ConsumeBudget(m_polyLength);
+                m_pathCache->Store(startPoly, endPoly, m_filter.getIncludeFlags(), m_pathPolyRefs, m_polyLength);
+            }
         }
     }
 
@@ -498,6 +704,9 @@ void PathInfo::createFilter()
     if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
     {
         Creature* creature = (Creature*)m_sourceUnit;
+        m_canFly = creature->canFly();
+        m_canSwim = creature->canSwim();
+
         if (creature->canWalk())
             includeFlags |= NAV_GROUND;          // walk
 
@@ -556,6 +765,9 @@ bool PathInfo::HaveTile(const PathNode &p) const
     int tx, ty;
     float point[VERTEX_SIZE] = {p.y, p.z, p.x};
 
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, mmap->GetMeshLock(m_mapId), false);
+
     m_navMesh->calcTileLoc(point, &tx, &ty);
     return (m_navMesh->getTileAt(tx, ty) != NULL);
 }
@@ -787,4 +999,36 @@ float PathInfo::dist3DSqr(const PathNode &p1, const PathNode &p2) const
     const float dy = p2.y - p1.y;
     const float dz = p2.z - p1.z;
     return (dx*dx + dy*dy + dz*dz);
-}
\ No newline at end of file
+}
+////////////////// PathRequest //////////////////
+PathRequest::PathRequest(PathInfo const& path) : m_path(path), m_refs(2), m_done(0)
+{
+    // the worker may only touch what belongs to the copy
+    m_path.m_sourceUnit = NULL;
+    m_path.m_pathCache = NULL;
+    m_path.m_async = false;
+    m_path.m_request = NULL;
+}
+
+void PathRequest::Execute()
+{
+    // tiles of the map are only added or removed after the running searches are done
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+    {
+        ACE_READ_GUARD(ACE_RW_Thread_Mutex, guard, mmap->GetMeshLock(m_path.m_mapId));
+
+        PathNode startPos = m_path.getStartPosition();
+        PathNode endPos = m_path.getEndPosition();
+
+        m_path.loadNavMesh();
+        if (m_path.m_navMesh && m_path.m_navMeshQuery)
+            m_path.BuildPolyPath(startPos, endPos);
+        else
+        {
+            m_path.BuildShortcut();
+            m_path.m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        }
+    }
+
+    ++m_done;
+}
@@ -11,6 +11,12 @@
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
 
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+#include <map>
+#include <vector>
+
 class Unit;
 
 // 74*4.0f=296y  number_of_points*interval = max_path_len
@@ -35,10 +41,80 @@ enum PathType
     PATHFIND_NOT_USING_PATH = 0x0010    // used when we are either flying/swiming or on map w/o mmaps
 };
 
+struct PathfindingStats
+{
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> searched;         // poly paths searched on the navmesh
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> cacheHits;        // poly paths taken from a map's path cache
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> deferred;         // recalculations postponed, the map's budget was used up
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> async;            // searches handed to the pathfinding service
+};
+
+// Poly paths recently searched on one map, keyed by start and end polygon
+// and the filter flags, so units moving between the same polygons (a pack
+// chasing one player) share one search. Also keeps the map's pathfinding
+// budget of the current update. Only the thread updating the map uses it.
+class PathCache
+{
+    public:
+        PathCache() : m_now(0), m_budget(0), m_lastPurge(0) {}
+
+        // at the start of each map update: refills the budget, drops old paths
+        void Update(uint32 now);
+
+        bool Find(dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, dtPolyRef* path, uint32& length) const;
+        void Store(dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, dtPolyRef const* path, uint32 length);
+
+        // false once this update's budget is used up
+        bool HasBudget() const;
+        void ConsumeBudget(uint32 polys) { m_budget = polys < m_budget ? m_budget - polys : 0; }
+
+        static PathfindingStats& GetStats() { return s_stats; }
+
+    private:
+        struct Key
+        {
+            Key(dtPolyRef start, dtPolyRef end, uint16 flags) : startPoly(start), endPoly(end), includeFlags(flags) {}
+
+            bool operator<(Key const& other) const
+            {
+                if (startPoly != other.startPoly)
+                    return startPoly < other.startPoly;
+                if (endPoly != other.endPoly)
+                    return endPoly < other.endPoly;
+                return includeFlags < other.includeFlags;
+            }
+
+            dtPolyRef startPoly;
+            dtPolyRef endPoly;
+            uint16 includeFlags;
+        };
+
+        struct Entry
+        {
+            uint32 time;                                    // getMSTime() of the search
+            std::vector<dtPolyRef> polys;
+        };
+
+        typedef std::map<Key, Entry> EntryMap;
+
+        EntryMap m_entries;
+        uint32 m_now;
+        uint32 m_budget;
+        uint32 m_lastPurge;
+
+        static PathfindingStats s_stats;
+};
+
+class PathRequest;
+
 class PathInfo
 {
+    friend class PathRequest;
+
     public:
-        PathInfo(Unit const* owner, float destX, float destY, float destZ, bool forceDest = false);
+        // async: searches are handed to the pathfinding service if it runs, the owner
+        // moves straight to the destination until the result is taken over on a later Update
+        PathInfo(Unit const* owner, float destX, float destY, float destZ, bool forceDest = false, bool async = false);
         ~PathInfo();
 
         // Calculate the path from owner to given destination
@@ -63,6 +139,9 @@ class PathInfo
         PointPath& getFullPath() { return m_pathPoints; }
         PathType getPathType() const { return m_type; }
 
+        // a search of the service is finished, the next Update takes it over
+        bool hasAsyncResult() const;
+
         bool inRange(const PathNode &p1, const PathNode &p2, float r, float h) const;
         float dist3DSqr(const PathNode &p1, const PathNode &p2) const;
     private:
@@ -82,9 +161,18 @@ class PathInfo
         PathNode        m_endPosition;      // {x, y, z} of the destination
         PathNode        m_actualEndPosition;  // {x, y, z} of the closest possible point to given destination
 
-        const Unit* const       m_sourceUnit;       // the unit that is moving
+        const Unit*             m_sourceUnit;       // the unit that is moving, NULL in the copy searched by the service
+        uint32                  m_sourceGuidLow;
+        uint32                  m_mapId;
+        bool                    m_canFly;
+        bool                    m_canSwim;
+        bool                    m_startUnderWater;  // taken before the search, the map can't be asked under the mesh lock
+        bool                    m_endUnderWater;
         const dtNavMesh*        m_navMesh;          // the nav mesh
-        const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
+        const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path, belongs to the current thread
+        PathCache*              m_pathCache;        // cache of the owner's map
+        bool                    m_async;
+        PathRequest*            m_request;          // search running in the service
 
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
@@ -104,6 +192,15 @@ class PathInfo
         dtPolyRef getPathPolyByPosition(const dtPolyRef *polyPath, uint32 polyPathSize, const float* point, float *distance = NULL) const;
         dtPolyRef getPolyByLocation(const float* point, float *distance) const;
         bool HaveTile(const PathNode &p) const;
+        void loadNavMesh();
+        bool isAsync() const;
+        void takeUnderWater();
+        bool isUnderWater(bool start) const { return start ? m_startUnderWater : m_endUnderWater; }
+
+        void BuildPath(const PathNode &startPos, const PathNode &endPos);
+        void SubmitPath();
+        void TakeAsyncResult();
+        void DropAsyncRequest();
 
         void BuildPolyPath(const PathNode &startPos, const PathNode &endPos);
         void BuildPointPath(const float *startPoint, const float *endPoint);
@@ -124,4 +221,31 @@ class PathInfo
                               float* smoothPath, int* smoothPathSize, uint32 smoothPathMaxSize);
 };
 
+// A search handed to the pathfinding service. The worker searches on its
+// own copy of the owner's path, which doesn't know the owner any more; the
+// owner takes the result over once it is done. Owner and service each hold
+// a reference, the last one to release it deletes it.
+class PathRequest
+{
+    public:
+        explicit PathRequest(PathInfo const& path);
+
+        // on a worker thread
+        void Execute();
+
+        bool IsDone() const { return m_done.value() != 0; }
+        PathInfo const& GetPath() const { return m_path; }
+
+        void Release()
+        {
+            if (--m_refs == 0)
+                delete this;
+        }
+
+    private:
+        PathInfo m_path;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_refs;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_done;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#include "PathfindingService.h"
+#include "PathFinder.h"
+#include "TickProfiler.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+class PathSearchRequest : public ACE_Method_Request
+{
+    public:
+        PathRequest* m_request;
+        PathfindingService& m_service;
+        PathSearchRequest(PathRequest* r, PathfindingService& s) : m_request(r), m_service(s) {}
+        virtual int
+
+    call (void)
+    {
+        {
+            PROFILE_ZONE("PathfindingService::Search");
+            m_request->Execute();
+        }
+
+        m_request->Release();
+        m_service.search_finished();
+        return 0;
+    }
+};
+
+PathfindingService::PathfindingService() :
+m_executor(),
+m_condition(m_mutex),
+m_mutex(),
+pending_searches(0)
+{
+}
+
+PathfindingService::~PathfindingService()
+{
+    this->deactivate();
+}
+
+int PathfindingService::activate(size_t num_threads)
+{
+    return this->m_executor.activate(static_cast<int> (num_threads));
+}
+
+int PathfindingService::deactivate(void)
+{
+    this->wait();
+
+    // scheduled after the last batch, their owners search again
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, this->m_scheduledLock, -1);
+        for (size_t i = 0; i < this->m_scheduled.size(); ++i)
+            this->m_scheduled[i]->Release();
+        this->m_scheduled.clear();
+    }
+
+    return this->m_executor.deactivate();
+}
+
+void PathfindingService::schedule(PathRequest* request)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, this->m_scheduledLock);
+    this->m_scheduled.push_back(request);
+}
+
+int PathfindingService::start()
+{
+    std::vector<PathRequest*> requests;
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, this->m_scheduledLock, -1);
+        requests.swap(this->m_scheduled);
+    }
+
+    if (requests.empty())
+        return 0;
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, this->m_mutex, -1);
+
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        ++this->pending_searches;
+
+        if (this->m_executor.execute(new PathSearchRequest(requests[i], *this)) == -1)
+        {
+            ACE_DEBUG((LM_ERROR, ACE_TEXT("(%t) \n"), ACE_TEXT("Failed to schedule Path Search")));
+
+            requests[i]->Release();
+            --this->pending_searches;
+        }
+    }
+
+    return 0;
+}
+
+int PathfindingService::wait()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, this->m_mutex, -1);
+
+    while (this->pending_searches > 0)
+        this->m_condition.wait();
+
+    return 0;
+}
+
+bool PathfindingService::activated()
+{
+    return m_executor.activated();
+}
+
+void PathfindingService::search_finished()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, this->m_mutex);
+
+    --this->pending_searches;
+
+    if (this->pending_searches == 0)
+        this->m_condition.broadcast();
+}
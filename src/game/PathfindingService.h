@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#ifndef _PATHFINDING_SERVICE_H_INCLUDED
+#define _PATHFINDING_SERVICE_H_INCLUDED
+
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include "DelayExecutor.h"
+
+#include <vector>
+
+class PathRequest;
+
+// Worker threads searching the paths movement generators submit during the
+// map updates. The batch of a tick is started once all maps are updated and
+// runs while the world thread does the rest of the tick; it is waited for
+// before the next map update, so the owners find their results there.
+class PathfindingService
+{
+    public:
+        PathfindingService();
+        virtual ~PathfindingService();
+
+        friend class PathSearchRequest;
+
+        // takes a reference of the request
+        void schedule(PathRequest* request);
+
+        // hands the requests scheduled so far to the workers
+        int start();
+
+        int wait();
+
+        int activate(size_t num_threads);
+
+        int deactivate(void);
+
+        bool activated();
+    private:
+        void search_finished();
+
+        DelayExecutor m_executor;
+        ACE_Condition_Thread_Mutex m_condition;
+        ACE_Thread_Mutex m_mutex;
+        size_t pending_searches;
+
+        std::vector<PathRequest*> m_scheduled;
+        ACE_Thread_Mutex m_scheduledLock;
+};
+#endif //_PATHFINDING_SERVICE_H_INCLUDED
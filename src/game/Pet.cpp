@@ -162,7 +162,7 @@ bool Pet::LoadPetFromDB(Player* owner, uint32 petentry, uint32 petnumber, bool c
         return false;
 
     Map *map = owner->GetMap();
-    uint32 guid = objmgr.GenerateLowGuid(HIGHGUID_PET);
+    uint32 guid = map->GenerateLowGuid(HIGHGUID_PET);
     uint32 pet_number = fields[0].GetUInt32();
     if (!Create(guid, map, petentry, pet_number))
         return false;
@@ -361,7 +361,11 @@ void Pet::SavePetToDB(PetSaveMode mode)
 
             //only alive hunter pets get auras saved, the others don't
             if (!(getPetType() == HUNTER_PET && isAlive()))
+            {
                 m_Auras.clear();
+                m_procAuras.clear();
+                m_procAurasFlags = 0;
+            }
         }
         default:
             break;
@@ -860,7 +864,7 @@ bool Pet::CreateBaseAtCreature(Creature* creature)
         sLog.outError("CRITICAL ERROR: NULL pointer parsed into CreateBaseAtCreature()");
         return false;
     }
-    uint32 guid=objmgr.GenerateLowGuid(HIGHGUID_PET);
+    uint32 guid = creature->GetMap()->GenerateLowGuid(HIGHGUID_PET);
 
     sLog.outDebug("Create pet");
     uint32 pet_number = objmgr.GeneratePetNumber();
@@ -1303,6 +1307,8 @@ void Pet::_SaveSpells()
 void Pet::_LoadAuras(uint32 timediff)
 {
     m_Auras.clear();
+    m_procAuras.clear();
+    m_procAurasFlags = 0;
     for (int i = 0; i < TOTAL_AURAS; i++)
         m_modAuras[i].clear();
 
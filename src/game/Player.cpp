@@ -50,6 +50,7 @@
 #include "SocialMgr.h"
 #include "Mail.h"
 #include "GameEventMgr.h"
+#include "TickProfiler.h"
 
 #include <cmath>
 
@@ -1019,6 +1020,8 @@ void Player::Update(uint32 p_time)
     if (!IsInWorld())
         return;
 
+    PROFILE_ZONE("Player::Update");
+
     // undelivered mail
     if (m_nextMailDelivereTime && m_nextMailDelivereTime <= time(NULL))
     {
@@ -3722,6 +3725,9 @@ void Player::DeleteFromDB(uint64 playerguid, uint32 accountId, bool updateRealmC
     // bones will be deleted by corpse/bones deleting thread shortly
     ObjectAccessor::Instance().ConvertCorpseForPlayer(playerguid);
 
+    // guild and arena team membership below is read back from the DB
+    CharacterDatabaseWriter.FlushAndWait();
+
     // remove from guild
     if (uint32 guildId = GetGuildIdFromDB(playerguid))
         if (Guild* guild = objmgr.GetGuildById(guildId))
@@ -5641,7 +5647,7 @@ void Player::CheckAreaExploreAndOutdoor()
         return;
 
     bool isOutdoor;
-    uint16 areaFlag = GetBaseMap()->GetAreaFlag(GetPositionX(),GetPositionY(),GetPositionZ(), &isOutdoor);
+    uint16 areaFlag = GetMap()->GetAreaFlag(GetPositionX(),GetPositionY(),GetPositionZ(), &isOutdoor);
 
     if (sWorld.getConfig(CONFIG_VMAP_INDOOR_CHECK) && !isOutdoor && !isGameMaster())
         RemoveAurasWithAttribute(SPELL_ATTR_OUTDOORS_ONLY);
@@ -359,15 +359,15 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
 
     // make sure the same guid doesn't already exist and is safe to use
     bool incHighest = true;
-    if (guid != 0 && guid < objmgr.m_hiCharGuid)
+    if (guid != 0 && guid < objmgr.m_hiCharGuid.GetNextAfterMaxUsed())
     {
         result = CharacterDatabase.PQuery("SELECT 1 FROM characters WHERE guid = '%d'", guid);
         if (result)
-            guid = objmgr.m_hiCharGuid;                     // use first free if exists
+            guid = objmgr.m_hiCharGuid.GetNextAfterMaxUsed(); // use first free if exists
         else incHighest = false;
     }
     else
-        guid = objmgr.m_hiCharGuid;
+        guid = objmgr.m_hiCharGuid.GetNextAfterMaxUsed();
 
     // normalize the name if specified and check if it exists
     if (!normalizePlayerName(name))
@@ -463,7 +463,7 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                 if (!changetoknth(vals, OBJECT_FIELD_GUID+1, newguid))
                     ROLLBACK(DUMP_FILE_BROKEN);
                 for (uint16 field = PLAYER_FIELD_INV_SLOT_HEAD; field < PLAYER_FARSIGHT; field++)
-                    if (!changetokGuid(vals, field+1, items, objmgr.m_hiItemGuid, true))
+                    if (!changetokGuid(vals, field+1, items, objmgr.m_hiItemGuid.GetNextAfterMaxUsed(), true))
                         ROLLBACK(DUMP_FILE_BROKEN);
                 if (!changenth(line, 3, vals.c_str()))
                     ROLLBACK(DUMP_FILE_BROKEN);
@@ -491,21 +491,21 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                     ROLLBACK(DUMP_FILE_BROKEN);
 
                 // bag, item
-                if (!changeGuid(line, 2, items, objmgr.m_hiItemGuid, true))
+                if (!changeGuid(line, 2, items, objmgr.m_hiItemGuid.GetNextAfterMaxUsed(), true))
                     ROLLBACK(DUMP_FILE_BROKEN);
-                if (!changeGuid(line, 4, items, objmgr.m_hiItemGuid))
+                if (!changeGuid(line, 4, items, objmgr.m_hiItemGuid.GetNextAfterMaxUsed()))
                     ROLLBACK(DUMP_FILE_BROKEN);
                 break;
             }
             case DTT_ITEM:                                  // item_instance t.
             {
                 // item, owner, data field:item, owner guid
-                if (!changeGuid(line, 1, items, objmgr.m_hiItemGuid))
+                if (!changeGuid(line, 1, items, objmgr.m_hiItemGuid.GetNextAfterMaxUsed()))
                     ROLLBACK(DUMP_FILE_BROKEN);
                 if (!changenth(line, 2, newguid))
                     ROLLBACK(DUMP_FILE_BROKEN);
                 std::string vals = getnth(line,3);
-                if (!changetokGuid(vals, OBJECT_FIELD_GUID+1, items, objmgr.m_hiItemGuid))
+                if (!changetokGuid(vals, OBJECT_FIELD_GUID+1, items, objmgr.m_hiItemGuid.GetNextAfterMaxUsed()))
                     ROLLBACK(DUMP_FILE_BROKEN);
                 if (!changetoknth(vals, ITEM_FIELD_OWNER+1, newguid))
                     ROLLBACK(DUMP_FILE_BROKEN);
@@ -518,7 +518,7 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                 // guid,item_guid,
                 if (!changenth(line, 1, newguid))
                     ROLLBACK(DUMP_FILE_BROKEN);
-                if (!changeGuid(line, 2, items, objmgr.m_hiItemGuid))
+                if (!changeGuid(line, 2, items, objmgr.m_hiItemGuid.GetNextAfterMaxUsed()))
                     ROLLBACK(DUMP_FILE_BROKEN);
                 break;
             }
@@ -578,7 +578,7 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                 // mail_id,item_guid,item_template,receiver
                 if (!changeGuid(line, 1, mails, objmgr.m_mailid))
                     ROLLBACK(DUMP_FILE_BROKEN);
-                if (!changeGuid(line, 2, items, objmgr.m_hiItemGuid))
+                if (!changeGuid(line, 2, items, objmgr.m_hiItemGuid.GetNextAfterMaxUsed()))
                     ROLLBACK(DUMP_FILE_BROKEN);
                 if (!changenth(line, 4, newguid))
                     ROLLBACK(DUMP_FILE_BROKEN);
@@ -595,11 +595,11 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
 
     CharacterDatabase.CommitTransaction();
 
-    objmgr.m_hiItemGuid += items.size();
+    objmgr.m_hiItemGuid.Reserve(items.size());
     objmgr.m_mailid     += mails.size();
 
     if (incHighest)
-        ++objmgr.m_hiCharGuid;
+        objmgr.m_hiCharGuid.Reserve(1);
 
     fclose(fin);
 
@@ -19,6 +19,7 @@ INSTANTIATE_SINGLETON_1(SocialMgr);
 PlayerSocial::PlayerSocial()
 {
     m_playerGUID = 0;
+    m_ignoreMask = 0;
 }
 
 PlayerSocial::~PlayerSocial()
@@ -68,6 +69,9 @@ bool PlayerSocial::AddToSocialList(uint32 friend_guid, bool ignore)
         fi.Flags |= flag;
         m_playerSocialMap[friend_guid] = fi;
     }
+
+    if (ignore)
+        m_ignoreMask |= IgnoreMaskBit(friend_guid);
     return true;
 }
 
@@ -91,6 +95,9 @@ void PlayerSocial::RemoveFromSocialList(uint32 friend_guid, bool ignore)
     {
         CharacterDatabase.PExecute("UPDATE character_social SET flags = (flags & ~%u) WHERE guid = '%u' AND friend = '%u'", flag, GetPlayerGUID(), friend_guid);
     }
+
+    if (ignore)
+        UpdateIgnoreMask();
 }
 
 void PlayerSocial::SetFriendNote(uint32 friend_guid, std::string note)
@@ -151,12 +158,23 @@ bool PlayerSocial::HasFriend(uint32 friend_guid)
 
 bool PlayerSocial::HasIgnore(uint32 ignore_guid)
 {
+    if (!(m_ignoreMask & IgnoreMaskBit(ignore_guid)))
+        return false;
+
     PlayerSocialMap::iterator itr = m_playerSocialMap.find(ignore_guid);
     if (itr != m_playerSocialMap.end())
         return itr->second.Flags & SOCIAL_FLAG_IGNORED;
     return false;
 }
 
+void PlayerSocial::UpdateIgnoreMask()
+{
+    m_ignoreMask = 0;
+    for (PlayerSocialMap::const_iterator itr = m_playerSocialMap.begin(); itr != m_playerSocialMap.end(); ++itr)
+        if (itr->second.Flags & SOCIAL_FLAG_IGNORED)
+            m_ignoreMask |= IgnoreMaskBit(itr->first);
+}
+
 SocialMgr::SocialMgr()
 {
 }
@@ -303,6 +321,8 @@ PlayerSocial *SocialMgr::LoadFromDB(QueryResult_AutoPtr result, uint32 guid)
             break;
     }
     while (result->NextRow());
+
+    social->UpdateIgnoreMask();
     return social;
 }
 
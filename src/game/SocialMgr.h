@@ -118,8 +118,14 @@ class PlayerSocial
         void SetPlayerGUID(uint32 guid) { m_playerGUID = guid; }
         uint32 GetNumberOfSocialsWithFlag(SocialFlag flag);
     private:
+        // one bit per (guid % 64) of ignored players, lets HasIgnore reject
+        // most lookups without touching the map (channel fan-out hot path)
+        static uint64 IgnoreMaskBit(uint32 guid) { return UI64LIT(1) << (guid & 63); }
+        void UpdateIgnoreMask();
+
         PlayerSocialMap m_playerSocialMap;
         uint32 m_playerGUID;
+        uint64 m_ignoreMask;
 };
 
 class SocialMgr
@@ -34,6 +34,7 @@
 #include "Util.h"
 #include "TemporarySummon.h"
 #include "PathFinder.h"
+#include "TickProfiler.h"
 
 #define SPELL_CHANNEL_UPDATE_INTERVAL (1*IN_MILLISECONDS)
 
@@ -243,6 +244,8 @@ void SpellCastTargets::write (ByteBuffer& data) const
         data << m_strTarget;
 }
 
+ObjectPool Spell::s_pool("Spell", sizeof(Spell));
+
 Spell::Spell(Unit* Caster, SpellEntry const *info, bool triggered, uint64 originalCasterGUID, Spell** triggeringContainer, bool skipCheck)
 : m_spellInfo(info), m_spellValue(new SpellValue(m_spellInfo))
 , m_caster(Caster)
@@ -644,12 +647,12 @@ void Spell::CleanupTargetList()
     m_delayMoment = 0;
 }
 
-void Spell::AddUnitTarget(Unit* pVictim, uint32 effIndex)
+void Spell::AddUnitTarget(Unit* pVictim, uint32 effIndex, bool checkLOS)
 {
     if (m_spellInfo->Effect[effIndex] == 0)
         return;
 
-    if (!CheckTarget(pVictim, effIndex))
+    if (!CheckTarget(pVictim, effIndex, checkLOS))
         return;
 
     // Check for effect immune skip if immuned
@@ -1269,7 +1272,7 @@ struct TargetDistanceOrder : public std::binary_function<const Unit, const Unit,
     }
 };
 
-void Spell::SearchChainTarget(std::list<Unit*> &TagUnitMap, float max_range, uint32 num, SpellTargets TargetType)
+void Spell::SearchChainTarget(SpellTargetList &TagUnitMap, float max_range, uint32 num, SpellTargets TargetType)
 {
     Unit* cur = m_targets.getUnitTarget();
     if (!cur)
@@ -1279,7 +1282,7 @@ void Spell::SearchChainTarget(std::list<Unit*> &TagUnitMap, float max_range, uin
     if (m_spellInfo->DmgClass != SPELL_DAMAGE_CLASS_MELEE)
         max_range += num * CHAIN_SPELL_JUMP_RADIUS;
 
-    std::list<Unit*> tempUnitMap;
+    SpellTargetList tempUnitMap;
     if (TargetType == SPELL_TARGETS_CHAINHEAL)
     {
         SearchAreaTarget(tempUnitMap, max_range, PUSH_CHAIN, SPELL_TARGETS_ALLY);
@@ -1299,7 +1302,7 @@ void Spell::SearchChainTarget(std::list<Unit*> &TagUnitMap, float max_range, uin
         if (tempUnitMap.empty())
             break;
 
-        std::list<Unit*>::iterator next;
+        SpellTargetList::iterator next;
 
         if (TargetType == SPELL_TARGETS_CHAINHEAL)
         {
@@ -1337,7 +1340,7 @@ void Spell::SearchChainTarget(std::list<Unit*> &TagUnitMap, float max_range, uin
     }
 }
 
-void Spell::SearchAreaTarget(std::list<Unit*> &TagUnitMap, float radius, const uint32 type, SpellTargets TargetType, uint32 entry)
+void Spell::SearchAreaTarget(SpellTargetList &TagUnitMap, float radius, const uint32 type, SpellTargets TargetType, uint32 entry)
 {
     Position *pos;
     switch(type)
@@ -1861,7 +1864,7 @@ void Spell::SetTargetMap(uint32 i, uint32 cur)
             if (modOwner)
                 modOwner->ApplySpellMod(m_spellInfo->Id, SPELLMOD_RANGE, range, this);
 
-            std::list<Unit*> unitList;
+            SpellTargetList unitList;
 
             switch (cur)
             {
@@ -1878,7 +1881,7 @@ void Spell::SetTargetMap(uint32 i, uint32 cur)
                     break;
             }
 
-            for (std::list<Unit*>::iterator itr = unitList.begin(); itr != unitList.end(); ++itr)
+            for (SpellTargetList::iterator itr = unitList.begin(); itr != unitList.end(); ++itr)
                 AddUnitTarget(*itr, i);
         }
         else
@@ -1894,7 +1897,7 @@ void Spell::SetTargetMap(uint32 i, uint32 cur)
         if (modOwner)
             modOwner->ApplySpellMod(m_spellInfo->Id, SPELLMOD_RADIUS, radius, this);
 
-        std::list<Unit*> unitList;
+        SpellTargetList unitList;
 
         switch(cur)
         {
@@ -1991,8 +1994,25 @@ void Spell::SetTargetMap(uint32 i, uint32 cur)
             }else if (m_spellInfo->Id == 27285) // Seed of Corruption proc spell
                 unitList.remove(m_targets.getUnitTarget());
 
-            for (std::list<Unit*>::iterator itr = unitList.begin(); itr != unitList.end(); ++itr)
-                AddUnitTarget(*itr, i);
+            // effects with the normal LOS check of CheckTarget get it for all targets at once
+            bool checkLOS = true;
+            switch (m_spellInfo->Effect[i])
+            {
+                case SPELL_EFFECT_NONE:
+                case SPELL_EFFECT_SUMMON_PLAYER:
+                case SPELL_EFFECT_DUMMY:
+                case SPELL_EFFECT_RESURRECT_NEW:
+                    break;
+                default:
+                    if (m_spellInfo->AttributesEx2 & SPELL_ATTR_EX2_IGNORE_LOS)
+                        break;
+                    GetLOSCaster()->RemoveNotWithinLOSInMap(unitList);
+                    checkLOS = false;
+                    break;
+            }
+
+            for (SpellTargetList::iterator itr = unitList.begin(); itr != unitList.end(); ++itr)
+                AddUnitTarget(*itr, i, checkLOS);
         }
     }
 }
@@ -2616,6 +2636,8 @@ void Spell::SendSpellCooldown()
 
 void Spell::update(uint32 difftime)
 {
+    PROFILE_ZONE_ARG("Spell::update", m_spellInfo->Id);
+
     // update pointers based at it's GUIDs
     UpdatePointers();
 
@@ -5159,7 +5181,7 @@ CurrentSpellTypes Spell::GetCurrentContainer()
         return(CURRENT_GENERIC_SPELL);
 }
 
-bool Spell::CheckTarget(Unit* target, uint32 eff)
+bool Spell::CheckTarget(Unit* target, uint32 eff, bool checkLOS)
 {
     // Check targets for creature type mask and remove not appropriate (skip explicit self target case, maybe need other explicit targets)
     if (m_spellInfo->EffectImplicitTargetA[eff] != TARGET_UNIT_CASTER)
@@ -5194,8 +5216,8 @@ bool Spell::CheckTarget(Unit* target, uint32 eff)
             return false;
     }
 
-    //Do not check LOS for triggered spells
-    if (m_spellInfo->AttributesEx2 & SPELL_ATTR_EX2_IGNORE_LOS)
+    //Do not check LOS for triggered spells or targets already checked
+    if (!checkLOS || m_spellInfo->AttributesEx2 & SPELL_ATTR_EX2_IGNORE_LOS)
         return true;
 
     //Check targets for LOS visibility (except spells without range limitations)
@@ -5209,7 +5231,7 @@ bool Spell::CheckTarget(Unit* target, uint32 eff)
             //fall through
         case SPELL_EFFECT_RESURRECT_NEW:
             // player far away, maybe his corpse near?
-            if (target != m_caster && !target->IsWithinLOSInMap(m_caster))
+            if (target != GetLOSCaster() && !target->IsWithinLOSInMap(GetLOSCaster()))
             {
                 if (!m_targets.getCorpseTargetGUID())
                     return false;
@@ -5221,14 +5243,14 @@ bool Spell::CheckTarget(Unit* target, uint32 eff)
                 if (target->GetGUID() != corpse->GetOwnerGUID())
                     return false;
 
-                if (!corpse->IsWithinLOSInMap(m_caster))
+                if (!corpse->IsWithinLOSInMap(GetLOSCaster()))
                     return false;
             }
 
             // all ok by some way or another, skip normal check
             break;
         default:                                            // normal case
-            if (target != m_caster && !target->IsWithinLOSInMap(m_caster))
+            if (target != GetLOSCaster() && !target->IsWithinLOSInMap(GetLOSCaster()))
                 return false;
             break;
     }
@@ -5334,6 +5356,8 @@ bool Spell::HaveTargetsForEffect(uint8 effect) const
     return false;
 }
 
+ObjectPool SpellEvent::s_pool("SpellEvent", sizeof(SpellEvent));
+
 SpellEvent::SpellEvent(Spell* spell) : BasicEvent()
 {
     m_Spell = spell;
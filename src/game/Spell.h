@@ -8,6 +8,7 @@
 
 #include "GridDefines.h"
 #include "SharedDefines.h"
+#include "Utilities/ObjectPool.h"
 
 #define MAX_SPELL_ID    60000
 
@@ -16,6 +17,9 @@ class Player;
 class GameObject;
 class Aura;
 
+// area and chain target search results, nodes come from a per-thread pool
+typedef std::list<Unit*, PoolAllocator<Unit*> > SpellTargetList;
+
 enum SpellCastTargetFlags
 {
     /*TARGET_FLAG_NONE             = 0x0000,
@@ -336,6 +340,10 @@ class Spell
         Spell(Unit* Caster, SpellEntry const *info, bool triggered, uint64 originalCasterGUID = 0, Spell** triggeringContainer = NULL, bool skipCheck = false);
         ~Spell();
 
+        // one per cast, recycled through a per-thread free list
+        static void* operator new(size_t size) { return s_pool.Allocate(size); }
+        static void operator delete(void* p, size_t size) { s_pool.Deallocate(p, size); }
+
         void prepare(SpellCastTargets * targets, Aura* triggeredByAura = NULL);
         void cancel();
         void update(uint32 difftime);
@@ -380,7 +388,10 @@ class Spell
 
         Unit* SelectMagnetTarget();
         void HandleHitTriggerAura();
-        bool CheckTarget(Unit* target, uint32 eff);
+        bool CheckTarget(Unit* target, uint32 eff, bool checkLOS = true);
+        // targets must be in LOS of this one, for CheckTarget and the batch of SetTargetMap alike;
+        // gameobjects and traps cast through a trigger at their position, not m_originalCaster
+        Unit* GetLOSCaster() const { return m_caster; }
 
         void CheckSrc() { if (!m_targets.HasSrc()) m_targets.setSrc(m_caster); }
         void CheckDst() { if (!m_targets.HasDst()) m_targets.setDst(m_caster); }
@@ -551,7 +562,7 @@ class Spell
         };
         std::list<ItemTargetInfo> m_UniqueItemInfo;
 
-        void AddUnitTarget(Unit* target, uint32 effIndex);
+        void AddUnitTarget(Unit* target, uint32 effIndex, bool checkLOS = true);
         void AddUnitTarget(uint64 unitGUID, uint32 effIndex);
         void AddGOTarget(GameObject* target, uint32 effIndex);
         void AddGOTarget(uint64 goGUID, uint32 effIndex);
@@ -561,8 +572,8 @@ class Spell
         void DoAllEffectOnTarget(GOTargetInfo *target);
         void DoAllEffectOnTarget(ItemTargetInfo *target);
         bool IsAliveUnitPresentInTargetList();
-        void SearchAreaTarget(std::list<Unit*> &unitList, float radius, const uint32 type, SpellTargets TargetType, uint32 entry = 0);
-        void SearchChainTarget(std::list<Unit*> &unitList, float radius, uint32 unMaxTargets, SpellTargets TargetType);
+        void SearchAreaTarget(SpellTargetList &unitList, float radius, const uint32 type, SpellTargets TargetType, uint32 entry = 0);
+        void SearchChainTarget(SpellTargetList &unitList, float radius, uint32 unMaxTargets, SpellTargets TargetType);
         WorldObject* SearchNearbyTarget(float range, SpellTargets TargetType);
         bool IsValidSingleTargetEffect(Unit const* target, Targets type) const;
         bool IsValidSingleTargetSpell(Unit const* target) const;
@@ -598,13 +609,15 @@ class Spell
 
         uint32 m_customAttr;
         bool m_skipCheck;
+
+        static ObjectPool s_pool;
 };
 
 namespace BlizzLike
 {
     struct SpellNotifierCreatureAndPlayer
     {
-        std::list<Unit*> *i_data;
+        SpellTargetList *i_data;
         Spell &i_spell;
         const uint32& i_push_type;
         float i_radius, i_radiusSq;
@@ -613,7 +626,7 @@ namespace BlizzLike
         uint32 i_entry;
         const Position * const i_pos;
 
-        SpellNotifierCreatureAndPlayer(Spell &spell, std::list<Unit*> &data, float radius, const uint32 &type,
+        SpellNotifierCreatureAndPlayer(Spell &spell, SpellTargetList &data, float radius, const uint32 &type,
             SpellTargets TargetType = SPELL_TARGETS_ENEMY, const Position *pos = NULL, uint32 entry = 0)
             : i_data(&data), i_spell(spell), i_push_type(type), i_radius(radius), i_radiusSq(radius*radius)
             , i_TargetType(TargetType), i_pos(pos), i_entry(entry)
@@ -728,11 +741,17 @@ class SpellEvent : public BasicEvent
         SpellEvent(Spell* spell);
         virtual ~SpellEvent();
 
+        static void* operator new(size_t size) { return s_pool.Allocate(size); }
+        static void operator delete(void* p, size_t size) { s_pool.Deallocate(p, size); }
+
         virtual bool Execute(uint64 e_time, uint32 p_time);
         virtual void Abort(uint64 e_time);
         virtual bool IsDeletable() const;
     protected:
         Spell* m_Spell;
+
+    private:
+        static ObjectPool s_pool;
 };
 #endif
 
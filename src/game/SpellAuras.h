@@ -7,6 +7,7 @@
 #define BLIZZLIKE_SPELLAURAS_H
 
 #include "SpellAuraDefines.h"
+#include "Utilities/ObjectPool.h"
 
 struct DamageManaShield
 {
@@ -200,6 +201,11 @@ class Aura
 
         virtual ~Aura();
 
+        // one per effect and target, recycled through a per-thread free list;
+        // derived auras of another size (AreaAura) go to the heap
+        static void* operator new(size_t size) { return s_pool.Allocate(size); }
+        static void operator delete(void* p, size_t size) { s_pool.Deallocate(p, size); }
+
         void SetModifier(AuraType t, int32 a, uint32 pt, int32 miscValue);
         Modifier* GetModifier() {return &m_modifier;}
         int32 GetModifierValuePerStack() {return m_modifier.m_amount;}
@@ -351,6 +357,8 @@ class Aura
         void SetAuraFlag(uint32 slot, bool add);
         void SetAuraLevel(uint32 slot, uint32 level);
         void SetAuraApplication(uint32 slot, int8 count);
+
+        static ObjectPool s_pool;
 };
 
 class AreaAura : public Aura
@@ -17,7 +17,7 @@
 
 bool IsAreaEffectTarget[TOTAL_SPELL_TARGETS];
 
-SpellMgr::SpellMgr()
+SpellMgr::SpellMgr() : m_procTableGeneration(0)
 {
     for (int i = 0; i < TOTAL_SPELL_EFFECTS; ++i)
     {
@@ -1301,6 +1301,50 @@ void SpellMgr::LoadSpellProcEvents()
     */
 }
 
+uint32 SpellMgr::CalculateAuraProcFlags(SpellEntry const* spellProto, uint32 auraName) const
+{
+    // same order of checks as Unit::IsTriggeredAtSpellProcEvent
+    if (auraName >= TOTAL_AURAS || IsNonProcTriggerAura(auraName))
+        return 0;
+
+    SpellProcEventEntry const* spellProcEvent = GetSpellProcEvent(spellProto->Id);
+    if (!IsProcTriggerAura(auraName) && !spellProcEvent)
+        return 0;
+
+    if (spellProcEvent && spellProcEvent->procFlags)
+        return spellProcEvent->procFlags;
+    return spellProto->procFlags;
+}
+
+void SpellMgr::LoadAuraProcFlags()
+{
+    mAuraProcFlags.assign(sSpellStore.GetNumRows() * 3, 0);
+
+    uint32 count = 0;
+    for (uint32 id = 0; id < sSpellStore.GetNumRows(); ++id)
+    {
+        SpellEntry const* spellInfo = sSpellStore.LookupEntry(id);
+        if (!spellInfo)
+            continue;
+
+        for (uint8 eff = 0; eff < 3; ++eff)
+        {
+            if (!spellInfo->EffectApplyAuraName[eff])
+                continue;
+
+            if (uint32 procFlags = CalculateAuraProcFlags(spellInfo, spellInfo->EffectApplyAuraName[eff]))
+            {
+                mAuraProcFlags[id * 3 + eff] = procFlags;
+                ++count;
+            }
+        }
+    }
+
+    ++m_procTableGeneration;
+
+    sLog.outString(">> Compiled proc flags of %u aura effects", count);
+}
+
 /*
 bool SpellMgr::IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const * spellProcEvent, SpellEntry const * procSpell, uint32 procFlags)
 {
@@ -16,6 +16,7 @@
 
 #include "Utilities/UnorderedMap.h"
 #include <map>
+#include <vector>
 
 class Player;
 class Spell;
@@ -856,6 +857,17 @@ class SpellMgr
             return NULL;
         }
 
+        // proc flags an aura of this spell effect reacts to, 0 if it never procs
+        uint32 GetAuraProcFlags(SpellEntry const* spellProto, uint8 effIndex, uint32 auraName) const
+        {
+            // the modifier of some auras is changed at creation, compile those on the fly
+            if (auraName != spellProto->EffectApplyAuraName[effIndex] || spellProto->Id >= mAuraProcFlags.size() / 3)
+                return CalculateAuraProcFlags(spellProto, auraName);
+            return mAuraProcFlags[spellProto->Id * 3 + effIndex];
+        }
+        // changes at each spell_proc_event load, units rebuild their proc candidates then
+        uint32 GetProcTableGeneration() const { return m_procTableGeneration; }
+
         static bool IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const * spellProcEvent, uint32 EventProcFlag, SpellEntry const * procSpell, uint32 procFlags, uint32 procExtra, bool active);
 
         SpellEnchantProcEntry const* GetSpellEnchantProcEvent(uint32 enchId) const
@@ -1068,6 +1080,8 @@ class SpellMgr
         void LoadSpellCustomAttr();
         void LoadSpellLinked();
         void LoadSpellEnchantProcData();
+        // after LoadSpellProcEvents and LoadSpellCustomAttr, both change the result
+        void LoadAuraProcFlags();
 
     private:
         SpellScriptTarget  mSpellScriptTarget;
@@ -1085,6 +1099,11 @@ class SpellMgr
         SpellCustomAttribute  mSpellCustomAttr;
         SpellLinkedMap      mSpellLinkedMap;
         SpellEnchantProcEventMap     mSpellEnchantProcEventMap;
+
+        uint32 CalculateAuraProcFlags(SpellEntry const* spellProto, uint32 auraName) const;
+
+        std::vector<uint32> mAuraProcFlags;                 // 3 per spell id, see GetAuraProcFlags
+        uint32 m_procTableGeneration;
 };
 
 #define spellmgr SpellMgr::Instance()
@@ -182,7 +182,7 @@ bool TargetedMovementGenerator<T>::_setTargetLocation(T &owner)
 
         bool newPathCalculated = true;
         if (!i_path)
-            i_path = new PathInfo(&owner, x, y, z, forceDest);
+            i_path = new PathInfo(&owner, x, y, z, forceDest, true);
         else
         newPathCalculated = i_path->Update(x, y, z, forceDest);
 
@@ -311,6 +311,7 @@ bool TargetedMovementGenerator<T>::Update(T &owner, const uint32 & time_diff)
 
             bool targetMoved = false, needNewDest = false;
             bool forceRecalc = i_recalculateTravel || owner.IsStopped();
+            bool pathFound = i_path && i_path->hasAsyncResult();
             if (i_path && !forceRecalc)
             {
                 PathNode end_point = i_path->getEndPosition();
@@ -333,7 +334,7 @@ bool TargetedMovementGenerator<T>::Update(T &owner, const uint32 & time_diff)
             }
 
             // target moved
-            if (!i_path || targetMoved || needNewDest || forceRecalc)
+            if (!i_path || targetMoved || needNewDest || forceRecalc || pathFound)
             {
                 // (re)calculate path
                 _setTargetLocation(owner);
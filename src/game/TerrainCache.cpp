@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#include "TerrainCache.h"
+#include "GridDefines.h"
+
+#include <ace/Guard_T.h>
+
+#include <cmath>
+#include <cstring>
+
+TerrainCacheStats TerrainCache::s_stats;
+
+TerrainCache::TerrainCache() : m_maxEntries(0),
+    m_heightHits(0), m_heightMisses(0), m_areaHits(0), m_areaMisses(0)
+{
+}
+
+void TerrainCache::SetSize(uint32 maxEntries)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    m_maxEntries = maxEntries;
+    while (m_index.size() > m_maxEntries)
+    {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+}
+
+bool TerrainCache::MakeKey(float x, float y, float z, uint64& key)
+{
+    // also false for NaN, which never equals the stored position
+    if (!(fabs(x) < MAP_SIZE / 2) || !(fabs(y) < MAP_SIZE / 2) || !(fabs(z) < 1000000.0f))
+        return false;
+
+    // the bits of the position, the entry keeps the position itself
+    uint32 bx, by, bz;
+    memcpy(&bx, &x, sizeof(bx));
+    memcpy(&by, &y, sizeof(by));
+    memcpy(&bz, &z, sizeof(bz));
+
+    key = ((uint64(bx) << 32) | by) ^ (uint64(bz) * UI64LIT(0x9E3779B97F4A7C15));
+    return true;
+}
+
+uint16 TerrainCache::GetGridIndex(float x, float y)
+{
+    // same as Map::GetGrid
+    int gx = (int)(32 - x / SIZE_OF_GRIDS);
+    int gy = (int)(32 - y / SIZE_OF_GRIDS);
+    return uint16(gx * MAX_NUMBER_OF_GRIDS + gy);
+}
+
+TerrainCache::Entry* TerrainCache::Find(uint64 key, float x, float y, float z)
+{
+    EntryIndex::iterator itr = m_index.find(key);
+    if (itr == m_index.end())
+        return NULL;
+
+    Entry& entry = *itr->second;
+    if (entry.x != x || entry.y != y || entry.z != z)
+        return NULL;
+
+    m_entries.splice(m_entries.begin(), m_entries, itr->second);
+    return &m_entries.front();
+}
+
+TerrainCache::Entry* TerrainCache::FindOrInsert(uint64 key, float x, float y, float z)
+{
+    if (Entry* entry = Find(key, x, y, z))
+        return entry;
+
+    // reuse the entry of another position with the same key, or the least recently used one once full
+    EntryIndex::iterator itr = m_index.find(key);
+    if (itr != m_index.end())
+        m_entries.splice(m_entries.begin(), m_entries, itr->second);
+    else if (m_index.size() >= m_maxEntries)
+    {
+        m_index.erase(m_entries.back().key);
+        m_entries.splice(m_entries.begin(), m_entries, --m_entries.end());
+    }
+    else
+        m_entries.push_front(Entry());
+
+    Entry& entry = m_entries.front();
+    entry.key = key;
+    entry.x = x;
+    entry.y = y;
+    entry.z = z;
+    entry.grid = GetGridIndex(x, y);
+    entry.known = 0;
+    m_index[key] = m_entries.begin();
+    return &entry;
+}
+
+bool TerrainCache::GetVmapHeight(float x, float y, float z, float& height)
+{
+    uint64 key;
+    if (!m_maxEntries || !MakeKey(x, y, z, key))
+        return false;
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    Entry* entry = Find(key, x, y, z);
+    if (!entry || !(entry->known & KNOWN_VMAP_HEIGHT))
+    {
+        ++m_heightMisses;
+        return false;
+    }
+
+    ++m_heightHits;
+    height = entry->vmapHeight;
+    return true;
+}
+
+void TerrainCache::SetVmapHeight(float x, float y, float z, float height)
+{
+    uint64 key;
+    if (!m_maxEntries || !MakeKey(x, y, z, key))
+        return;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    Entry* entry = FindOrInsert(key, x, y, z);
+    entry->vmapHeight = height;
+    entry->known |= KNOWN_VMAP_HEIGHT;
+}
+
+bool TerrainCache::GetArea(float x, float y, float z, uint16& areaFlag, bool& outdoors)
+{
+    uint64 key;
+    if (!m_maxEntries || !MakeKey(x, y, z, key))
+        return false;
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    Entry* entry = Find(key, x, y, z);
+    if (!entry || !(entry->known & KNOWN_AREA))
+    {
+        ++m_areaMisses;
+        return false;
+    }
+
+    ++m_areaHits;
+    areaFlag = entry->areaFlag;
+    outdoors = entry->outdoors;
+    return true;
+}
+
+void TerrainCache::SetArea(float x, float y, float z, uint16 areaFlag, bool outdoors)
+{
+    uint64 key;
+    if (!m_maxEntries || !MakeKey(x, y, z, key))
+        return;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    Entry* entry = FindOrInsert(key, x, y, z);
+    entry->areaFlag = areaFlag;
+    entry->outdoors = outdoors;
+    entry->known |= KNOWN_AREA;
+}
+
+void TerrainCache::InvalidateGrid(uint32 gx, uint32 gy)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    uint16 grid = uint16(gx * MAX_NUMBER_OF_GRIDS + gy);
+    for (EntryList::iterator itr = m_entries.begin(); itr != m_entries.end();)
+    {
+        if (itr->grid == grid)
+        {
+            m_index.erase(itr->key);
+            itr = m_entries.erase(itr);
+        }
+        else
+            ++itr;
+    }
+}
+
+void TerrainCache::FlushStats()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (m_heightHits)
+        s_stats.heightHits += m_heightHits;
+    if (m_heightMisses)
+        s_stats.heightMisses += m_heightMisses;
+    if (m_areaHits)
+        s_stats.areaHits += m_areaHits;
+    if (m_areaMisses)
+        s_stats.areaMisses += m_areaMisses;
+
+    m_heightHits = 0;
+    m_heightMisses = 0;
+    m_areaHits = 0;
+    m_areaMisses = 0;
+}
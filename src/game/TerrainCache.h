@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#ifndef BLIZZLIKE_TERRAINCACHE_H
+#define BLIZZLIKE_TERRAINCACHE_H
+
+#include "Platform/Define.h"
+#include "Utilities/UnorderedMap.h"
+
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+#include <list>
+
+// hits and misses of the terrain caches of all maps
+struct TerrainCacheStats
+{
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> heightHits;
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> heightMisses;
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> areaHits;
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> areaMisses;
+};
+
+// Vmap height and area results of one map, kept for the exact position they
+// were asked for. Terrain and vmaps never change while their grid is loaded,
+// so a result is valid until the grid unloads. The least recently used
+// position is dropped once the cache is full.
+//
+// A map is mostly asked by the thread updating it, but other maps may look
+// at it too, so lookups are locked. The caller computes a missing result
+// outside of the lock and stores it afterwards.
+class TerrainCache
+{
+    public:
+        TerrainCache();
+
+        // 0 disables the cache
+        void SetSize(uint32 maxEntries);
+
+        // the vmap ray only, the .map height is cheap to read again
+        bool GetVmapHeight(float x, float y, float z, float& height);
+        void SetVmapHeight(float x, float y, float z, float height);
+
+        bool GetArea(float x, float y, float z, uint16& areaFlag, bool& outdoors);
+        void SetArea(float x, float y, float z, uint16 areaFlag, bool outdoors);
+
+        // grid coordinates as used by Map::GridMaps
+        void InvalidateGrid(uint32 gx, uint32 gy);
+
+        // adds the counters of this cache to the global ones, once per map update
+        void FlushStats();
+
+        static TerrainCacheStats& GetStats() { return s_stats; }
+
+    private:
+        enum
+        {
+            KNOWN_VMAP_HEIGHT   = 0x01,
+            KNOWN_AREA          = 0x02
+        };
+
+        struct Entry
+        {
+            uint64 key;
+            float x, y, z;                                  // positions sharing a key replace each other
+            uint16 grid;                                    // gx * MAX_NUMBER_OF_GRIDS + gy
+            uint8 known;
+            bool outdoors;
+            uint16 areaFlag;
+            float vmapHeight;
+        };
+
+        typedef std::list<Entry> EntryList;                 // most recently used first, counted by the index
+        typedef UNORDERED_MAP<uint64, EntryList::iterator> EntryIndex;
+
+        static bool MakeKey(float x, float y, float z, uint64& key);
+        static uint16 GetGridIndex(float x, float y);
+
+        Entry* Find(uint64 key, float x, float y, float z);
+        Entry* FindOrInsert(uint64 key, float x, float y, float z);
+
+        EntryList m_entries;
+        EntryIndex m_index;
+        uint32 m_maxEntries;
+        ACE_Thread_Mutex m_lock;
+
+        uint32 m_heightHits;
+        uint32 m_heightMisses;
+        uint32 m_areaHits;
+        uint32 m_areaMisses;
+
+        static TerrainCacheStats s_stats;
+};
+
+#endif
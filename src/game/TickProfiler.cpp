@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#include "TickProfiler.h"
+#include "Policies/SingletonImp.h"
+#include "Config/Config.h"
+#include "Log.h"
+
+#include <ace/TSS_T.h>
+#include <ace/High_Res_Timer.h>
+#include <ace/Guard_T.h>
+
+#include <algorithm>
+#include <map>
+
+INSTANTIATE_SINGLETON_1(TickProfiler);
+
+volatile bool TickProfiler::s_active = false;
+
+namespace
+{
+    // not owning, buffers outlive their threads so a capture can still be exported
+    struct TickProfileThreadSlot
+    {
+        TickProfileThreadSlot() : buffer(NULL) {}
+        TickProfileThreadBuffer* buffer;
+    };
+
+    ACE_TSS<TickProfileThreadSlot> s_threadSlot;
+
+    struct TickProfileEventOrder
+    {
+        bool operator()(TickProfileEvent const& a, TickProfileEvent const& b) const
+        {
+            if (a.start != b.start)
+                return a.start < b.start;
+            return a.depth < b.depth;
+        }
+    };
+
+    // events of one buffer, oldest first
+    void CollectEvents(TickProfileThreadBuffer const* buffer, std::vector<TickProfileEvent>& events)
+    {
+        uint32 size = buffer->events.size();
+        uint32 first = buffer->count < size ? 0 : buffer->next;
+        events.reserve(buffer->count);
+        for (uint32 i = 0; i < buffer->count; ++i)
+            events.push_back(buffer->events[(first + i) % size]);
+    }
+}
+
+TickProfiler::TickProfiler() : m_pendingTicks(0), m_remainingTicks(0), m_bufferSize(0)
+{
+}
+
+TickProfiler::~TickProfiler()
+{
+    for (size_t i = 0; i < m_buffers.size(); ++i)
+        delete m_buffers[i];
+}
+
+uint64 TickProfiler::Now()
+{
+    ACE_Time_Value now = ACE_High_Res_Timer::gettimeofday_hr();
+    return uint64(now.sec()) * 1000000 + now.usec();
+}
+
+bool TickProfiler::StartCapture(uint32 ticks)
+{
+    if (!ticks || s_active || m_pendingTicks)
+        return false;
+
+    m_pendingTicks = ticks;
+    return true;
+}
+
+void TickProfiler::BeginTick()
+{
+    if (!m_pendingTicks)
+        return;
+
+    m_bufferSize = sConfig.GetIntDefault("TickProfiler.BufferSize", 65536);
+    if (m_bufferSize < 1024)
+        m_bufferSize = 1024;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_buffersLock);
+        for (size_t i = 0; i < m_buffers.size(); ++i)
+        {
+            m_buffers[i]->next = 0;
+            m_buffers[i]->count = 0;
+            m_buffers[i]->events.resize(m_bufferSize);
+        }
+    }
+
+    m_remainingTicks = m_pendingTicks;
+    m_pendingTicks = 0;
+    s_active = true;
+
+    sLog.outString("TickProfiler: capturing %u ticks", m_remainingTicks);
+}
+
+void TickProfiler::EndTick()
+{
+    if (!s_active)
+        return;
+
+    if (--m_remainingTicks)
+        return;
+
+    StopAndExport();
+}
+
+TickProfileThreadBuffer* TickProfiler::GetThreadBuffer()
+{
+    if (s_threadSlot->buffer)
+        return s_threadSlot->buffer;
+
+    TickProfileThreadBuffer* buffer = new TickProfileThreadBuffer;
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_buffersLock, NULL);
+    buffer->id = m_buffers.size() + 1;
+    buffer->events.resize(m_bufferSize);
+    m_buffers.push_back(buffer);
+    s_threadSlot->buffer = buffer;
+    return buffer;
+}
+
+void TickProfiler::StopAndExport()
+{
+    s_active = false;
+
+    // map updates of the last tick are finished, no thread writes to the buffers any more
+    time_t t = time(NULL);
+    tm* aTm = localtime(&t);
+    char name[64];
+    snprintf(name, 64, "tickprofile_%04d-%02d-%02d_%02d-%02d-%02d",
+        aTm->tm_year+1900, aTm->tm_mon+1, aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+
+    std::string logsDir = sConfig.GetStringDefault("LogsDir", "");
+    if (!logsDir.empty() && logsDir[logsDir.length() - 1] != '/' && logsDir[logsDir.length() - 1] != '\\')
+        logsDir.append("/");
+
+    m_lastCapture = logsDir + name;
+    ExportChromeTrace(m_lastCapture + ".json");
+    ExportFoldedStacks(m_lastCapture + ".folded");
+
+    sLog.outString("TickProfiler: capture written to %s.json and %s.folded", m_lastCapture.c_str(), m_lastCapture.c_str());
+}
+
+void TickProfiler::ExportChromeTrace(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("TickProfiler: can't open %s for writing", fileName.c_str());
+        return;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_buffersLock);
+    for (size_t b = 0; b < m_buffers.size(); ++b)
+    {
+        std::vector<TickProfileEvent> events;
+        CollectEvents(m_buffers[b], events);
+
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            TickProfileEvent const& ev = events[i];
+            fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":" UI64FMTD ",\"dur\":%u,\"args\":{\"arg\":%u}}",
+                first ? "" : ",\n", ev.name, m_buffers[b]->id, ev.start, ev.duration, ev.arg);
+            first = false;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+}
+
+void TickProfiler::ExportFoldedStacks(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("TickProfiler: can't open %s for writing", fileName.c_str());
+        return;
+    }
+
+    // stack path -> self time in microseconds
+    std::map<std::string, int64> selfTime;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_buffersLock);
+    for (size_t b = 0; b < m_buffers.size(); ++b)
+    {
+        std::vector<TickProfileEvent> events;
+        CollectEvents(m_buffers[b], events);
+        std::sort(events.begin(), events.end(), TickProfileEventOrder());
+
+        char threadName[32];
+        snprintf(threadName, 32, "thread-%u", m_buffers[b]->id);
+
+        // paths of the currently open parents, index is the depth
+        std::vector<std::string> stack;
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            TickProfileEvent const& ev = events[i];
+
+            // the parent of an overwritten zone is lost, attach it to the deepest known one
+            if (stack.size() > ev.depth)
+                stack.resize(ev.depth);
+
+            std::string path = (stack.empty() ? std::string(threadName) : stack.back()) + ";" + ev.name;
+            selfTime[path] += ev.duration;
+            if (!stack.empty())
+                selfTime[stack.back()] -= ev.duration;
+
+            stack.push_back(path);
+        }
+    }
+
+    for (std::map<std::string, int64>::const_iterator itr = selfTime.begin(); itr != selfTime.end(); ++itr)
+        if (itr->second > 0)
+            fprintf(file, "%s " SI64FMTD "\n", itr->first.c_str(), itr->second);
+
+    fclose(file);
+}
+
+void TickProfileZone::Enter(const char* name, uint32 arg)
+{
+    m_buffer = sTickProfiler.GetThreadBuffer();
+    if (!m_buffer)
+        return;
+
+    m_name = name;
+    m_arg = arg;
+    m_depth = m_buffer->depth++;
+    m_start = TickProfiler::Now();
+}
+
+void TickProfileZone::Leave()
+{
+    uint64 end = TickProfiler::Now();
+    --m_buffer->depth;
+
+    if (m_buffer->events.empty())
+        return;
+
+    TickProfileEvent& ev = m_buffer->events[m_buffer->next];
+    ev.name = m_name;
+    ev.start = m_start;
+    ev.duration = uint32(end - m_start);
+    ev.arg = m_arg;
+    ev.depth = m_depth;
+
+    if (++m_buffer->next == m_buffer->events.size())
+        m_buffer->next = 0;
+    if (m_buffer->count < m_buffer->events.size())
+        ++m_buffer->count;
+}
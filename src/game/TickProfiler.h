@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#ifndef __BLIZZLIKE_TICKPROFILER_H
+#define __BLIZZLIKE_TICKPROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <ace/Thread_Mutex.h>
+
+#include <vector>
+
+// One finished zone, recorded when the zone is left
+struct TickProfileEvent
+{
+    const char* name;                                       // static string, never copied
+    uint64 start;                                           // microseconds
+    uint32 duration;                                        // microseconds
+    uint32 arg;                                             // map id, entry... 0 if unused
+    uint16 depth;                                           // nesting level inside the thread
+};
+
+// Ring buffer owned by one thread, only that thread writes to it
+struct TickProfileThreadBuffer
+{
+    TickProfileThreadBuffer() : id(0), depth(0), next(0), count(0) {}
+
+    uint32 id;
+    uint16 depth;
+    uint32 next;                                            // slot the next event goes to
+    uint32 count;                                           // valid events, at most events.size()
+    std::vector<TickProfileEvent> events;
+};
+
+// Hierarchical profiler of the world and map update loops.
+//
+// Zones are placed with PROFILE_ZONE(...) and cost one flag test while no
+// capture is running. A capture records every zone of the next N world
+// ticks into per-thread ring buffers and writes them out as a Chrome trace
+// (chrome://tracing, Perfetto) and as folded stacks (flamegraph.pl).
+class TickProfiler
+{
+    public:
+        TickProfiler();
+        ~TickProfiler();
+
+        static bool IsActive() { return s_active; }
+        static uint64 Now();
+
+        // starts recording at the next tick, false if a capture is already running
+        bool StartCapture(uint32 ticks);
+        uint32 GetRemainingTicks() const { return m_remainingTicks; }
+        std::string const& GetLastCaptureName() const { return m_lastCapture; }
+
+        // called by World::Update around one tick
+        void BeginTick();
+        void EndTick();
+
+        // buffer of the calling thread, created on first use
+        TickProfileThreadBuffer* GetThreadBuffer();
+
+    private:
+        void StopAndExport();
+        void ExportChromeTrace(std::string const& fileName);
+        void ExportFoldedStacks(std::string const& fileName);
+
+        static volatile bool s_active;
+
+        uint32 m_pendingTicks;                              // requested, waiting for the next tick
+        uint32 m_remainingTicks;
+        uint32 m_bufferSize;
+        std::string m_lastCapture;
+
+        ACE_Thread_Mutex m_buffersLock;                     // guards registration of thread buffers
+        std::vector<TickProfileThreadBuffer*> m_buffers;
+};
+
+#define sTickProfiler BlizzLike::Singleton<TickProfiler>::Instance()
+
+// RAII zone, records its wall time on scope exit when a capture is running
+class TickProfileZone
+{
+    public:
+        explicit TickProfileZone(const char* name, uint32 arg = 0) : m_buffer(NULL)
+        {
+            if (TickProfiler::IsActive())
+                Enter(name, arg);
+        }
+
+        ~TickProfileZone()
+        {
+            if (m_buffer)
+                Leave();
+        }
+
+    private:
+        void Enter(const char* name, uint32 arg);
+        void Leave();
+
+        TickProfileThreadBuffer* m_buffer;
+        const char* m_name;
+        uint64 m_start;
+        uint32 m_arg;
+        uint16 m_depth;
+};
+
+#define PROFILE_ZONE(name) TickProfileZone _tickProfileZone(name)
+#define PROFILE_ZONE_ARG(name, arg) TickProfileZone _tickProfileZone(name, arg)
+
+#endif
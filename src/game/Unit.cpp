@@ -214,7 +214,7 @@ void MovementInfo::Write(ByteBuffer &data) const
 Unit::Unit()
 : WorldObject(), i_motionMaster(this), m_ThreatManager(this), m_HostileRefManager(this)
 , IsAIEnabled(false), NeedChangeAI(false)
-, i_AI(NULL), i_disabledAI(NULL), m_removedAurasCount(0), m_procDeep(0)
+, i_AI(NULL), i_disabledAI(NULL), m_removedAurasCount(0), m_procAurasFlags(0), m_procAurasGeneration(0), m_procDeep(0)
 , m_ControlledByPlayer(false)
 {
     m_objectType |= TYPEMASK_UNIT;
@@ -3594,6 +3594,7 @@ bool Unit::AddAura(Aura *Aur)
     // add aura, register in lists and arrays
     Aur->_AddAura();
     m_Auras.insert(AuraMap::value_type(spellEffectPair(Aur->GetId(), Aur->GetEffIndex()), Aur));
+    AddProcAura(Aur);
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
         m_modAuras[Aur->GetModifier()->m_auraname].push_back(Aur);
@@ -4071,6 +4072,7 @@ void Unit::RemoveAura(AuraMap::iterator &i, AuraRemoveMode mode)
     // some ShapeshiftBoosts at remove trigger removing other auras including parent Shapeshift aura
     // remove aura from list before to prevent deleting it before
     m_Auras.erase(i);
+    RemoveProcAura(Aur);
     ++m_removedAurasCount;
 
     SpellEntry const* AurSpellInfo = Aur->GetSpellProto();
@@ -10578,6 +10580,16 @@ void InitTriggerAuraData()
     isNonTriggerAura[SPELL_AURA_RESIST_PUSHBACK]=true;
 }
 
+bool IsProcTriggerAura(uint32 auraType)
+{
+    return auraType < TOTAL_AURAS && isTriggerAura[auraType];
+}
+
+bool IsNonProcTriggerAura(uint32 auraType)
+{
+    return auraType < TOTAL_AURAS && isNonTriggerAura[auraType];
+}
+
 uint32 createProcExtendMask(SpellNonMeleeDamage *damageInfo, SpellMissInfo missCondition)
 {
     uint32 procEx = PROC_EX_NONE;
@@ -10704,24 +10716,39 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag,
         }
     }
 
+    if (m_procAurasGeneration != spellmgr.GetProcTableGeneration())
+        RebuildProcAuras();
+
+    // no aura of this unit reacts to the event
+    if (!(m_procAurasFlags & procFlag))
+    {
+        --m_procDeep;
+        return;
+    }
+
     RemoveSpellList removedSpells;
     ProcTriggeredList procTriggered;
-    // Fill procTriggered list
-    for (AuraMap::const_iterator itr = GetAuras().begin(); itr != GetAuras().end(); ++itr)
+    // Fill procTriggered list, only auras which can proc on one of the flags are looked at
+    bool active = (damage > 0) || (procExtra & PROC_EX_ABSORB && isVictim);
+    for (ProcAuraMap::const_iterator itr = m_procAuras.begin(); itr != m_procAuras.end(); ++itr)
     {
+        if (!(itr->second.procFlags & procFlag))
+            continue;
+
         SpellProcEventEntry const* spellProcEvent = NULL;
-        bool active = (damage > 0) || (procExtra & PROC_EX_ABSORB && isVictim);
-        if (!IsTriggeredAtSpellProcEvent(pTarget, itr->second, procSpell, procFlag, procExtra, attType, isVictim, active, spellProcEvent))
+        if (!IsTriggeredAtSpellProcEvent(pTarget, itr->second.aura, procSpell, procFlag, procExtra, attType, isVictim, active, spellProcEvent))
            continue;
 
-        procTriggered.push_back(ProcTriggeredData(spellProcEvent, itr->second));
+        procTriggered.push_back(ProcTriggeredData(spellProcEvent, itr->second.aura));
     }
     // Handle effects proceed this time
+    uint32 removedAuras = m_removedAurasCount;
     for (ProcTriggeredList::iterator i = procTriggered.begin(); i != procTriggered.end(); ++i)
     {
         // Some auras can be deleted in function called in this loop (except first, ofc)
         // Until storing auars in std::multimap to hard check deleting by another way
-        if (i != procTriggered.begin())
+        // nothing to check while no aura was removed since the list was filled
+        if (i != procTriggered.begin() && removedAuras != m_removedAurasCount)
         {
             bool found = false;
             AuraMap::const_iterator lower = GetAuras().lower_bound(i->triggeredByAura_SpellPair);
@@ -11148,17 +11175,7 @@ Unit* Unit::SelectNearbyTarget(float dist) const
         targets.remove(getVictim());
 
     // remove not LoS targets
-    for (std::list<Unit* >::iterator tIter = targets.begin(); tIter != targets.end();)
-    {
-        if (!IsWithinLOSInMap(*tIter))
-        {
-            std::list<Unit* >::iterator tIter2 = tIter;
-            ++tIter;
-            targets.erase(tIter2);
-        }
-        else
-            ++tIter;
-    }
+    RemoveNotWithinLOSInMap(targets);
 
     // no appropriate targets
     if (targets.empty())
@@ -11428,6 +11445,43 @@ Pet* Unit::CreateTamedPetFrom(Creature* creatureTarget,uint32 spell_id)
     return pet;
 }
 
+void Unit::AddProcAura(Aura* aura)
+{
+    uint32 procFlags = spellmgr.GetAuraProcFlags(aura->GetSpellProto(), aura->GetEffIndex(), aura->GetModifier()->m_auraname);
+    if (!procFlags)
+        return;
+
+    m_procAuras.insert(ProcAuraMap::value_type(spellEffectPair(aura->GetId(), aura->GetEffIndex()), ProcAura(procFlags, aura)));
+    m_procAurasFlags |= procFlags;
+}
+
+void Unit::RemoveProcAura(Aura* aura)
+{
+    spellEffectPair spair = spellEffectPair(aura->GetId(), aura->GetEffIndex());
+    for (ProcAuraMap::iterator itr = m_procAuras.lower_bound(spair); itr != m_procAuras.upper_bound(spair); ++itr)
+    {
+        if (itr->second.aura != aura)
+            continue;
+
+        m_procAuras.erase(itr);
+
+        m_procAurasFlags = 0;
+        for (itr = m_procAuras.begin(); itr != m_procAuras.end(); ++itr)
+            m_procAurasFlags |= itr->second.procFlags;
+        return;
+    }
+}
+
+void Unit::RebuildProcAuras()
+{
+    m_procAuras.clear();
+    m_procAurasFlags = 0;
+    m_procAurasGeneration = spellmgr.GetProcTableGeneration();
+
+    for (AuraMap::const_iterator itr = m_Auras.begin(); itr != m_Auras.end(); ++itr)
+        AddProcAura(itr->second);
+}
+
 bool Unit::IsTriggeredAtSpellProcEvent(Unit* pVictim, Aura* aura, SpellEntry const* procSpell, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, bool isVictim, bool active, SpellProcEventEntry const*& spellProcEvent )
 {
     SpellEntry const *spellProto = aura->GetSpellProto();
@@ -12277,7 +12331,8 @@ bool Unit::IsInRaidWith(Unit const *unit) const
         return false;
 }
 
-void Unit::GetRaidMember(std::list<Unit*> &nearMembers, float radius)
+template<class UnitList>
+void Unit::GetRaidMember(UnitList &nearMembers, float radius)
 {
     Player* owner = GetCharmerOrOwnerPlayerOrPlayerItself();
     if (!owner)
@@ -12298,7 +12353,8 @@ void Unit::GetRaidMember(std::list<Unit*> &nearMembers, float radius)
     }
 }
 
-void Unit::GetPartyMember(std::list<Unit*> &TagUnitMap, float radius)
+template<class UnitList>
+void Unit::GetPartyMember(UnitList &TagUnitMap, float radius)
 {
     Unit* owner = GetCharmerOrOwnerOrSelf();
     Group *pGroup = NULL;
@@ -12335,6 +12391,10 @@ void Unit::GetPartyMember(std::list<Unit*> &TagUnitMap, float radius)
     }
 }
 
+template void Unit::GetRaidMember<SpellTargetList>(SpellTargetList &, float);
+template void Unit::GetPartyMember<SpellTargetList>(SpellTargetList &, float);
+template void Unit::GetPartyMember<std::list<Unit*> >(std::list<Unit*> &, float);
+
 void Unit::AddAura(uint32 spellId, Unit* target)
 {
     if (!target || !target->isAlive())
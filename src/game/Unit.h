@@ -651,6 +651,10 @@ struct SpellNonMeleeDamage{
 
 uint32 createProcExtendMask(SpellNonMeleeDamage *damageInfo, SpellMissInfo missCondition);
 
+// auras which can proc without a spell_proc_event entry, and auras which never proc
+bool IsProcTriggerAura(uint32 auraType);
+bool IsNonProcTriggerAura(uint32 auraType);
+
 struct UnitActionBarEntry
 {
     uint32 Type;
@@ -816,6 +820,15 @@ class Unit : public WorldObject
         typedef std::set<Unit*> ControlList;
         typedef std::pair<uint32, uint8> spellEffectPair;
         typedef std::multimap< spellEffectPair, Aura*> AuraMap;
+
+        // auras of m_Auras which can proc, with the proc flags they react to
+        struct ProcAura
+        {
+            ProcAura(uint32 _procFlags, Aura* _aura) : procFlags(_procFlags), aura(_aura) {}
+            uint32 procFlags;
+            Aura* aura;
+        };
+        typedef std::multimap< spellEffectPair, ProcAura> ProcAuraMap;
         typedef std::list<Aura *> AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<AuraType> AuraTypeSet;
@@ -948,8 +961,9 @@ class Unit : public WorldObject
         bool IsNeutralToAll() const;
         bool IsInPartyWith(Unit const* unit) const;
         bool IsInRaidWith(Unit const* unit) const;
-        void GetPartyMember(std::list<Unit*> &units, float dist);
-        void GetRaidMember(std::list<Unit*> &units, float dist);
+        // UnitList is std::list<Unit*> or SpellTargetList
+        template<class UnitList> void GetPartyMember(UnitList &units, float dist);
+        template<class UnitList> void GetRaidMember(UnitList &units, float dist);
         bool IsContestedGuard() const
         {
             if (FactionTemplateEntry const* entry = getFactionTemplateEntry())
@@ -1551,6 +1565,11 @@ class Unit : public WorldObject
         AuraMap::iterator m_AurasUpdateIterator;
         uint32 m_removedAurasCount;
 
+        // proc candidates, kept in m_Auras order so procs are handled as before
+        ProcAuraMap m_procAuras;
+        uint32 m_procAurasFlags;                            // union of the candidates' proc flags
+        uint32 m_procAurasGeneration;                       // SpellMgr proc table the candidates were built from
+
         typedef std::list<uint64> DynObjectGUIDs;
         DynObjectGUIDs m_dynObjGUIDs;
 
@@ -1585,6 +1604,10 @@ class Unit : public WorldObject
         ThreatManager m_ThreatManager;
 
     private:
+        void AddProcAura(Aura* aura);
+        void RemoveProcAura(Aura* aura);
+        void RebuildProcAuras();
+
         bool IsTriggeredAtSpellProcEvent(Unit* pVictim, Aura* aura, SpellEntry const* procSpell, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, bool isVictim, bool active, SpellProcEventEntry const*& spellProcEvent);
         bool HandleDummyAuraProc(  Unit* pVictim, uint32 damage, Aura* triggredByAura, SpellEntry const *procSpell, uint32 procFlag, uint32 procEx, uint32 cooldown);
         bool HandleHasteAuraProc(  Unit* pVictim, uint32 damage, Aura* triggredByAura, SpellEntry const *procSpell, uint32 procFlag, uint32 procEx, uint32 cooldown);
@@ -1618,12 +1641,12 @@ class Unit : public WorldObject
 
 namespace BlizzLike
 {
-    template<class T>
-    void RandomResizeList(std::list<T> &_list, uint32 _size)
+    template<class T, class A>
+    void RandomResizeList(std::list<T, A> &_list, uint32 _size)
     {
         while (_list.size() > _size)
         {
-            typename std::list<T>::iterator itr = _list.begin();
+            typename std::list<T, A>::iterator itr = _list.begin();
             advance(itr, urand(0, _list.size() - 1));
             _list.erase(itr);
         }
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#include "WhoListMgr.h"
+#include "Policies/SingletonImp.h"
+#include "ObjectAccessor.h"
+#include "ObjectMgr.h"
+#include "Player.h"
+#include "WorldSession.h"
+#include "World.h"
+#include "Util.h"
+
+#include <algorithm>
+
+INSTANTIATE_SINGLETON_1(WhoListMgr);
+
+namespace
+{
+    struct WhoListLevelOrder
+    {
+        bool operator()(WhoListPlayerInfo const& a, WhoListPlayerInfo const& b) const
+        {
+            return a.level < b.level;
+        }
+    };
+}
+
+void WhoListSnapshot::SelectCandidates(uint32 level_min, uint32 level_max, uint32 const* zoneids, uint32 zones_count, IndexList& indexes) const
+{
+    if (level_min > STRONG_MAX_LEVEL || level_min > level_max)
+        return;
+
+    if (level_max > STRONG_MAX_LEVEL)
+        level_max = STRONG_MAX_LEVEL;
+
+    uint32 first = m_levelStart[level_min];
+    uint32 last = m_levelStart[level_max + 1];
+
+    if (!zones_count)
+    {
+        indexes.reserve(last - first);
+        for (uint32 i = first; i < last; ++i)
+            indexes.push_back(i);
+        return;
+    }
+
+    for (uint32 z = 0; z < zones_count; ++z)
+    {
+        // client may send the same zone several times
+        bool duplicate = false;
+        for (uint32 k = 0; k < z; ++k)
+        {
+            if (zoneids[k] == zoneids[z])
+            {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate)
+            continue;
+
+        ZoneIndexMap::const_iterator itr = m_zoneIndex.find(zoneids[z]);
+        if (itr == m_zoneIndex.end())
+            continue;
+
+        // zone lists are ascending, so the level range is a contiguous slice
+        IndexList const& zoneList = itr->second;
+        for (IndexList::const_iterator i = std::lower_bound(zoneList.begin(), zoneList.end(), first); i != zoneList.end() && *i < last; ++i)
+            indexes.push_back(*i);
+    }
+}
+
+bool WhoListSnapshot::IsVisibleGloballyFor(WhoListPlayerInfo const& target, uint64 viewerGuid, uint32 viewerSecurity)
+{
+    if (target.guid == viewerGuid)
+        return true;
+
+    if (target.visibility == VISIBILITY_ON)
+        return true;
+
+    if (viewerSecurity > SEC_PLAYER)
+        return target.security <= viewerSecurity;
+
+    if (target.visibility == VISIBILITY_OFF)
+        return false;
+
+    return true;
+}
+
+WhoListMgr::WhoListMgr() : m_snapshot(new WhoListSnapshot), m_updateTimer(0),
+    m_servedQueries(0), m_droppedQueries(0), m_rebuildCount(0)
+{
+    for (uint32 i = 0; i < STRONG_MAX_LEVEL + 2; ++i)
+        m_snapshot->m_levelStart[i] = 0;
+}
+
+void WhoListMgr::Update(uint32 diff)
+{
+    if (m_updateTimer > diff)
+    {
+        m_updateTimer -= diff;
+        return;
+    }
+
+    Rebuild();
+    m_updateTimer = sWorld.getConfig(CONFIG_WHO_LIST_UPDATE_INTERVAL);
+}
+
+void WhoListMgr::Rebuild()
+{
+    WhoListSnapshot* snapshot = new WhoListSnapshot;
+
+    {
+        ObjectAccessor::Guard guard(*HashMapHolder<Player>::GetLock());
+        HashMapHolder<Player>::MapType& m = ObjectAccessor::Instance().GetPlayers();
+        snapshot->m_players.reserve(m.size());
+
+        for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+        {
+            Player* plr = itr->second;
+            if (!plr->IsInWorld())
+                continue;
+
+            WhoListPlayerInfo info;
+            info.guid = plr->GetGUID();
+            info.team = plr->GetTeam();
+            info.security = plr->GetSession()->GetSecurity();
+            info.level = plr->getLevel();
+            info.zoneId = plr->GetZoneId();
+            info.class_ = plr->getClass();
+            info.race = plr->getRace();
+            info.gender = plr->getGender();
+            info.visibility = uint8(plr->GetVisibility());
+            info.name = plr->GetName();
+            info.guildName = objmgr.GetGuildNameById(plr->GetGuildId());
+
+            if (!Utf8toWStr(info.name, info.wname) || !Utf8toWStr(info.guildName, info.wguildName))
+                continue;
+
+            wstrToLower(info.wname);
+            wstrToLower(info.wguildName);
+
+            snapshot->m_players.push_back(info);
+        }
+    }
+
+    std::stable_sort(snapshot->m_players.begin(), snapshot->m_players.end(), WhoListLevelOrder());
+
+    uint32 count = snapshot->m_players.size();
+    uint32 idx = 0;
+    for (uint32 lvl = 0; lvl <= STRONG_MAX_LEVEL + 1; ++lvl)
+    {
+        while (idx < count && snapshot->m_players[idx].level < lvl)
+            ++idx;
+        snapshot->m_levelStart[lvl] = idx;
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+        snapshot->m_zoneIndex[snapshot->m_players[i].zoneId].push_back(i);
+
+    WhoListSnapshot_AutoPtr ptr(snapshot);
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_snapshotLock);
+    m_snapshot = ptr;
+    ++m_rebuildCount;
+}
+
+WhoListSnapshot_AutoPtr WhoListMgr::GetSnapshot()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_snapshotLock, m_snapshot);
+    return m_snapshot;
+}
+
+bool WhoListMgr::RegisterQuery(uint32 security, time_t& windowEnd, uint32& windowCount)
+{
+    uint32 maxQueries = sWorld.getConfig(CONFIG_WHO_LIST_MAX_QUERIES);
+    if (!maxQueries || security > SEC_PLAYER)
+    {
+        ++m_servedQueries;
+        return true;
+    }
+
+    time_t now = time(NULL);
+    if (now >= windowEnd)
+    {
+        windowEnd = now + MINUTE;
+        windowCount = 0;
+    }
+
+    if (++windowCount > maxQueries)
+    {
+        ++m_droppedQueries;
+        return false;
+    }
+
+    ++m_servedQueries;
+    return true;
+}
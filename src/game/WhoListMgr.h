@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#ifndef __BLIZZLIKE_WHOLISTMGR_H
+#define __BLIZZLIKE_WHOLISTMGR_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Utilities/UnorderedMap.h"
+#include "DBCEnums.h"
+
+#include <ace/Refcounted_Auto_Ptr.h>
+#include <ace/Thread_Mutex.h>
+
+#include <vector>
+
+// One online player as seen by /who at the moment the snapshot was taken
+struct WhoListPlayerInfo
+{
+    uint64 guid;
+    uint32 team;
+    uint32 security;
+    uint32 level;
+    uint32 zoneId;
+    uint8 class_;
+    uint8 race;
+    uint8 gender;
+    uint8 visibility;                                       // UnitVisibility of the player
+
+    std::string name;
+    std::string guildName;
+    std::wstring wname;                                     // lower case, for substring search
+    std::wstring wguildName;                                // lower case, for substring search
+};
+
+// Immutable list of online players, sorted by level, with zone and level indexes
+class WhoListSnapshot
+{
+    friend class WhoListMgr;
+
+    public:
+        typedef std::vector<WhoListPlayerInfo> PlayerInfoList;
+        typedef std::vector<uint32> IndexList;
+
+        PlayerInfoList const& GetPlayers() const { return m_players; }
+
+        // fills 'indexes' with players in [level_min, level_max] and (if zones_count) in one of the zones
+        void SelectCandidates(uint32 level_min, uint32 level_max, uint32 const* zoneids, uint32 zones_count, IndexList& indexes) const;
+
+        // same rules as Player::IsVisibleGloballyFor, resolved against snapshot data
+        static bool IsVisibleGloballyFor(WhoListPlayerInfo const& target, uint64 viewerGuid, uint32 viewerSecurity);
+
+    private:
+        typedef UNORDERED_MAP<uint32, IndexList> ZoneIndexMap;
+
+        PlayerInfoList m_players;
+        uint32 m_levelStart[STRONG_MAX_LEVEL + 2];          // first index of m_players with level >= i
+        ZoneIndexMap m_zoneIndex;                           // zone id -> ascending indexes into m_players
+};
+
+typedef ACE_Refcounted_Auto_Ptr<WhoListSnapshot, ACE_Thread_Mutex> WhoListSnapshot_AutoPtr;
+
+class WhoListMgr
+{
+    public:
+        WhoListMgr();
+
+        // called from World::Update, rebuilds the snapshot when the refresh interval has passed
+        void Update(uint32 diff);
+        void Rebuild();
+
+        WhoListSnapshot_AutoPtr GetSnapshot();
+
+        // per-session rate accounting, returns false if the query has to be dropped
+        bool RegisterQuery(uint32 security, time_t& windowEnd, uint32& windowCount);
+
+        uint32 GetServedQueries() const { return m_servedQueries; }
+        uint32 GetDroppedQueries() const { return m_droppedQueries; }
+        uint32 GetRebuildCount() const { return m_rebuildCount; }
+
+    private:
+        WhoListSnapshot_AutoPtr m_snapshot;
+        ACE_Thread_Mutex m_snapshotLock;                    // guards only the pointer swap
+        uint32 m_updateTimer;
+
+        uint32 m_servedQueries;
+        uint32 m_droppedQueries;
+        uint32 m_rebuildCount;
+};
+
+#define sWhoListMgr BlizzLike::Singleton<WhoListMgr>::Instance()
+
+#endif
@@ -49,6 +49,8 @@
 #include "CreatureEventAIMgr.h"
 #include "ScriptMgr.h"
 #include "ProgressBar.h"
+#include "WhoListMgr.h"
+#include "TickProfiler.h"
 
 INSTANTIATE_SINGLETON_1(World);
 
@@ -533,6 +535,8 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_GRID_UNLOAD] = sConfig.GetBoolDefault("GridUnload", true);
     m_configs[CONFIG_INTERVAL_SAVE] = sConfig.GetIntDefault("PlayerSaveInterval", 900000);
     m_configs[CONFIG_INTERVAL_DISCONNECT_TOLERANCE] = sConfig.GetIntDefault("DisconnectToleranceInterval", 0);
+    m_configs[CONFIG_INTERVAL_CHARDB_WRITEBEHIND] = sConfig.GetIntDefault("CharacterDatabase.WriteBehindInterval", 1000);
+    CharacterDatabaseWriter.SetFlushInterval(m_configs[CONFIG_INTERVAL_CHARDB_WRITEBEHIND]);
 
     m_configs[CONFIG_INTERVAL_GRIDCLEAN] = sConfig.GetIntDefault("GridCleanUpDelay", 300000);
     if (m_configs[CONFIG_INTERVAL_GRIDCLEAN] < MIN_GRID_DELAY)
@@ -1041,6 +1045,8 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_PET_LOS] = enablePetLOS;
     m_configs[CONFIG_VMAP_TOTEM] = sConfig.GetBoolDefault("vmap.totem", false);
     m_configs[CONFIG_MAX_WHO] = sConfig.GetIntDefault("MaxWhoListReturns", 49);
+    m_configs[CONFIG_WHO_LIST_UPDATE_INTERVAL] = sConfig.GetIntDefault("WhoList.UpdateInterval", 5000);
+    m_configs[CONFIG_WHO_LIST_MAX_QUERIES] = sConfig.GetIntDefault("WhoList.MaxQueriesPerMinute", 30);
 
     m_configs[CONFIG_BG_START_MUSIC] = sConfig.GetBoolDefault("MusicInBattleground", false);
     m_configs[CONFIG_START_ALL_SPELLS] = sConfig.GetBoolDefault("PlayerStart.AllSpells", false);
@@ -1064,6 +1070,22 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_INTERVAL_LOG_UPDATE] = sConfig.GetIntDefault("RecordUpdateTimeDiffInterval", 60000);
     m_configs[CONFIG_MIN_LOG_UPDATE] = sConfig.GetIntDefault("MinRecordUpdateTimeDiff", 100);
     m_configs[CONFIG_NUMTHREADS] = sConfig.GetIntDefault("MapUpdate.Threads",1);
+    m_configs[CONFIG_MAP_PACKET_PROCESSING] = sConfig.GetBoolDefault("MapUpdate.ProcessPackets", false);
+    m_configs[CONFIG_MOVEMENT_COALESCE_HEARTBEATS] = sConfig.GetBoolDefault("Movement.CoalesceHeartbeats", false);
+    m_configs[CONFIG_MOVEMENT_DECIMATION_DISTANCE] = sConfig.GetIntDefault("Movement.HeartbeatDecimation.Distance", 0);
+    m_configs[CONFIG_MOVEMENT_DECIMATION_RATE] = sConfig.GetIntDefault("Movement.HeartbeatDecimation.Rate", 2);
+    if (m_configs[CONFIG_MOVEMENT_DECIMATION_RATE] < 1)
+    {
+        sLog.outError("Movement.HeartbeatDecimation.Rate (%u) must be > 0. Using 1 instead.", m_configs[CONFIG_MOVEMENT_DECIMATION_RATE]);
+        m_configs[CONFIG_MOVEMENT_DECIMATION_RATE] = 1;
+    }
+    m_configs[CONFIG_GUID_MAP_BLOCK_SIZE] = sConfig.GetIntDefault("Guid.MapBlockSize", 64);
+    if (m_configs[CONFIG_GUID_MAP_BLOCK_SIZE] < 1)
+    {
+        sLog.outError("Guid.MapBlockSize (%u) must be > 0. Using 1 instead.", m_configs[CONFIG_GUID_MAP_BLOCK_SIZE]);
+        m_configs[CONFIG_GUID_MAP_BLOCK_SIZE] = 1;
+    }
+    m_configs[CONFIG_GUID_RECYCLE_DELAY] = sConfig.GetIntDefault("Guid.RecycleDelay", 600);
     m_configs[CONFIG_DUEL_MOD] = sConfig.GetBoolDefault("DuelMod.Enable", false);
     m_configs[CONFIG_DUEL_CD_RESET] = sConfig.GetBoolDefault("DuelMod.Cooldowns", false);
     m_configs[CONFIG_AUTOBROADCAST_TIMER] = sConfig.GetIntDefault("AutoBroadcast.Timer", 60000);
@@ -1097,6 +1119,10 @@ void World::LoadConfigSettings(bool reload)
 
     // mmaps
     m_configs[CONFIG_BOOL_MMAP_ENABLED] = sConfig.GetBoolDefault("mmap.enable", true);
+    m_configs[CONFIG_MMAP_PATH_CACHE_TIME] = sConfig.GetIntDefault("mmap.pathCacheTime", 500);
+    m_configs[CONFIG_MMAP_TICK_POLY_BUDGET] = sConfig.GetIntDefault("mmap.tickPolyBudget", 0);
+    m_configs[CONFIG_MMAP_PATH_THREADS] = sConfig.GetIntDefault("mmap.pathThreads", 0);
+    m_configs[CONFIG_TERRAIN_CACHE_SIZE] = sConfig.GetIntDefault("Terrain.CacheSize", 4096);
     std::string ignoreMMapIds = sConfig.GetStringDefault("mmap.ignoreMapIds", "");
     MMAP::MMapFactory::preventPathfindingOnMaps(ignoreMMapIds.c_str());
     sLog.outString("WORLD: MMap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
@@ -1307,6 +1333,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading spell extra attributes...");
     spellmgr.LoadSpellCustomAttr();
 
+    sLog.outString("Compiling aura proc flags...");
+    spellmgr.LoadAuraProcFlags();
+
     sLog.outString("Loading linked spells...");
     spellmgr.LoadSpellLinked();
 
@@ -1646,6 +1675,8 @@ void World::LoadAutobroadcasts()
 // Update the World !
 void World::Update(time_t diff)
 {
+    PROFILE_ZONE("World::Update");
+
     m_updateTime = uint32(diff);
     if (m_configs[CONFIG_INTERVAL_LOG_UPDATE])
     {
@@ -1715,6 +1746,9 @@ void World::Update(time_t diff)
     UpdateSessions(diff);
     RecordTimeDiff("UpdateSessions");
 
+    // Refresh the online player snapshot used by /who
+    sWhoListMgr.Update(uint32(diff));
+
     // Handle weather updates when the timer has passed
     if (m_timers[WUPDATE_WEATHERS].Passed())
     {
@@ -1788,6 +1822,9 @@ void World::Update(time_t diff)
     UpdateResultQueue();
     RecordTimeDiff("UpdateResultQueue");
 
+    // send buffered guild/arena team/group writes to the character database
+    CharacterDatabaseWriter.Update(uint32(diff));
+
     // Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
     {
@@ -2254,6 +2291,8 @@ void World::SendServerMessage(ServerMessageType type, const char *text, Player*
 
 void World::UpdateSessions(time_t diff)
 {
+    PROFILE_ZONE("World::UpdateSessions");
+
     // Add new sessions
     WorldSession* sess;
     while (addSessQueue.next(sess))
@@ -2269,7 +2308,8 @@ void World::UpdateSessions(time_t diff)
       //    continue;
 
         // and remove not active sessions from the list
-        if (!itr->second->Update(diff))                      // As interval = 0
+        WorldSessionFilter updater(itr->second);
+        if (!itr->second->Update(diff, updater))             // As interval = 0
         {
             if (!RemoveQueuedPlayer(itr->second) && itr->second && getConfig(CONFIG_INTERVAL_DISCONNECT_TOLERANCE))
                 m_disconnects[itr->second->GetAccountId()] = time(NULL);
@@ -2343,6 +2383,7 @@ void World::InitResultQueue()
 
 void World::UpdateResultQueue()
 {
+    PROFILE_ZONE("World::UpdateResultQueue");
     m_resultQueue->Update();
 }
 
@@ -76,6 +76,7 @@ enum WorldConfigs
     CONFIG_INTERVAL_MAPUPDATE,
     CONFIG_INTERVAL_CHANGEWEATHER,
     CONFIG_INTERVAL_DISCONNECT_TOLERANCE,
+    CONFIG_INTERVAL_CHARDB_WRITEBEHIND,
     CONFIG_PORT_WORLD,
     CONFIG_SOCKET_SELECTTIME,
     CONFIG_SOCKET_TIMEOUTTIME,
@@ -200,6 +201,8 @@ enum WorldConfigs
     CONFIG_ARENA_AUTO_DISTRIBUTE_INTERVAL_DAYS,
     CONFIG_ARENA_LOG_EXTENDED_INFO,
     CONFIG_MAX_WHO,
+    CONFIG_WHO_LIST_UPDATE_INTERVAL,
+    CONFIG_WHO_LIST_MAX_QUERIES,
     CONFIG_BG_START_MUSIC,
     CONFIG_START_ALL_SPELLS,
     CONFIG_HONOR_AFTER_DUEL,
@@ -219,6 +222,12 @@ enum WorldConfigs
     CONFIG_PET_LOS,
     CONFIG_VMAP_TOTEM,
     CONFIG_NUMTHREADS,
+    CONFIG_MAP_PACKET_PROCESSING,
+    CONFIG_MOVEMENT_COALESCE_HEARTBEATS,
+    CONFIG_MOVEMENT_DECIMATION_DISTANCE,
+    CONFIG_MOVEMENT_DECIMATION_RATE,
+    CONFIG_GUID_MAP_BLOCK_SIZE,
+    CONFIG_GUID_RECYCLE_DELAY,
     CONFIG_CHATLOG_CHANNEL,
     CONFIG_CHATLOG_WHISPER,
     CONFIG_CHATLOG_SYSCHAN,
@@ -240,6 +249,10 @@ enum WorldConfigs
     CONFIG_AUTOBROADCAST_ENABLED,
     CONFIG_AUTOBROADCAST_CENTER,
     CONFIG_BOOL_MMAP_ENABLED,
+    CONFIG_MMAP_PATH_CACHE_TIME,
+    CONFIG_MMAP_TICK_POLY_BUDGET,
+    CONFIG_MMAP_PATH_THREADS,
+    CONFIG_TERRAIN_CACHE_SIZE,
     CONFIG_VALUE_COUNT
 };
 
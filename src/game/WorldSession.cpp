@@ -22,6 +22,7 @@
 #include "Chat.h"
 #include "SocialMgr.h"
 #include "ScriptMgr.h"
+#include "TickProfiler.h"
 
 // WorldSession constructor
 WorldSession::WorldSession(uint32 id, WorldSocket *sock, uint32 sec, uint8 expansion, time_t mute_time, LocaleConstant locale) :
@@ -29,7 +30,7 @@ LookingForGroup_auto_join(false), LookingForGroup_auto_add(false), m_muteTime(mu
 _player(NULL), m_Socket(sock),_security(sec), _accountId(id), m_expansion(expansion),
 m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(objmgr.GetIndexForLocale(locale)),
 _logoutTime(0), m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
-m_latency(0), m_timeOutTime(0)
+m_latency(0), m_timeOutTime(0), m_whoQueryWindowEnd(0), m_whoQueryCount(0)
 {
     if (sock)
     {
@@ -147,20 +148,50 @@ void WorldSession::LogUnprocessedTail(WorldPacket* packet)
 }
 
 // Update the WorldSession (triggered by World update)
-bool WorldSession::Update(uint32 diff)
+bool MapSessionFilter::Process(WorldPacket* packet)
 {
-    /// Update Timeout timer.
-    UpdateTimeOutTime(diff);
+    if (packet->GetOpcode() >= NUM_MSG_TYPES)
+        return false;
 
-    ///- Before we process anything:
-    /// If necessary, kick the player from the character select screen
-    if (IsConnectionIdle())
-        m_Socket->CloseSocket();
+    // a player not in world has no map pass, its packets are handled by the world thread
+    Player* player = m_pSession->GetPlayer();
+    if (!player || !player->IsInWorld())
+        return false;
+
+    return opcodeTable[packet->GetOpcode()].processing == PROCESS_THREADSAFE;
+}
+
+bool WorldSessionFilter::Process(WorldPacket* packet)
+{
+    if (!sWorld.getConfig(CONFIG_MAP_PACKET_PROCESSING) || packet->GetOpcode() >= NUM_MSG_TYPES)
+        return true;
+
+    Player* player = m_pSession->GetPlayer();
+    if (!player || !player->IsInWorld())
+        return true;
+
+    return opcodeTable[packet->GetOpcode()].processing == PROCESS_THREADUNSAFE;
+}
+
+bool WorldSession::Update(uint32 diff, PacketFilter& updater)
+{
+    PROFILE_ZONE("WorldSession::Update");
+
+    if (updater.ProcessLogout())
+    {
+        /// Update Timeout timer.
+        UpdateTimeOutTime(diff);
+
+        ///- Before we process anything:
+        /// If necessary, kick the player from the character select screen
+        if (IsConnectionIdle())
+            m_Socket->CloseSocket();
+    }
 
     // Retrieve packets from the receive queue and call the appropriate handlers
     // not process packets if socket already closed
     WorldPacket* packet;
-    while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet))
+    while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet, updater))
     {
         /*#if 1
         sLog.outError("MOEP: %s (0x%.4X)",
@@ -234,7 +265,11 @@ bool WorldSession::Update(uint32 diff)
 
         delete packet;
     }
-    
+
+    // the map pass leaves the session state to the world thread
+    if (!updater.ProcessLogout())
+        return true;
+
     ///- If necessary, log the player out
     time_t currTime = time(NULL);
     if (ShouldLogOut(currTime) && !m_playerLoading)
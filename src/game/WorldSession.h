@@ -48,6 +48,44 @@ enum PartyResult
     PARTY_RESULT_INVITE_RESTRICTED    = 13
 };
 
+class WorldSession;
+
+// Decides which received packets a WorldSession::Update pass handles.
+// Packets are handled in arrival order, a pass stops at the first packet
+// its filter rejects and leaves it to the other pass.
+class PacketFilter
+{
+    public:
+        explicit PacketFilter(WorldSession* pSession) : m_pSession(pSession) {}
+        virtual ~PacketFilter() {}
+
+        virtual bool Process(WorldPacket* /*packet*/) { return true; }
+        // only the world thread pass may time out, log out or drop the session
+        virtual bool ProcessLogout() const { return true; }
+
+    protected:
+        WorldSession* const m_pSession;
+};
+
+// Pass run by the player's map update, handles PROCESS_THREADSAFE packets
+class MapSessionFilter : public PacketFilter
+{
+    public:
+        explicit MapSessionFilter(WorldSession* pSession) : PacketFilter(pSession) {}
+
+        virtual bool Process(WorldPacket* packet);
+        virtual bool ProcessLogout() const { return false; }
+};
+
+// Pass run by World::UpdateSessions, handles everything the map pass does not
+class WorldSessionFilter : public PacketFilter
+{
+    public:
+        explicit WorldSessionFilter(WorldSession* pSession) : PacketFilter(pSession) {}
+
+        virtual bool Process(WorldPacket* packet);
+};
+
 // Player session in the World
 class WorldSession
 {
@@ -102,7 +140,7 @@ class WorldSession
         void KickPlayer();
 
         void QueuePacket(WorldPacket* new_packet);
-        bool Update(uint32 diff);
+        bool Update(uint32 diff, PacketFilter& updater);
 
         // Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
@@ -189,6 +227,11 @@ class WorldSession
         uint32 getDialogStatus(Player* pPlayer, Object* questgiver, uint32 defstatus);
 
         time_t m_timeOutTime;
+
+        // /who rate accounting, see WhoListMgr::RegisterQuery
+        time_t m_whoQueryWindowEnd;
+        uint32 m_whoQueryCount;
+
         void UpdateTimeOutTime(uint32 diff)
         {
             if (diff > m_timeOutTime)
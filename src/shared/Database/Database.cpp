@@ -30,7 +30,7 @@
 
 size_t Database::db_count = 0;
 
-Database::Database() : mMysql(NULL)
+Database::Database() : m_threadBody(NULL), m_delayThread(NULL), mMysql(NULL), m_nextHolderConnection(0)
 {
     // before first connection
     if (db_count++ == 0)
@@ -634,5 +634,46 @@ void Database::HaltDelayThread()
     delete m_delayThread;                                   //This also deletes m_threadBody
     m_delayThread = NULL;
     m_threadBody = NULL;
+
+    // holders still queued above were dispatched to the holder connections, let them finish
+    for (size_t i = 0; i < m_holderConnections.size(); ++i)
+        delete m_holderConnections[i];
+    m_holderConnections.clear();
+}
+
+void Database::WaitDelayQueue()
+{
+    if (!m_threadBody)
+        return;
+
+    ACE_Manual_Event event;
+    if (m_threadBody->Delay(new SqlSyncPoint(event)))
+        event.wait();
+}
+
+bool Database::InitHolderConnections(const char *infoString, uint32 count)
+{
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Database* db = new Database;
+        if (!db->Initialize(infoString))
+        {
+            delete db;
+            return false;
+        }
+        m_holderConnections.push_back(db);
+    }
+
+    return true;
+}
+
+SqlDelayThread* Database::GetHolderThread()
+{
+    if (m_holderConnections.empty())
+        return NULL;
+
+    // round robin
+    uint32 idx = m_nextHolderConnection++ % m_holderConnections.size();
+    return m_holderConnections[idx]->m_threadBody;
 }
 
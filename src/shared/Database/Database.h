@@ -12,6 +12,7 @@
 #include "Policies/Singleton.h"
 #include "ace/Thread_Mutex.h"
 #include "ace/Guard_T.h"
+#include "ace/Atomic_Op.h"
 
 #ifdef WIN32
   #define FD_SETSIZE 1024
@@ -46,6 +47,11 @@ class Database
 
         void InitDelayThread();
         void HaltDelayThread();
+        // blocks until the operations queued on the delay thread so far are executed
+        void WaitDelayQueue();
+
+        // opens 'count' extra connections that execute query holders in parallel
+        bool InitHolderConnections(const char *infoString, uint32 count);
 
         QueryResult_AutoPtr Query(const char *sql);
         QueryResult_AutoPtr PQuery(const char *format,...) ATTR_PRINTF(2,3);
@@ -127,6 +133,11 @@ class Database
 
         static size_t db_count;
 
+        // extra connections (each with its own delay thread) used by DelayQueryHolder
+        std::vector<Database*> m_holderConnections;
+        ACE_Atomic_Op<ACE_Thread_Mutex, uint32> m_nextHolderConnection;
+        SqlDelayThread* GetHolderThread();
+
         bool _TransactionCmd(const char *sql);
         bool _Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD **pFields, uint64* pRowCount, uint32* pFieldCount);
 };
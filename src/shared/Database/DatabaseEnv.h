@@ -14,6 +14,7 @@
 #include "Database/QueryResult.h"
 
 #include "Database/Database.h"
+#include "Database/SqlWriteBehind.h"
 typedef Database DatabaseType;
 #define _LIKE_           "LIKE"
 #define _TABLE_SIM_      "`"
@@ -24,5 +25,7 @@ extern DatabaseType WorldDatabase;
 extern DatabaseType CharacterDatabase;
 extern DatabaseType LoginDatabase;
 
+extern SqlWriteBehind CharacterDatabaseWriter;
+
 #endif
 
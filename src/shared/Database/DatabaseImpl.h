@@ -176,7 +176,7 @@ bool
 Database::DelayQueryHolder(Class *object, void (Class::*method)(QueryResult_AutoPtr, SqlQueryHolder*), SqlQueryHolder *holder)
 {
     ASYNC_DELAYHOLDER_BODY(holder, itr)
-    return holder->Execute(new BlizzLike::QueryCallback<Class, SqlQueryHolder*>(object, method, QueryResult_AutoPtr(NULL), holder), m_threadBody, itr->second);
+    return holder->Execute(new BlizzLike::QueryCallback<Class, SqlQueryHolder*>(object, method, QueryResult_AutoPtr(NULL), holder), m_threadBody, itr->second, GetHolderThread());
 }
 
 template<class Class, typename ParamType1>
@@ -184,7 +184,7 @@ bool
 Database::DelayQueryHolder(Class *object, void (Class::*method)(QueryResult_AutoPtr, SqlQueryHolder*, ParamType1), SqlQueryHolder *holder, ParamType1 param1)
 {
     ASYNC_DELAYHOLDER_BODY(holder, itr)
-    return holder->Execute(new BlizzLike::QueryCallback<Class, SqlQueryHolder*, ParamType1>(object, method, QueryResult_AutoPtr(NULL), holder, param1), m_threadBody, itr->second);
+    return holder->Execute(new BlizzLike::QueryCallback<Class, SqlQueryHolder*, ParamType1>(object, method, QueryResult_AutoPtr(NULL), holder, param1), m_threadBody, itr->second, GetHolderThread());
 }
 
 #undef ASYNC_QUERY_BODY
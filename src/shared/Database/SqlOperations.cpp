@@ -78,7 +78,7 @@ void SqlResultQueue::Update()
     }
 }
 
-bool SqlQueryHolder::Execute(BlizzLike::IQueryCallback * callback, SqlDelayThread *thread, SqlResultQueue *queue)
+bool SqlQueryHolder::Execute(BlizzLike::IQueryCallback * callback, SqlDelayThread *thread, SqlResultQueue *queue, SqlDelayThread *target)
 {
     if (!callback || !thread || !queue)
         return false;
@@ -86,7 +86,10 @@ bool SqlQueryHolder::Execute(BlizzLike::IQueryCallback * callback, SqlDelayThrea
     // delay the execution of the queries, sync them with the delay thread
     // which will in turn resync on execution (via the queue) and call back
     SqlQueryHolderEx *holderEx = new SqlQueryHolderEx(this, callback, queue);
-    thread->Delay(holderEx);
+    if (target)
+        thread->Delay(new SqlQueryHolderDispatch(holderEx, target));
+    else
+        thread->Delay(holderEx);
     return true;
 }
 
@@ -193,3 +196,11 @@ void SqlQueryHolderEx::Execute(Database *db)
     m_queue->add(m_callback);
 }
 
+void SqlQueryHolderDispatch::Execute(Database *db)
+{
+    // the writes issued before the holder are committed now, the reads may run elsewhere
+    if (m_target->Delay(m_holderEx))
+        m_holderEx = NULL;
+    else
+        m_holderEx->Execute(db);
+}
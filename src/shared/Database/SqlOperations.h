@@ -10,6 +10,7 @@
 
 #include "ace/Thread_Mutex.h"
 #include "ace/Method_Request.h"
+#include "ace/Manual_Event.h"
 #include "LockedQueue.h"
 #include <queue>
 #include "Utilities/Callback.h"
@@ -58,6 +59,16 @@ class SqlTransaction : public SqlOperation
         void Execute(Database *db);
 };
 
+// signals the waiter once the operations queued before it are executed
+class SqlSyncPoint : public SqlOperation
+{
+    private:
+        ACE_Manual_Event& m_event;
+    public:
+        SqlSyncPoint(ACE_Manual_Event& event) : m_event(event) {}
+        void Execute(Database* /*db*/) { m_event.signal(); }
+};
+
 // ASYNC QUERIES
 
 class SqlQuery;                                             // contains a single async query
@@ -100,7 +111,8 @@ class SqlQueryHolder
         void SetSize(size_t size);
         QueryResult_AutoPtr GetResult(size_t index);
         void SetResult(size_t index, QueryResult_AutoPtr result);
-        bool Execute(BlizzLike::IQueryCallback * callback, SqlDelayThread *thread, SqlResultQueue *queue);
+        // if 'target' is set the queries run there, after everything queued on 'thread' before them
+        bool Execute(BlizzLike::IQueryCallback * callback, SqlDelayThread *thread, SqlResultQueue *queue, SqlDelayThread *target = NULL);
 };
 
 class SqlQueryHolderEx : public SqlOperation
@@ -115,6 +127,19 @@ class SqlQueryHolderEx : public SqlOperation
         void Execute(Database *db);
 };
 
+// passes a holder on to another delay thread once the statements queued before it are done
+class SqlQueryHolderDispatch : public SqlOperation
+{
+    private:
+        SqlQueryHolderEx * m_holderEx;
+        SqlDelayThread * m_target;
+    public:
+        SqlQueryHolderDispatch(SqlQueryHolderEx *holderEx, SqlDelayThread *target)
+            : m_holderEx(holderEx), m_target(target) {}
+        ~SqlQueryHolderDispatch() { delete m_holderEx; }
+        void Execute(Database *db);
+};
+
 class SqlAsyncTask : public ACE_Method_Request
 {
 public:
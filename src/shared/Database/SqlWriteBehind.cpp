@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#include "Database/SqlWriteBehind.h"
+#include "DatabaseEnv.h"
+#include "Timer.h"
+#include "ace/Guard_T.h"
+
+SqlWriteBehind::SqlWriteBehind(Database& db) : m_db(db), m_pendingCount(0),
+    m_flushInterval(1000), m_flushTimer(0), m_queuedCount(0), m_coalescedCount(0),
+    m_flushCount(0), m_lastFlushLatency(0), m_maxFlushLatency(0)
+{
+}
+
+SqlWriteBehind::~SqlWriteBehind()
+{
+    if (m_pendingCount)
+        sLog.outError("SqlWriteBehind: %u statements were never flushed", m_pendingCount);
+}
+
+bool SqlWriteBehind::Execute(const char* sql)
+{
+    if (!sql)
+        return false;
+
+    Push("", 0, sql);
+    return true;
+}
+
+bool SqlWriteBehind::PExecute(const char* format, ...)
+{
+    if (!format)
+        return false;
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res==-1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s",format);
+        return false;
+    }
+
+    return Execute(szQuery);
+}
+
+bool SqlWriteBehind::ExecuteKeyed(const char* tag, uint64 rowId, const char* sql)
+{
+    if (!tag || !sql)
+        return false;
+
+    Push(tag, rowId, sql);
+    return true;
+}
+
+bool SqlWriteBehind::PExecuteKeyed(const char* tag, uint64 rowId, const char* format, ...)
+{
+    if (!format)
+        return false;
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res==-1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s",format);
+        return false;
+    }
+
+    return ExecuteKeyed(tag, rowId, szQuery);
+}
+
+void SqlWriteBehind::Push(const char* tag, uint64 rowId, const char* sql)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    Entry entry;
+    entry.key = Key(tag, rowId);
+    entry.sql = sql;
+    entry.queueTime = getMSTime();
+
+    if (!m_transactions.empty())
+    {
+        TransactionMap::iterator trans = m_transactions.find(ACE_Based::Thread::current());
+        if (trans != m_transactions.end())
+        {
+            trans->second.push_back(entry);
+            return;
+        }
+    }
+
+    Append(entry);
+}
+
+void SqlWriteBehind::Append(Entry& entry)
+{
+    bool keyed = !entry.key.first.empty();
+    if (keyed)
+    {
+        KeyIndex::iterator itr = m_keyIndex.find(entry.key);
+        if (itr != m_keyIndex.end())
+        {
+            // keep the age of the first write, latency is measured from it
+            entry.queueTime = itr->second->queueTime;
+            m_entries.erase(itr->second);
+            m_keyIndex.erase(itr);
+            --m_pendingCount;
+            ++m_coalescedCount;
+        }
+    }
+
+    m_entries.push_back(entry);
+    if (keyed)
+        m_keyIndex[entry.key] = --m_entries.end();
+
+    ++m_pendingCount;
+    ++m_queuedCount;
+}
+
+void SqlWriteBehind::BeginTransaction()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    m_transactions[ACE_Based::Thread::current()];
+}
+
+void SqlWriteBehind::CommitTransaction()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    TransactionMap::iterator trans = m_transactions.find(ACE_Based::Thread::current());
+    if (trans == m_transactions.end())
+        return;
+
+    EntryList entries;
+    entries.swap(trans->second);
+    m_transactions.erase(trans);
+
+    for (EntryList::iterator itr = entries.begin(); itr != entries.end(); ++itr)
+        Append(*itr);
+}
+
+uint32 SqlWriteBehind::Take(EntryList& entries)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    if (m_entries.empty())
+        return 0;
+
+    uint32 now = getMSTime();
+    uint32 latency = 0;
+    for (EntryList::const_iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr)
+    {
+        uint32 age = getMSTimeDiff(itr->queueTime, now);
+        if (age > latency)
+            latency = age;
+    }
+
+    entries.swap(m_entries);
+    m_keyIndex.clear();
+    m_pendingCount = 0;
+
+    ++m_flushCount;
+    m_lastFlushLatency = latency;
+    if (latency > m_maxFlushLatency)
+        m_maxFlushLatency = latency;
+
+    return latency;
+}
+
+void SqlWriteBehind::Update(uint32 diff)
+{
+    m_flushTimer += diff;
+    if (m_flushTimer < m_flushInterval)
+        return;
+
+    m_flushTimer = 0;
+    Flush();
+}
+
+void SqlWriteBehind::Flush()
+{
+    EntryList entries;
+    uint32 latency = Take(entries);
+    if (entries.empty())
+        return;
+
+    m_db.BeginTransaction();
+    for (EntryList::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
+    {
+        m_db.Execute(itr->sql.c_str());
+    }
+    m_db.CommitTransaction();
+
+    DEBUG_LOG("SqlWriteBehind: flushed %u statements, oldest waited %u ms (%u coalesced so far)", uint32(entries.size()), latency, m_coalescedCount);
+}
+
+void SqlWriteBehind::FlushAndWait()
+{
+    // same queue as Flush, so statements issued earlier are never applied after it
+    Flush();
+    m_db.WaitDelayQueue();
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2013  BlizzLikeGroup
+ * BlizzLikeCore integrates as part of this file: CREDITS.md and LICENSE.md
+ */
+
+#ifndef __SQLWRITEBEHIND_H
+#define __SQLWRITEBEHIND_H
+
+#include "Common.h"
+#include "Threading.h"
+#include "ace/Thread_Mutex.h"
+
+#include <list>
+#include <map>
+
+class Database;
+
+// Write-behind buffer in front of a Database.
+//
+// Statements are kept in issue order and sent to the delay thread as one
+// transaction per flush window. A keyed statement supersedes the pending
+// statement with the same key: the old one is dropped and the new one is
+// queued at the end. A key is a tag naming the table and columns written
+// ("guild.motd") plus the row id. Keys must only be used for absolute
+// writes (SET motd = '...', REPLACE of a slot), never for relative ones
+// (SET money = money + 10) - those go through Execute.
+//
+// Statements that must be applied together are issued between
+// BeginTransaction and CommitTransaction. They are queued at once on commit,
+// so a flush never splits them. Writes that belong in a transaction of the
+// Database itself, next to other tables, must not go through here.
+class SqlWriteBehind
+{
+    public:
+        explicit SqlWriteBehind(Database& db);
+        ~SqlWriteBehind();
+
+        // ordered statement, never coalesced
+        bool Execute(const char* sql);
+        bool PExecute(const char* format, ...) ATTR_PRINTF(2,3);
+
+        // coalesced statement, replaces a pending one with the same tag and row id
+        bool ExecuteKeyed(const char* tag, uint64 rowId, const char* sql);
+        bool PExecuteKeyed(const char* tag, uint64 rowId, const char* format, ...) ATTR_PRINTF(4,5);
+
+        // statements of the calling thread until the commit are queued as one unit
+        void BeginTransaction();
+        void CommitTransaction();
+
+        // flushes when the window has passed, call from the owning thread's update loop
+        void Update(uint32 diff);
+
+        // sends everything pending to the delay thread as one transaction
+        void Flush();
+        // flushes and blocks until the delay thread has executed it, for callers
+        // that read the written rows back or halt the delay thread afterwards
+        void FlushAndWait();
+
+        void SetFlushInterval(uint32 interval) { m_flushInterval = interval; }
+        uint32 GetPendingCount() const { return m_pendingCount; }
+
+        // statistics
+        uint32 GetQueuedCount() const { return m_queuedCount; }
+        uint32 GetCoalescedCount() const { return m_coalescedCount; }
+        uint32 GetFlushCount() const { return m_flushCount; }
+        uint32 GetLastFlushLatency() const { return m_lastFlushLatency; }
+        uint32 GetMaxFlushLatency() const { return m_maxFlushLatency; }
+
+    private:
+        typedef std::pair<std::string, uint64> Key;
+
+        struct Entry
+        {
+            Key key;                                        // empty tag for ordered statements
+            std::string sql;
+            uint32 queueTime;
+        };
+
+        typedef std::list<Entry> EntryList;
+        typedef std::map<Key, EntryList::iterator> KeyIndex;
+        typedef std::map<ACE_Based::Thread*, EntryList> TransactionMap;
+
+        void Push(const char* tag, uint64 rowId, const char* sql);
+        // queues an entry, called with m_lock held
+        void Append(Entry& entry);
+        // moves the pending entries out under lock, returns latency of the oldest one
+        uint32 Take(EntryList& entries);
+
+        Database& m_db;
+        EntryList m_entries;
+        KeyIndex m_keyIndex;
+        TransactionMap m_transactions;                      // open transactions by thread
+        uint32 m_pendingCount;
+        ACE_Thread_Mutex m_lock;
+
+        uint32 m_flushInterval;
+        uint32 m_flushTimer;
+
+        uint32 m_queuedCount;
+        uint32 m_coalescedCount;
+        uint32 m_flushCount;
+        uint32 m_lastFlushLatency;
+        uint32 m_maxFlushLatency;
+};
+#endif                                                      //__SQLWRITEBEHIND_H
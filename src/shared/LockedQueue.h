@@ -69,6 +69,24 @@ namespace ACE_Based
                 return true;
             }
 
+            // Gets the next result in the queue if the checker accepts it, the item stays queued otherwise.
+            template<class Checker>
+            bool next(T& result, Checker& check)
+            {
+                ACE_GUARD_RETURN (LockType, g, this->_lock, false);
+
+                if (_queue.empty())
+                    return false;
+
+                result = _queue.front();
+                if (!check.Process(result))
+                    return false;
+
+                _queue.pop_front();
+
+                return true;
+            }
+
             // Peeks at the top of the queue. Remember to unlock after use.
             T& peek()
             {
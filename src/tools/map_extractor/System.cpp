@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <deque>
 #include <set>
+#include <vector>
 #include <cstdlib>
 
 #ifdef WIN32
@@ -23,6 +24,10 @@
 #include "loadlib/wdt.h"
 #include <fcntl.h>
 
+#include <ace/Guard_T.h>
+#include <ace/OS_NS_sys_time.h>
+#include <ace/Task.h>
+
 #if defined( __GNUC__ )
     #define _open   open
     #define _close close
@@ -76,6 +81,9 @@ float CONF_float_to_int16_limit = 2048.0f;   // Max accuracy = val/65536
 float CONF_flat_height_delta_limit = 0.005f; // If max - min less this value - surface is flat
 float CONF_flat_liquid_delta_limit = 0.001f; // If max - min less this value - liquid surface is flat
 
+// Number of threads converting map tiles
+int   CONF_threads = 1;
+
 // List MPQ for extract from
 char *CONF_mpq_list[]={
     "common.MPQ",
@@ -122,6 +130,7 @@ void Usage(char* prg)
         "-o set output path\n"\
         "-e extract only MAP(1)/DBC(2) - standard: both(3)\n"\
         "-f height stored as int (less map size but lost some accuracy) 1 by default\n"\
+        "-t number of threads converting map tiles - 1 by default\n"\
         "Example: %s -f 0 -i \"c:\\games\\game\"", prg, prg);
     exit(1);
 }
@@ -135,6 +144,7 @@ void HandleArgs(int argc, char * arg[])
         // e - extract only MAP(1)/DBC(2) - standard both(3)
         // f - use float to int conversion
         // h - limit minimum height
+        // t - number of threads
         if (arg[c][0] != '-')
             Usage(arg[0]);
 
@@ -168,6 +178,16 @@ void HandleArgs(int argc, char * arg[])
                 else
                     Usage(arg[0]);
                 break;
+            case 't':
+                if (c + 1 < argc)                            // all ok
+                {
+                    CONF_threads=atoi(arg[(c++) + 1]);
+                    if (CONF_threads < 1)
+                        Usage(arg[0]);
+                }
+                else
+                    Usage(arg[0]);
+                break;
         }
     }
 }
@@ -357,22 +377,38 @@ float selectUInt16StepStore(float maxDiff)
 {
     return 65535 / maxDiff;
 }
-// Temporary grid data store
-uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+// Temporary grid data store, one per converting thread
+struct ADTGridData
+{
+    uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+
+    float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+    float V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+    uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+    uint16 uint16_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+    uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+    uint8  uint8_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+
+    uint8 liquid_type[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+    bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
+    float liquid_height[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+};
 
-float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint16 uint16_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint8  uint8_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+bool ConvertADT(char *filename, char *filename2, int cell_y, int cell_x, uint32 build, ADTGridData& grid)
+{
+    uint16 (&area_flags)[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID] = grid.area_flags;
 
-uint8 liquid_type[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float liquid_height[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+    float (&V8)[ADT_GRID_SIZE][ADT_GRID_SIZE] = grid.V8;
+    float (&V9)[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1] = grid.V9;
+    uint16 (&uint16_V8)[ADT_GRID_SIZE][ADT_GRID_SIZE] = grid.uint16_V8;
+    uint16 (&uint16_V9)[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1] = grid.uint16_V9;
+    uint8 (&uint8_V8)[ADT_GRID_SIZE][ADT_GRID_SIZE] = grid.uint8_V8;
+    uint8 (&uint8_V9)[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1] = grid.uint8_V9;
+
+    uint8 (&liquid_type)[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID] = grid.liquid_type;
+    bool (&liquid_show)[ADT_GRID_SIZE][ADT_GRID_SIZE] = grid.liquid_show;
+    float (&liquid_height)[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1] = grid.liquid_height;
 
-bool ConvertADT(char *filename, char *filename2, int cell_y, int cell_x, uint32 build)
-{
     ADT_file adt;
 
     if (!adt.loadFile(filename))
@@ -387,6 +423,9 @@ bool ConvertADT(char *filename, char *filename2, int cell_y, int cell_x, uint32
 
     memset(liquid_show, 0, sizeof(liquid_show));
     memset(liquid_type, 0, sizeof(liquid_type));
+    // the liquid map is written one row and column past the shown cells,
+    // don't let those depend on the tile converted before by this thread
+    memset(liquid_height, 0, sizeof(liquid_height));
 
     // Prepare map header
     map_fileheader map;
@@ -903,10 +942,82 @@ bool ConvertADT(char *filename, char *filename2, int cell_y, int cell_x, uint32
     return true;
 }
 
+struct ADTJob
+{
+    uint32 map;                                             // index in map_ids
+    uint32 x, y;
+};
+
+// Converts the queued tiles on CONF_threads threads. Every tile goes to
+// its own file, so the output does not depend on the order they finish in.
+class ADTConverter : public ACE_Task_Base
+{
+    public:
+        ADTConverter(std::vector<ADTJob> const& jobs, uint32 build) :
+            m_jobs(jobs), m_build(build), m_next(0), m_done(0) {}
+
+        void Run()
+        {
+            m_start = ACE_OS::gettimeofday();
+
+            if (CONF_threads > 1)
+            {
+                activate(THR_NEW_LWP | THR_JOINABLE, CONF_threads);
+                wait();
+            }
+            else
+                svc();
+
+            float seconds = (ACE_OS::gettimeofday() - m_start).msec() / 1000.0f;
+            printf("\nConverted %u tiles in %.1f s (%.1f tiles/s)\n", uint32(m_jobs.size()), seconds,
+                seconds > 0.0f ? m_jobs.size() / seconds : 0.0f);
+        }
+
+        int svc()
+        {
+            char mpq_filename[1024];
+            char output_filename[1024];
+            ADTGridData* grid = new ADTGridData;
+
+            for (;;)
+            {
+                size_t index;
+                {
+                    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+                    if (m_next >= m_jobs.size())
+                        break;
+                    index = m_next++;
+                }
+
+                ADTJob const& job = m_jobs[index];
+                map_id const& map = map_ids[job.map];
+                sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", map.name, map.name, job.x, job.y);
+                sprintf(output_filename, "%s/maps/%03u%02u%02u.map", output_path, map.id, job.y, job.x);
+                ConvertADT(mpq_filename, output_filename, job.y, job.x, m_build, *grid);
+
+                ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+                ++m_done;
+                float seconds = (ACE_OS::gettimeofday() - m_start).msec() / 1000.0f;
+                printf("Processing........................%u/%u (%.1f tiles/s)\r", m_done, uint32(m_jobs.size()),
+                    seconds > 0.0f ? m_done / seconds : 0.0f);
+            }
+
+            delete grid;
+            return 0;
+        }
+
+    private:
+        std::vector<ADTJob> const& m_jobs;
+        uint32 m_build;
+
+        ACE_Thread_Mutex m_lock;
+        size_t m_next;
+        uint32 m_done;
+        ACE_Time_Value m_start;
+};
+
 void ExtractMapsFromMpq(uint32 build)
 {
-    char mpq_filename[1024];
-    char output_filename[1024];
     char mpq_map_name[1024];
 
     printf("Extracting maps...\n");
@@ -920,7 +1031,7 @@ void ExtractMapsFromMpq(uint32 build)
     path += "/maps/";
     CreateDir(path);
 
-    printf("Convert map files\n");
+    std::vector<ADTJob> jobs;
     for (uint32 z = 0; z < map_count; ++z)
     {
         printf("Extract %s (%d/%d)                  \n", map_ids[z].name, z+1, map_count);
@@ -939,14 +1050,20 @@ void ExtractMapsFromMpq(uint32 build)
             {
                 if (!wdt.main->adt_list[y][x].exist)
                     continue;
-                sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y);
-                sprintf(output_filename, "%s/maps/%03u%02u%02u.map", output_path, map_ids[z].id, y, x);
-                ConvertADT(mpq_filename, output_filename, y, x, build);
+
+                ADTJob job;
+                job.map = z;
+                job.x = x;
+                job.y = y;
+                jobs.push_back(job);
             }
-            // draw progress bar
-            printf("Processing........................%d%%\r", (100 * (y+1)) / WDT_MAP_SIZE);
         }
     }
+
+    printf("Convert map files (%u threads)\n", CONF_threads);
+    ADTConverter converter(jobs, build);
+    converter.Run();
+
     delete[] areas;
     delete[] map_ids;
 }
@@ -12,13 +12,19 @@
 #include "DetourNavMeshBuilder.h"
 #include "DetourCommon.h"
 
+#include "Timer.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Task.h>
+
 using namespace VMAP;
 
 namespace MMAP
 {
     MapBuilder::MapBuilder(float maxWalkableAngle, bool skipLiquid,
                            bool skipContinents, bool skipJunkMaps, bool skipBattlegrounds,
-                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath) :
+                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath,
+                           int threads) :
                            m_terrainBuilder(NULL),
                            m_debugOutput        (debugOutput),
                            m_skipContinents     (skipContinents),
@@ -26,6 +32,7 @@ namespace MMAP
                            m_skipBattlegrounds  (skipBattlegrounds),
                            m_maxWalkableAngle   (maxWalkableAngle),
                            m_bigBaseUnit        (bigBaseUnit),
+                           m_threads            (threads),
                            m_rcContext          (NULL),
                            m_offMeshFilePath    (offMeshFilePath)
     {
@@ -36,6 +43,64 @@ namespace MMAP
         discoverTiles();
     }
 
+    // Builds the tiles of one map on the threads of the builder. Every tile
+    // is written to its own file and checked on a navmesh of its own, so the
+    // output does not depend on the order the tiles are built in.
+    class TileBuilderJobs : public ACE_Task_Base
+    {
+        public:
+            TileBuilderJobs(MapBuilder& builder, uint32 mapID, vector<uint32> const& tiles, dtNavMesh* navMesh) :
+                m_builder(builder), m_mapID(mapID), m_tiles(tiles), m_navMesh(navMesh), m_next(0) {}
+
+            void run(int threads)
+            {
+                uint32 startTime = getMSTime();
+
+                if (threads > 1 && m_tiles.size() > 1)
+                {
+                    activate(THR_NEW_LWP | THR_JOINABLE, threads);
+                    wait();
+                }
+                else
+                    svc();
+
+                float seconds = getMSTimeDiff(startTime, getMSTime()) / 1000.0f;
+                printf("Complete! %u tiles in %.1f s (%.1f tiles/s)          \n\n", uint32(m_tiles.size()), seconds,
+                       seconds > 0.0f ? m_tiles.size() / seconds : 0.0f);
+            }
+
+            int svc()
+            {
+                for (;;)
+                {
+                    size_t index;
+                    {
+                        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+                        if (m_next >= m_tiles.size())
+                            break;
+                        index = m_next++;
+                    }
+
+                    uint32 tileX, tileY;
+                    StaticMapTree::unpackTileID(m_tiles[index], tileX, tileY);
+
+                    printf("[%u/%u] Building map %03u, tile [%02u,%02u]\n", uint32(index + 1), uint32(m_tiles.size()),
+                           m_mapID, tileX, tileY);
+                    m_builder.buildTile(m_mapID, tileX, tileY, m_navMesh);
+                }
+                return 0;
+            }
+
+        private:
+            MapBuilder& m_builder;
+            uint32 m_mapID;
+            vector<uint32> const& m_tiles;
+            dtNavMesh* m_navMesh;
+
+            ACE_Thread_Mutex m_lock;
+            size_t m_next;
+    };
+
     /**************************************************************************/
     MapBuilder::~MapBuilder()
     {
@@ -188,6 +253,7 @@ namespace MMAP
             return;
         }
 
+        printf("Building map %03u, tile [%02u,%02u]\n", mapID, tileX, tileY);
         buildTile(mapID, tileX, tileY, navMesh);
         dtFreeNavMesh(navMesh);
     }
@@ -226,6 +292,7 @@ namespace MMAP
 
         // now start building mmtiles for each tile
         printf("We have %u tiles.                          \n", (unsigned int)tiles->size());
+        vector<uint32> buildTiles;
         for (set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
         {
             uint32 tileX, tileY;
@@ -236,19 +303,18 @@ namespace MMAP
             if (shouldSkipTile(mapID, tileX, tileY))
                 continue;
 
-            buildTile(mapID, tileX, tileY, navMesh);
+            buildTiles.push_back(*it);
         }
 
-        dtFreeNavMesh(navMesh);
+        TileBuilderJobs jobs(*this, mapID, buildTiles, navMesh);
+        jobs.run(m_threads);
 
-        printf("Complete!                               \n\n");
+        dtFreeNavMesh(navMesh);
     }
 
     /**************************************************************************/
     void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
     {
-        printf("Building map %03u, tile [%02u,%02u]\n", mapID, tileX, tileY);
-
         MeshData meshData;
 
         // get heightmap data
@@ -385,12 +451,12 @@ namespace MMAP
         // these are WORLD UNIT based metrics
         // this are basic unit dimentions
         // value have to divide GRID_SIZE(533.33333f) ( aka: 0.5333, 0.2666, 0.3333, 0.1333, etc )
-        const static float BASE_UNIT_DIM = m_bigBaseUnit ? 0.533333f : 0.266666f;
+        const float BASE_UNIT_DIM = m_bigBaseUnit ? 0.533333f : 0.266666f;
 
         // All are in UNIT metrics!
-        const static int VERTEX_PER_MAP = int(GRID_SIZE/BASE_UNIT_DIM + 0.5f);
-        const static int VERTEX_PER_TILE = m_bigBaseUnit ? 40 : 80; // must divide VERTEX_PER_MAP
-        const static int TILES_PER_MAP = VERTEX_PER_MAP/VERTEX_PER_TILE;
+        const int VERTEX_PER_MAP = int(GRID_SIZE/BASE_UNIT_DIM + 0.5f);
+        const int VERTEX_PER_TILE = m_bigBaseUnit ? 40 : 80; // must divide VERTEX_PER_MAP
+        const int TILES_PER_MAP = VERTEX_PER_MAP/VERTEX_PER_TILE;
 
         rcConfig config;
         memset(&config, 0, sizeof(rcConfig));
@@ -631,6 +697,11 @@ namespace MMAP
         unsigned char* navData = NULL;
         int navDataSize = 0;
 
+        // the tile is checked on a navmesh of its own, the map's one is shared
+        // by the threads and the links written with the tile depend on the
+        // tiles the navmesh held before
+        dtNavMesh* tileNavMesh = NULL;
+
         do
         {
             // these values are checked within dtCreateNavMeshData - handle them here
@@ -676,11 +747,18 @@ namespace MMAP
                 continue;
             }
 
+            tileNavMesh = dtAllocNavMesh();
+            if (!tileNavMesh || !tileNavMesh->init(navMesh->getParams()))
+            {
+                printf("%s Failed creating navmesh!                \n", tileString);
+                continue;
+            }
+
             dtTileRef tileRef = 0;
             printf("%s Adding tile to navmesh...                \r", tileString);
             // DT_TILE_FREE_DATA tells detour to unallocate memory when the tile
             // is removed via removeTile()
-            dtStatus dtResult = navMesh->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, &tileRef);
+            dtStatus dtResult = tileNavMesh->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, &tileRef);
             if (!tileRef || dtResult != DT_SUCCESS)
             {
                 printf("%s Failed adding tile to navmesh!           \n", tileString);
@@ -696,7 +774,7 @@ namespace MMAP
                 char message[1024];
                 sprintf(message, "Failed to open %s for writing!\n", fileName);
                 perror(message);
-                navMesh->removeTile(tileRef, NULL, NULL);
+                tileNavMesh->removeTile(tileRef, NULL, NULL);
                 continue;
             }
 
@@ -713,10 +791,12 @@ namespace MMAP
             fclose(file);
 
             // now that tile is written to disk, we can unload it
-            navMesh->removeTile(tileRef, NULL, NULL);
+            tileNavMesh->removeTile(tileRef, NULL, NULL);
         }
         while (0);
 
+        dtFreeNavMesh(tileNavMesh);
+
         if (m_debugOutput)
         {
             // restore padding so that the debug visualization is correct
@@ -54,7 +54,8 @@ namespace MMAP
                        bool skipBattlegrounds   = false,
                        bool debugOutput         = false,
                        bool bigBaseUnit         = false,
-                       const char* offMeshFilePath = NULL);
+                       const char* offMeshFilePath = NULL,
+                       int threads              = 1);
 
             ~MapBuilder();
 
@@ -68,6 +69,8 @@ namespace MMAP
             void buildAllMaps();
 
         private:
+            friend class TileBuilderJobs;
+
             // detect maps and tiles
             void discoverTiles();
             set<uint32>* getTileList(uint32 mapID);
@@ -107,7 +110,11 @@ namespace MMAP
             float m_maxWalkableAngle;
             bool m_bigBaseUnit;
 
+            // threads building the tiles of a map
+            int m_threads;
+
             // build performance - not really used for now
+            // logs and timers are disabled, so the threads can share it
             rcContext* m_rcContext;
     };
 }
@@ -27,7 +27,9 @@ namespace VMAP
     // declared in src/shared/vmap/VMapManager2.h
     void VMapManager2::getInstanceMapTree(InstanceTreeMap &instanceMapTree)
     {
-        instanceMapTree = iInstanceMapTrees;
+        instanceMapTree.clear();
+        for (ManagedMapTreeMap::iterator i = iInstanceMapTrees.begin(); i != iInstanceMapTrees.end(); ++i)
+            instanceMapTree[i->first] = i->second->tree;
     }
 
     // declared in src/shared/vmap/WorldModel.h
@@ -39,8 +41,8 @@ namespace VMAP
     // declared in src/shared/vmap/WorldModel.h
     void GroupModel::getMeshData(vector<Vector3> &vertices, vector<MeshTriangle> &triangles, WmoLiquid* &liquid)
     {
-        vertices = this->vertices;
-        triangles = this->triangles;
+        vertices.assign(iVertexData, iVertexData + iNVertices);
+        triangles.assign(iTriangleData, iTriangleData + iNTriangles);
         liquid = iLiquid;
     }
 
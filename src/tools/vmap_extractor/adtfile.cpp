@@ -53,7 +53,7 @@ ADTFile::ADTFile(char* filename): ADT(filename)
     Adtfilename.append(filename);
 }
 
-bool ADTFile::init(uint32 map_num, uint32 tileX, uint32 tileY)
+bool ADTFile::init(uint32 map_num, uint32 tileX, uint32 tileY, DirRecords* dirfile)
 {
     if (ADT.isEof ())
         return false;
@@ -75,15 +75,6 @@ bool ADTFile::init(uint32 map_num, uint32 tileX, uint32 tileY)
     //printf("xMap = %s\n", xMap.c_str());
     //printf("yMap = %s\n", yMap.c_str());
 
-    std::string dirname = std::string(szWorkDirWmo) + "/dir_bin";
-    FILE *dirfile;
-    dirfile = fopen(dirname.c_str(), "ab");
-    if (!dirfile)
-    {
-        printf("Can't open dirfile!'%s'\n", dirname.c_str());
-        return false;
-    }
-
     while (!ADT.isEof())
     {
         char fourcc[5];
@@ -132,15 +123,13 @@ bool ADTFile::init(uint32 map_num, uint32 tileX, uint32 tileY)
 
                     char szLocalFile[1024];
                     snprintf(szLocalFile, 1024, "%s/%s", szWorkDirWmo, s);
-                    FILE * output = fopen(szLocalFile,"rb");
-                    if (!output)
+                    if (ClaimExtraction(szLocalFile))
                     {
                         Model m2(path);
                         if (m2.open())
                             m2.ConvertToVMAPModel(szLocalFile);
+                        FinishExtraction(szLocalFile);
                     }
-                    else
-                        fclose(output);
                 }
                 delete[] buf;
             }
@@ -199,7 +188,6 @@ bool ADTFile::init(uint32 map_num, uint32 tileX, uint32 tileY)
         ADT.seek(nextpos);
     }
     ADT.close();
-    fclose(dirfile);
     return true;
 }
 
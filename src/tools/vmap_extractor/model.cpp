@@ -132,7 +132,7 @@ Vec3D fixCoordSystem2(Vec3D v)
     return Vec3D(v.x, v.z, v.y);
 }
 
-ModelInstance::ModelInstance(MPQFile &f,const char* ModelInstName, uint32 mapID, uint32 tileX, uint32 tileY, FILE *pDirfile)
+ModelInstance::ModelInstance(MPQFile &f,const char* ModelInstName, uint32 mapID, uint32 tileX, uint32 tileY, DirRecords* pDirfile)
 {
     float ff[3];
     f.read(&id, 4);
@@ -167,18 +167,18 @@ ModelInstance::ModelInstance(MPQFile &f,const char* ModelInstName, uint32 mapID,
     uint32 flags = MOD_M2;
     if (tileX == 65 && tileY == 65) flags |= MOD_WORLDSPAWN;
     //write mapID, tileX, tileY, Flags, ID, Pos, Rot, Scale, name
-    fwrite(&mapID, sizeof(uint32), 1, pDirfile);
-    fwrite(&tileX, sizeof(uint32), 1, pDirfile);
-    fwrite(&tileY, sizeof(uint32), 1, pDirfile);
-    fwrite(&flags, sizeof(uint32), 1, pDirfile);
-    fwrite(&adtId, sizeof(uint16), 1, pDirfile);
-    fwrite(&id, sizeof(uint32), 1, pDirfile);
-    fwrite(&pos, sizeof(float), 3, pDirfile);
-    fwrite(&rot, sizeof(float), 3, pDirfile);
-    fwrite(&sc, sizeof(float), 1, pDirfile);
+    pDirfile->write(&mapID, sizeof(uint32), 1);
+    pDirfile->write(&tileX, sizeof(uint32), 1);
+    pDirfile->write(&tileY, sizeof(uint32), 1);
+    pDirfile->write(&flags, sizeof(uint32), 1);
+    pDirfile->write(&adtId, sizeof(uint16), 1);
+    pDirfile->write(&id, sizeof(uint32), 1);
+    pDirfile->write(&pos, sizeof(float), 3);
+    pDirfile->write(&rot, sizeof(float), 3);
+    pDirfile->write(&sc, sizeof(float), 1);
     uint32 nlen=strlen(ModelInstName);
-    fwrite(&nlen, sizeof(uint32), 1, pDirfile);
-    fwrite(ModelInstName, sizeof(char), nlen, pDirfile);
+    pDirfile->write(&nlen, sizeof(uint32), 1);
+    pDirfile->write(ModelInstName, sizeof(char), nlen);
 
     /* int realx1 = (int) ((float) pos.x / 533.333333f);
     int realy1 = (int) ((float) pos.z / 533.333333f);
@@ -15,6 +15,7 @@
 class Model;
 class WMOInstance;
 class MPQFile;
+class DirRecords;
 
 Vec3D fixCoordSystem(Vec3D v);
 
@@ -51,7 +52,7 @@ public:
     float w,sc;
 
     ModelInstance() {}
-    ModelInstance(MPQFile &f,const char* ModelInstName, uint32 mapID, uint32 tileX, uint32 tileY, FILE *pDirfile);
+    ModelInstance(MPQFile &f,const char* ModelInstName, uint32 mapID, uint32 tileX, uint32 tileY, DirRecords* pDirfile);
 
 };
 
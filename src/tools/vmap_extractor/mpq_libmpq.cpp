@@ -4,6 +4,7 @@
  */
 
 #include "mpq_libmpq04.h"
+#include <ace/Guard_T.h>
 #include <deque>
 #include <cstdio>
 
@@ -53,6 +54,7 @@ MPQFile::MPQFile(const char* filename):
 {
     for (ArchiveSet::iterator i=gOpenArchives.begin(); i!=gOpenArchives.end();++i)
     {
+        ACE_Guard<ACE_Thread_Mutex> guard((*i)->lock);
         mpq_archive *mpq_a = (*i)->mpq_a;
 
         uint32 filenum;
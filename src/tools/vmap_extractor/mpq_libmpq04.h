@@ -17,6 +17,8 @@
 #include <iostream>
 #include <deque>
 
+#include <ace/Thread_Mutex.h>
+
 using namespace std;
 
 class MPQArchive
@@ -24,6 +26,7 @@ class MPQArchive
 
 public:
     mpq_archive_s *mpq_a;
+    ACE_Thread_Mutex lock;                                  // libmpq reads are not thread safe per archive
 
     MPQArchive(const char* filename);
     void close();
@@ -26,8 +26,15 @@
 //#pragma comment(lib, "Winmm.lib")
 
 #include <map>
+#include <set>
+
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Guard_T.h>
+#include <ace/OS_NS_sys_time.h>
+#include <ace/Task.h>
 
 //From Extractor
+#include "vmapexport.h"
 #include "adtfile.h"
 #include "wdtfile.h"
 #include "dbcfile.h"
@@ -55,6 +62,7 @@ char output_path[128]=".";
 char input_path[1024]=".";
 bool hasInputPathParam = false;
 bool preciseVectorData = false;
+int extractThreads = 1;
 
 // Constants
 
@@ -73,27 +81,207 @@ static const char * GetPlainName(const char * szFileName)
     return szFileName;
 }
 
+// Runs the jobs of one extraction step on extractThreads threads and
+// reports their progress. Jobs write files of their own, anything shared
+// is collected per job and written by the caller once all are done.
+class ExtractJobs : public ACE_Task_Base
+{
+    public:
+        ExtractJobs(const char* name, size_t count) : m_name(name), m_count(count), m_next(0), m_done(0) {}
+        virtual ~ExtractJobs() {}
+
+        void Run()
+        {
+            m_start = ACE_OS::gettimeofday();
+
+            if (extractThreads > 1 && m_count > 1)
+            {
+                activate(THR_NEW_LWP | THR_JOINABLE, extractThreads);
+                wait();
+            }
+            else
+                svc();
+
+            float seconds = (ACE_OS::gettimeofday() - m_start).msec() / 1000.0f;
+            printf("%s: %u done in %.1f s (%.1f/s)          \n", m_name, uint32(m_count), seconds,
+                seconds > 0.0f ? m_count / seconds : 0.0f);
+        }
+
+        int svc()
+        {
+            for (;;)
+            {
+                size_t index;
+                {
+                    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+                    if (m_next >= m_count)
+                        break;
+                    index = m_next++;
+                }
+
+                Process(index);
+
+                ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+                ++m_done;
+                float seconds = (ACE_OS::gettimeofday() - m_start).msec() / 1000.0f;
+                printf("%s: %u/%u (%.1f/s)\r", m_name, uint32(m_done), uint32(m_count),
+                    seconds > 0.0f ? m_done / seconds : 0.0f);
+                fflush(stdout);
+            }
+            return 0;
+        }
+
+    protected:
+        virtual void Process(size_t index) = 0;
+
+        ACE_Thread_Mutex m_lock;
+
+    private:
+        const char* m_name;
+        size_t m_count;
+        size_t m_next;
+        size_t m_done;
+        ACE_Time_Value m_start;
+};
+
+// model files extracted, or being extracted while false
+static std::map<std::string, bool> extractedModels;
+static ACE_Thread_Mutex extractedModelsLock;
+static ACE_Condition_Thread_Mutex extractedModelsCond(extractedModelsLock);
+
+bool ClaimExtraction(const char* localFile)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(extractedModelsLock);
+
+    std::pair<std::map<std::string, bool>::iterator, bool> result =
+        extractedModels.insert(std::pair<std::string, bool>(localFile, false));
+    if (!result.second)
+    {
+        while (!result.first->second)
+            extractedModelsCond.wait();
+        return false;
+    }
+
+    if (FILE* file = fopen(localFile, "rb"))
+    {
+        fclose(file);
+        result.first->second = true;
+        return false;
+    }
+
+    return true;
+}
+
+void FinishExtraction(const char* localFile)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(extractedModelsLock);
+
+    extractedModels[localFile] = true;
+    extractedModelsCond.broadcast();
+}
+
+class WmoJobs : public ExtractJobs
+{
+    public:
+        WmoJobs(std::vector<std::string> const& files) : ExtractJobs("Extract wmo", files.size()),
+            m_files(files), m_success(true) {}
+
+        bool Success() const { return m_success; }
+
+    protected:
+        void Process(size_t index)
+        {
+            std::string fname = m_files[index];
+
+            char szLocalFile[1024];
+            sprintf(szLocalFile, "%s/%s", szWorkDirWmo, GetPlainName(fname.c_str()));
+            fixnamen(szLocalFile,strlen(szLocalFile));
+
+            printf("Extracting %s\n", fname.c_str());
+            WMORoot * froot = new WMORoot(fname);
+            if (!froot->open())
+            {
+                printf("Couldn't open RootWmo!!!\n");
+                delete froot;
+                return;
+            }
+            FILE *output=fopen(szLocalFile,"wb");
+            if (!output)
+            {
+                printf("couldn't open %s for writing!\n", szLocalFile);
+                delete froot;
+                ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+                m_success = false;
+                return;
+            }
+            bool file_ok=true;
+            froot->ConvertToVMAPRootWmo(output);
+            int Wmo_nVertices = 0;
+            //printf("root has %d groups\n", froot->nGroups);
+            if (froot->nGroups !=0)
+            {
+                for (uint32 i=0; i<froot->nGroups; ++i)
+                {
+                    char temp[1024];
+                    strcpy(temp, fname.c_str());
+                    temp[fname.length()-4] = 0;
+                    char groupFileName[1024];
+                    sprintf(groupFileName,"%s_%03d.wmo",temp, i);
+                    //printf("Trying to open groupfile %s\n",groupFileName);
+                    string s = groupFileName;
+                    WMOGroup * fgroup = new WMOGroup(s);
+                    if (!fgroup->open())
+                    {
+                        printf("Could not open all Group file for: %s\n",GetPlainName(fname.c_str()));
+                        delete fgroup;
+                        file_ok=false;
+                        break;
+                    }
+
+                    Wmo_nVertices += fgroup->ConvertToVMAPGroupWmo(output, froot, preciseVectorData);
+                    delete fgroup;
+                }
+            }
+            fseek(output, 8, SEEK_SET); // store the correct no of vertices
+            fwrite(&Wmo_nVertices,sizeof(int),1,output);
+            fclose(output);
+            delete froot;
+
+            // Delete the extracted file in the case of an error
+            if (!file_ok)
+                remove(szLocalFile);
+        }
+
+    private:
+        std::vector<std::string> const& m_files;
+        bool m_success;
+};
+
 int ExtractWmo()
 {
     char   szLocalFile[1024] = "";
-    bool success=true;
 
     //const char* ParsArchiveNames[] = {"patch-2.MPQ", "patch.MPQ", "common.MPQ", "expansion.MPQ"};
 
-    for (ArchiveSet::const_iterator ar_itr = gOpenArchives.begin(); ar_itr != gOpenArchives.end() && success; ++ar_itr)
+    // the first archive listing a file name extracts it
+    std::vector<std::string> files;
+    std::set<std::string> localFiles;
+    for (ArchiveSet::const_iterator ar_itr = gOpenArchives.begin(); ar_itr != gOpenArchives.end(); ++ar_itr)
     {
         vector<string> filelist;
 
         (*ar_itr)->GetFileListTo(filelist);
-        for (vector<string>::iterator fname=filelist.begin(); fname != filelist.end() && success; ++fname)
+        for (vector<string>::iterator fname=filelist.begin(); fname != filelist.end(); ++fname)
         {
-            bool file_ok=true;
             if (fname->find(".wmo") != string::npos)
             {
                 // Copy files from archive
                 //std::cout << "found *.wmo file " << *fname << std::endl;
                 sprintf(szLocalFile, "%s/%s", szWorkDirWmo, GetPlainName(fname->c_str()));
                 fixnamen(szLocalFile,strlen(szLocalFile));
+                if (!localFiles.insert(szLocalFile).second)
+                    continue;
+
                 FILE * n;
                 if ((n = fopen(szLocalFile, "rb"))== NULL)
                 {
@@ -112,100 +300,90 @@ int ExtractWmo()
                         }
                     }
                     if (p != 3)
-                    {
-                        std::cout << "Extracting " << *fname << std::endl;
-                        WMORoot * froot = new WMORoot(*fname);
-                        if (!froot->open())
-                        {
-                            printf("Couldn't open RootWmo!!!\n");
-                            delete froot;
-                            continue;
-                        }
-                        FILE *output=fopen(szLocalFile,"wb");
-                        if (!output)
-                        {
-                            printf("couldn't open %s for writing!\n", szLocalFile);
-                            success=false;
-                        }
-                        froot->ConvertToVMAPRootWmo(output);
-                        int Wmo_nVertices = 0;
-                        //printf("root has %d groups\n", froot->nGroups);
-                        if (froot->nGroups !=0)
-                        {
-                            for (uint32 i=0; i<froot->nGroups; ++i)
-                            {
-                                char temp[1024];
-                                strcpy(temp, fname->c_str());
-                                temp[fname->length()-4] = 0;
-                                char groupFileName[1024];
-                                sprintf(groupFileName,"%s_%03d.wmo",temp, i);
-                                //printf("Trying to open groupfile %s\n",groupFileName);
-                                string s = groupFileName;
-                                WMOGroup * fgroup = new WMOGroup(s);
-                                if (!fgroup->open())
-                                {
-                                    printf("Could not open all Group file for: %s\n",GetPlainName(fname->c_str()));
-                                    file_ok=false;
-                                    break;
-                                }
-
-                                Wmo_nVertices += fgroup->ConvertToVMAPGroupWmo(output, froot, preciseVectorData);
-                                delete fgroup;
-                            }
-                        }
-                        fseek(output, 8, SEEK_SET); // store the correct no of vertices
-                        fwrite(&Wmo_nVertices,sizeof(int),1,output);
-                        fclose(output);
-                        delete froot;
-                    }
+                        files.push_back(*fname);
                 }
                 else
                 {
                     fclose(n);
                 }
             }
-            // Delete the extracted file in the case of an error
-            if (!file_ok)
-                remove(szLocalFile);
         }
     }
 
+    WmoJobs jobs(files);
+    jobs.Run();
+
+    bool success = jobs.Success();
     if (success)
         printf("\nExtract wmo complete (No (fatal) errors)\n");
 
     return success;
 }
 
+class AdtJobs : public ExtractJobs
+{
+    public:
+        AdtJobs(const char* name, WDTFile& wdt, uint32 mapId) : ExtractJobs(name, 64 * 64),
+            m_wdt(wdt), m_mapId(mapId), m_records(64 * 64) {}
+
+        void WriteRecords(FILE* dirfile)
+        {
+            for (size_t i = 0; i < m_records.size(); ++i)
+                m_records[i].flush(dirfile);
+        }
+
+    protected:
+        void Process(size_t index)
+        {
+            int x = int(index / 64);
+            int y = int(index % 64);
+            if (ADTFile *ADT = m_wdt.GetMap(x,y))
+            {
+                //sprintf(id_filename,"%02u %02u %03u",x,y,map_ids[i].id);//!!!!!!!!!
+                ADT->init(m_mapId, x, y, &m_records[index]);
+                delete ADT;
+            }
+        }
+
+    private:
+        WDTFile& m_wdt;
+        uint32 m_mapId;
+        std::vector<DirRecords> m_records;                  // per tile, written in this order
+};
+
 void ParsMapFiles()
 {
     char fn[512];
     //char id_filename[64];
     char id[10];
+    char name[64];
+
+    std::string dirname = std::string(szWorkDirWmo) + "/dir_bin";
+    FILE *dirfile = fopen(dirname.c_str(), "ab");
+    if (!dirfile)
+    {
+        printf("Can't open dirfile!'%s'\n", dirname.c_str());
+        return;
+    }
+
     for (unsigned int i=0; i<map_count; ++i)
     {
         sprintf(id,"%03u",map_ids[i].id);
         sprintf(fn,"World\\Maps\\%s\\%s.wdt", map_ids[i].name, map_ids[i].name);
         WDTFile WDT(fn,map_ids[i].name);
-        if (WDT.init(id, map_ids[i].id))
+        DirRecords records;
+        if (WDT.init(id, map_ids[i].id, &records))
         {
-            printf("Processing Map %u\n[", map_ids[i].id);
-            for (int x=0; x<64; ++x)
-            {
-                for (int y=0; y<64; ++y)
-                {
-                    if (ADTFile *ADT = WDT.GetMap(x,y))
-                    {
-                        //sprintf(id_filename,"%02u %02u %03u",x,y,map_ids[i].id);//!!!!!!!!!
-                        ADT->init(map_ids[i].id, x, y);
-                        delete ADT;
-                    }
-                }
-                printf("#");
-                fflush(stdout);
-            }
-            printf("]\n");
+            records.flush(dirfile);
+
+            sprintf(name, "Processing Map %u", map_ids[i].id);
+            AdtJobs jobs(name, WDT, map_ids[i].id);
+            jobs.Run();
+            jobs.WriteRecords(dirfile);
         }
     }
+
+    fclose(dirfile);
 }
 
 void getGamePath()
@@ -360,6 +538,18 @@ bool processArgv(int argc, char ** argv, const char *versionString)
         {
             preciseVectorData = true;
         }
+        else if (strcmp("-t",argv[i]) == 0)
+        {
+            if ((i+1)<argc && atoi(argv[i+1]) > 0)
+            {
+                extractThreads = atoi(argv[i+1]);
+                ++i;
+            }
+            else
+            {
+                result = false;
+            }
+        }
         else
         {
             result = false;
@@ -369,10 +559,11 @@ bool processArgv(int argc, char ** argv, const char *versionString)
     if (!result)
     {
         printf("Extract %s.\n",versionString);
-        printf("%s [-?][-s][-l][-d <path>]\n", argv[0]);
+        printf("%s [-?][-s][-l][-d <path>][-t <threads>]\n", argv[0]);
         printf("   -s : (default) small size (data size optimization), ~500MB less vmap data.\n");
         printf("   -l : large size, ~500MB more vmap data. (might contain more details)\n");
         printf("   -d <path>: Path to the vector data source folder.\n");
+        printf("   -t <threads>: Number of threads extracting files, 1 by default.\n");
         printf("   -? : This message.\n");
     }
     return result;
@@ -6,6 +6,9 @@
 #ifndef VMAPEXPORT_H
 #define VMAPEXPORT_H
 
+#include <cstdio>
+#include <vector>
+
 enum ModelFlags
 {
     MOD_M2 = 1,
@@ -16,4 +19,30 @@ enum ModelFlags
 extern const char * szWorkDirWmo;
 extern const char * szRawVMAPMagic;                         // vmap magic string for extracted raw vmap data
 
+// Spawn records of one WDT or ADT, kept until dir_bin is written in map order
+class DirRecords
+{
+    public:
+        void write(const void* data, size_t size, size_t count)
+        {
+            const char* bytes = (const char*)data;
+            m_data.insert(m_data.end(), bytes, bytes + size * count);
+        }
+
+        void flush(FILE* file)
+        {
+            if (!m_data.empty())
+                fwrite(&m_data[0], 1, m_data.size(), file);
+            m_data.clear();
+        }
+
+    private:
+        std::vector<char> m_data;
+};
+
+// Claims a model file for extraction; false once it is extracted, waiting
+// while another thread extracts it. The claimer calls FinishExtraction.
+bool ClaimExtraction(const char* localFile);
+void FinishExtraction(const char* localFile);
+
 #endif
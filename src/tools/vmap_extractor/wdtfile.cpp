@@ -22,7 +22,7 @@ WDTFile::WDTFile(char* file_name, char* file_name1):WDT(file_name)
     filename.append(file_name1,strlen(file_name1));
 }
 
-bool WDTFile::init(char *map_id, unsigned int mapID)
+bool WDTFile::init(char *map_id, unsigned int mapID, DirRecords* dirfile)
 {
     if (WDT.isEof())
     {
@@ -33,15 +33,6 @@ bool WDTFile::init(char *map_id, unsigned int mapID)
     char fourcc[5];
     uint32 size;
 
-    std::string dirname = std::string(szWorkDirWmo) + "/dir_bin";
-    FILE *dirfile;
-    dirfile = fopen(dirname.c_str(), "ab");
-    if (!dirfile)
-    {
-        printf("Can't open dirfile!'%s'\n", dirname.c_str());
-        return false;
-    }
-
     while (!WDT.isEof())
     {
         WDT.read(fourcc,4);
@@ -100,7 +91,6 @@ bool WDTFile::init(char *map_id, unsigned int mapID)
     }
 
     WDT.close();
-    fclose(dirfile);
     return true;
 }
 
@@ -18,7 +18,7 @@ class WDTFile
 public:
     WDTFile(char* file_name, char* file_name1);
     ~WDTFile(void);
-    bool init(char *map_id, unsigned int mapID);
+    bool init(char *map_id, unsigned int mapID, DirRecords* dirfile);
 
     string* gWmoInstansName;
     int gnWMO, nMaps;
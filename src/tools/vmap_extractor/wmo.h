@@ -25,6 +25,7 @@
 class WMOInstance;
 class WMOManager;
 class MPQFile;
+class DirRecords;
 
 /* for whatever reason a certain company just can't stick to one coordinate system... */
 static inline Vec3D fixCoords(const Vec3D &v){ return Vec3D(v.z, v.x, v.y); }
@@ -116,7 +117,7 @@ public:
     uint32 indx,id, d2, d3;
     int doodadset;
 
-    WMOInstance(MPQFile &f,const char* WmoInstName, uint32 mapID, uint32 tileX, uint32 tileY, FILE *pDirfile);
+    WMOInstance(MPQFile &f,const char* WmoInstName, uint32 mapID, uint32 tileX, uint32 tileY, DirRecords* pDirfile);
 
     static void reset();
 };
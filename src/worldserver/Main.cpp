@@ -48,6 +48,8 @@ DatabaseType WorldDatabase;                                 ///< Accessor to the
 DatabaseType CharacterDatabase;                             ///< Accessor to the character database
 DatabaseType LoginDatabase;                                 ///< Accessor to the auth/login database
 
+SqlWriteBehind CharacterDatabaseWriter(CharacterDatabase);  ///< Coalescing writer in front of the character database
+
 uint32 realmID;                                             ///< Id of the realm
 
 // Print out the usage string for this program on the console.
@@ -367,6 +367,14 @@ bool Master::_StartDB()
         return false;
     }
 
+    // Extra connections loading characters at login
+    if (!CharacterDatabase.InitHolderConnections(dbstring.c_str(), sConfig.GetIntDefault("CharacterDatabase.LoginConnections", 2)))
+    {
+        sLog.outError("Cannot open login connections to Character database %s",dbstring.c_str());
+        sleep(5);
+        return false;
+    }
+
     // Get login database info from configuration file
     dbstring = sConfig.GetStringDefault("LoginDatabaseInfo", "");
     if (dbstring.empty())
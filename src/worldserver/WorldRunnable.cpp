@@ -13,6 +13,7 @@
 #include "BattleGroundMgr.h"
 
 #include "Database/DatabaseEnv.h"
+#include "TickProfiler.h"
 
 #define WORLD_SLEEP_CONST 50
 
@@ -36,7 +37,9 @@ void WorldRunnable::run()
 
         uint32 diff = getMSTimeDiff(realPrevTime,realCurrTime);
 
+        sTickProfiler.BeginTick();
         sWorld.Update(diff);
+        sTickProfiler.EndTick();
         realPrevTime = realCurrTime;
 
         // diff (D0) include time of previous sleep (d0) + tick time (t0)
@@ -62,6 +65,8 @@ void WorldRunnable::run()
 
     MapManager::Instance().UnloadAll();                     // unload all grids (including locked in memory)
 
+    CharacterDatabaseWriter.FlushAndWait();                 // write out buffered guild/arena team changes
+
     // End the database thread
     WorldDatabase.ThreadEnd();                                  // free mySQL thread resources
 }